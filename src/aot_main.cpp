@@ -0,0 +1,475 @@
+// chip8-aot: compiles a CHIP-8 ROM ahead of time into C++ for
+// Chip8::attachCompiledRom(). Control flow is followed from the ROM start
+// address; every reachable basic block becomes straight-line code in one
+// function, chained with gotos. Indirect jumps (BNNN) and returns go through
+// a switch over the compiled block addresses, and anything not compiled falls
+// back to the interpreter at run time.
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "chip8.h"
+
+namespace {
+
+enum class Kind {
+    Inline,       // Register or index operation emitted in place
+    TimerRead,    // FX07: the pending timer ticks must be applied first
+    TimerWrite,   // FX15/FX18
+    Handler,      // Calls the interpreter's handler and continues
+    MemoryWrite,  // FX33/FX55: like Handler, then checks the block is unmodified
+    KeyWait,      // FX0A
+    Jump,         // 1NNN
+    Call,         // 2NNN
+    Skip,         // 3XNN, 4XNN, 5XY0, 9XY0, EX9E, EXA1
+    Return,       // 00EE
+    Indirect,     // BNNN
+    Interpret,    // SUPER-CHIP operations: handed back to the interpreter
+    Unknown
+};
+
+struct Instruction {
+    std::uint16_t address;
+    std::uint16_t opcode;
+    Kind kind;
+};
+
+std::string hex(std::uint32_t value, int digits) {
+    std::ostringstream out;
+    out << "0x" << std::hex << std::uppercase;
+    out.width(digits);
+    out.fill('0');
+    out << value;
+    return out.str();
+}
+
+std::string label(std::uint16_t address) { return "L_" + hex(address, 3).substr(2); }
+
+// Mirrors Chip8::decode(), including its loose matching of the low nibble
+Kind classify(std::uint16_t opcode) {
+    const std::uint8_t n = opcode & 0x000F;
+    const std::uint8_t nn = opcode & 0x00FF;
+    switch (opcode & 0xF000) {
+        case 0x0000:
+            if ((opcode & 0xFFF0) == 0x00C0 || (opcode >= 0x00FB && opcode <= 0x00FF)) {
+                return Kind::Interpret;
+            }
+            if (n == 0x0) {
+                return Kind::Handler;
+            }
+            return n == 0xE ? Kind::Return : Kind::Unknown;
+        case 0x1000:
+            return Kind::Jump;
+        case 0x2000:
+            return Kind::Call;
+        case 0x3000:
+        case 0x4000:
+        case 0x5000:
+        case 0x9000:
+            return Kind::Skip;
+        case 0x6000:
+        case 0x7000:
+        case 0xA000:
+            return Kind::Inline;
+        case 0x8000:
+            return n <= 0x7 || n == 0xE ? Kind::Inline : Kind::Unknown;
+        case 0xB000:
+            return Kind::Indirect;
+        case 0xC000:
+        case 0xD000:
+            return Kind::Handler;
+        case 0xE000:
+            return n == 0xE || n == 0x1 ? Kind::Skip : Kind::Unknown;
+        case 0xF000:
+            switch (nn) {
+                case 0x07:
+                    return Kind::TimerRead;
+                case 0x0A:
+                    return Kind::KeyWait;
+                case 0x15:
+                case 0x18:
+                    return Kind::TimerWrite;
+                case 0x1E:
+                    return Kind::Inline;
+                case 0x29:
+                case 0x65:
+                    return Kind::Handler;
+                case 0x33:
+                case 0x55:
+                    return Kind::MemoryWrite;
+                case 0x30:
+                case 0x75:
+                case 0x85:
+                    return Kind::Interpret;
+                default:
+                    return Kind::Unknown;
+            }
+    }
+    return Kind::Unknown;
+}
+
+class Compiler {
+  public:
+    Compiler(std::vector<std::uint8_t> image, std::string symbol, std::string source)
+        : image_(std::move(image)), symbol_(std::move(symbol)), source_(std::move(source)) {}
+
+    std::string compile() {
+        discover();
+
+        std::ostringstream body;
+        std::vector<std::pair<std::uint16_t, std::uint16_t>> ranges;
+        for (std::uint16_t leader : leaders_) {
+            ranges.push_back(emitBlock(body, leader));
+        }
+
+        std::ostringstream out;
+        out << "// Generated by chip8-aot from " << source_ << " (" << image_.size()
+            << " bytes, " << leaders_.size() << " blocks). Do not edit.\n\n"
+            << "#include <cstdint>\n\n#include \"chip8_aot.h\"\n\nnamespace {\n\n"
+            << "using A = Chip8Aot;\n\n";
+
+        out << "const std::uint8_t IMAGE[] = {";
+        for (std::size_t i = 0; i < image_.size(); ++i) {
+            out << (i % 12 == 0 ? "\n    " : " ") << hex(image_[i], 2) << ",";
+        }
+        out << "\n};\n\n";
+
+        out << "// Start and end address of each compiled block\n"
+            << "const std::uint16_t BLOCKS[] = {";
+        for (std::size_t i = 0; i < ranges.size(); ++i) {
+            out << (i % 4 == 0 ? "\n    " : " ") << hex(ranges[i].first, 3) << ", "
+                << hex(ranges[i].second, 3) << ",";
+        }
+        out << "\n};\n\n";
+
+        out << "std::uint32_t run(Chip8& m, std::uint32_t budget) {\n"
+            << "    std::uint8_t* const v = A::registers(m);\n"
+            << "    std::uint32_t executed = 0;\n"
+            << "    static_cast<void>(v);\n\n";
+        if (redispatches_) {
+            out << "dispatch:\n";
+        }
+        out << "    switch (A::programCounter(m)) {\n";
+        for (std::uint16_t leader : leaders_) {
+            out << "        case " << hex(leader, 3) << ":\n"
+                << "            goto " << label(leader) << ";\n";
+        }
+        out << "        default:\n"
+            << "            return executed;  // Not compiled: interpret\n"
+            << "    }\n"
+            << body.str() << "}\n\n}  // namespace\n\n"
+            << "extern const Chip8::CompiledRom " << symbol_ << " = {\n"
+            << "    IMAGE, sizeof(IMAGE), BLOCKS, sizeof(BLOCKS) / sizeof(BLOCKS[0]) / 2, run};\n";
+        return out.str();
+    }
+
+  private:
+    std::vector<std::uint8_t> image_;
+    std::string symbol_;
+    std::string source_;
+    std::set<std::uint16_t> leaders_;
+    bool redispatches_ = false;  // Some block jumps back to the dispatch switch
+
+    // The whole instruction lies inside the ROM image
+    bool contains(std::uint32_t address) const {
+        return address >= Chip8::ROM_START_ADDRESS &&
+               address + 1 < Chip8::ROM_START_ADDRESS + image_.size();
+    }
+
+    Instruction fetch(std::uint16_t address) const {
+        const std::size_t offset = address - Chip8::ROM_START_ADDRESS;
+        const auto opcode = static_cast<std::uint16_t>((image_[offset] << 8) | image_[offset + 1]);
+        return Instruction{address, opcode, classify(opcode)};
+    }
+
+    void addTarget(std::uint32_t address, std::vector<std::uint16_t>& work) {
+        if (contains(address)) {
+            leaders_.insert(static_cast<std::uint16_t>(address));
+            work.push_back(static_cast<std::uint16_t>(address));
+        }
+    }
+
+    void discover() {
+        std::set<std::uint16_t> visited;
+        std::vector<std::uint16_t> work;
+        addTarget(Chip8::ROM_START_ADDRESS, work);
+
+        while (!work.empty()) {
+            const std::uint16_t address = work.back();
+            work.pop_back();
+            if (!contains(address) || !visited.insert(address).second) {
+                continue;
+            }
+
+            const Instruction instr = fetch(address);
+            switch (instr.kind) {
+                case Kind::Jump:
+                    addTarget(instr.opcode & 0x0FFF, work);
+                    break;
+                case Kind::Call:
+                    addTarget(instr.opcode & 0x0FFF, work);
+                    addTarget(address + 2u, work);
+                    break;
+                case Kind::Skip:
+                    addTarget(address + 2u, work);
+                    addTarget(address + 4u, work);
+                    break;
+                case Kind::Interpret:
+                    addTarget(address + 2u, work);
+                    break;
+                case Kind::Return:
+                case Kind::Indirect:
+                case Kind::Unknown:
+                    break;
+                default:
+                    work.push_back(static_cast<std::uint16_t>(address + 2));
+                    break;
+            }
+        }
+    }
+
+    static bool endsBlock(Kind kind) {
+        return kind == Kind::Jump || kind == Kind::Call || kind == Kind::Skip ||
+               kind == Kind::Return || kind == Kind::Indirect || kind == Kind::Interpret ||
+               kind == Kind::Unknown;
+    }
+
+    // Jumps to a compiled block, or hands the address back to the interpreter
+    std::string transfer(std::uint32_t address) const {
+        if (contains(address) && leaders_.count(static_cast<std::uint16_t>(address)) != 0) {
+            return "goto " + label(static_cast<std::uint16_t>(address)) + ";";
+        }
+        return "return A::leave(m, executed, " + hex(address, 3) + ");";
+    }
+
+    std::pair<std::uint16_t, std::uint16_t> emitBlock(std::ostream& out, std::uint16_t leader) {
+        std::vector<Instruction> code;
+        std::uint32_t address = leader;
+        while (true) {
+            code.push_back(fetch(static_cast<std::uint16_t>(address)));
+            address += 2;
+            if (endsBlock(code.back().kind) || !contains(address) ||
+                leaders_.count(static_cast<std::uint16_t>(address)) != 0) {
+                break;
+            }
+        }
+
+        out << "\n" << label(leader) << ":\n"
+            << "    if (!A::enter(m, executed, budget, " << hex(leader, 3) << ", " << code.size()
+            << ")) return executed;\n";
+
+        // Instructions retired since the timers and cycle count were last updated
+        std::uint32_t pending = 0;
+        std::uint16_t lastOpcode = 0;
+        const auto flush = [&]() {
+            if (pending > 0) {
+                out << "    A::retire(m, executed, " << pending << ", " << hex(lastOpcode, 4)
+                    << ");\n";
+                pending = 0;
+            }
+        };
+
+        for (const Instruction& instr : code) {
+            const std::uint16_t op = instr.opcode;
+            const std::string x = hex((op >> 8) & 0xF, 1);
+            const std::string y = hex((op >> 4) & 0xF, 1);
+            const std::string nn = hex(op & 0xFF, 2);
+            const std::string nnn = hex(op & 0xFFF, 3);
+            const std::string at = hex(instr.address, 3);
+            const std::string args = "(m, executed, " + at + ", " + hex(op, 4) + ")";
+            out << "    // " << at << ": " << hex(op, 4).substr(2) << "\n";
+
+            switch (instr.kind) {
+                case Kind::Inline:
+                    emitInline(out, op, x, y, nn, nnn);
+                    break;
+                case Kind::TimerRead:
+                case Kind::TimerWrite:
+                    flush();
+                    out << "    A::opFX" << hex(op & 0xFF, 2).substr(2) << "(m, " << x << ");\n";
+                    break;
+                case Kind::Handler:
+                case Kind::MemoryWrite:
+                    flush();
+                    out << "    if (!A::op" << handlerName(op) << args << ") return executed;\n";
+                    if (instr.kind == Kind::MemoryWrite) {
+                        out << "    if (!A::valid(m, " << hex(leader, 3)
+                            << ")) return A::leave(m, executed, " << hex(instr.address + 2, 3)
+                            << ");\n";
+                    }
+                    continue;
+                case Kind::KeyWait:
+                    flush();
+                    out << "    if (!A::opFX0A(m, executed, budget, " << at << ", " << hex(op, 4)
+                        << ")) return executed;\n";
+                    continue;
+                case Kind::Jump:
+                    if ((op & 0x0FFF) == instr.address) {
+                        flush();
+                        out << "    return A::spin(m, executed, budget, " << at << ", "
+                            << hex(op, 4) << ");\n";
+                        continue;
+                    }
+                    ++pending;
+                    lastOpcode = op;
+                    flush();
+                    out << "    " << transfer(op & 0x0FFF) << "\n";
+                    continue;
+                case Kind::Call:
+                    flush();
+                    out << "    if (!A::op2NNN" << args << ") return executed;\n"
+                        << "    " << transfer(op & 0x0FFF) << "\n";
+                    continue;
+                case Kind::Skip:
+                    ++pending;
+                    lastOpcode = op;
+                    flush();
+                    out << "    if (" << skipCondition(op, x, y, nn) << ") "
+                        << transfer(instr.address + 4u) << "\n"
+                        << "    " << transfer(instr.address + 2u) << "\n";
+                    continue;
+                case Kind::Return:
+                case Kind::Indirect:
+                    flush();
+                    out << "    if (!A::op" << (instr.kind == Kind::Return ? "00EE" : "BNNN")
+                        << args << ") return executed;\n"
+                        << "    goto dispatch;\n";
+                    redispatches_ = true;
+                    continue;
+                case Kind::Interpret:
+                    flush();
+                    out << "    return A::leave(m, executed, " << at << ");\n";
+                    continue;
+                case Kind::Unknown:
+                    flush();
+                    out << "    A::opUnknown" << args << ";\n"
+                        << "    return executed;\n";
+                    continue;
+            }
+            ++pending;
+            lastOpcode = op;
+        }
+
+        // Fell through into the next block or off the end of the image
+        if (!endsBlock(code.back().kind)) {
+            flush();
+            out << "    " << transfer(address) << "\n";
+        }
+        return {leader, static_cast<std::uint16_t>(address)};
+    }
+
+    static void emitInline(std::ostream& out, std::uint16_t op, const std::string& x,
+                           const std::string& y, const std::string& nn, const std::string& nnn) {
+        switch (op & 0xF000) {
+            case 0x6000:
+                out << "    A::op6XNN(v, " << x << ", " << nn << ");\n";
+                return;
+            case 0x7000:
+                out << "    A::op7XNN(v, " << x << ", " << nn << ");\n";
+                return;
+            case 0xA000:
+                out << "    A::opANNN(m, " << nnn << ");\n";
+                return;
+            case 0xF000:
+                out << "    A::opFX1E(m, " << x << ");\n";
+                return;
+            default:
+                break;
+        }
+        const std::uint8_t n = op & 0xF;
+        if (n == 0x6 || n == 0xE) {
+            out << "    A::op8XY" << (n == 0x6 ? "6" : "E") << "(v, " << x << ");\n";
+        } else {
+            out << "    A::op8XY" << static_cast<int>(n) << "(v, " << x << ", " << y << ");\n";
+        }
+    }
+
+    static std::string handlerName(std::uint16_t op) {
+        switch (op & 0xF000) {
+            case 0x0000:
+                return "00E0";
+            case 0xC000:
+                return "CXNN";
+            case 0xD000:
+                return "DXYN";
+            default:
+                return "FX" + hex(op & 0xFF, 2).substr(2);
+        }
+    }
+
+    static std::string skipCondition(std::uint16_t op, const std::string& x, const std::string& y,
+                                     const std::string& nn) {
+        switch (op & 0xF000) {
+            case 0x3000:
+                return "v[" + x + "] == " + nn;
+            case 0x4000:
+                return "v[" + x + "] != " + nn;
+            case 0x5000:
+                return "v[" + x + "] == v[" + y + "]";
+            case 0x9000:
+                return "v[" + x + "] != v[" + y + "]";
+            default:
+                return (op & 0xF) == 0xE ? "A::keyDown(m, " + x + ")" : "!A::keyDown(m, " + x + ")";
+        }
+    }
+};
+
+std::string symbolFor(const std::string& path) {
+    std::string stem = path.substr(path.find_last_of("/\\") + 1);
+    stem = stem.substr(0, stem.find('.'));
+    std::string symbol;
+    for (char c : stem) {
+        symbol += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    if (symbol.empty() || std::isdigit(static_cast<unsigned char>(symbol.front()))) {
+        symbol = "rom_" + symbol;
+    }
+    return symbol + "_compiled";
+}
+
+void printUsage(const char* programName) {
+    std::cerr << "Usage: " << programName << " <rom_file> <output.cpp> [symbol]" << std::endl;
+    std::cerr << "Example: " << programName << " roms/maze.ch8 maze_aot.cpp maze_compiled"
+              << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3 && argc != 4) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open ROM: " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::vector<std::uint8_t> image((std::istreambuf_iterator<char>(file)),
+                                    std::istreambuf_iterator<char>());
+    if (image.empty() || image.size() > Chip8::MEMORY_SIZE - Chip8::ROM_START_ADDRESS) {
+        std::cerr << "ROM size invalid or too large: " << image.size() << " bytes" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string symbol = argc == 4 ? argv[3] : symbolFor(argv[1]);
+    Compiler compiler(std::move(image), symbol, argv[1]);
+
+    std::ofstream output(argv[2]);
+    output << compiler.compile();
+    if (!output) {
+        std::cerr << "Failed to write " << argv[2] << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,187 @@
+#include "batch_runner.h"
+
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <variant>
+
+namespace {
+
+// A worker's share of the batch. The owner pops from the back and thieves
+// take from the front, so they only meet over the last job.
+class JobQueue {
+  public:
+    void push(std::size_t job) { jobs_.push_back(job); }
+
+    bool pop(std::size_t& job) {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        if (jobs_.empty()) {
+            return false;
+        }
+        job = jobs_.back();
+        jobs_.pop_back();
+        return true;
+    }
+
+    bool steal(std::size_t& job) {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        if (jobs_.empty()) {
+            return false;
+        }
+        job = jobs_.front();
+        jobs_.pop_front();
+        return true;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::deque<std::size_t> jobs_;
+};
+
+constexpr std::uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325;
+constexpr std::uint64_t FNV_PRIME = 0x100000001B3;
+
+void hashBytes(std::uint64_t& hash, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        hash = (hash ^ (value >> (8 * i) & 0xFF)) * FNV_PRIME;
+    }
+}
+
+template <typename Emulator>
+std::uint64_t hashState(const Emulator& emulator) {
+    std::uint64_t hash = FNV_OFFSET_BASIS;
+    for (std::uint8_t plane = 0; plane < Chip8Base::PLANE_COUNT; ++plane) {
+        for (std::uint64_t word : emulator.getDisplayPlane(plane)) {
+            hashBytes(hash, word, 8);
+        }
+    }
+    for (std::uint8_t reg = 0; reg < Chip8Base::REGISTER_COUNT; ++reg) {
+        hashBytes(hash, emulator.getRegisterAt(reg), 1);
+    }
+    hashBytes(hash, emulator.getIndexRegister(), 2);
+    hashBytes(hash, emulator.getProgramCounter(), 2);
+    return hash;
+}
+
+template <typename Emulator>
+BatchResult runOn(Emulator& emulator, const BatchJob& job,
+                  const std::function<bool()>& cancelled) {
+    BatchResult result;
+    if (!job.rom || !emulator.loadRom(*job.rom)) {
+        result.status = BatchStatus::Failed;
+        result.error = emulator.getLastErrorRecord();
+        return result;
+    }
+    emulator.setRandomSeed(job.seed);
+
+    std::size_t nextEvent = 0;
+    while (result.cycles < job.cycles) {
+        if (cancelled && cancelled()) {
+            result.status = BatchStatus::Cancelled;
+            break;
+        }
+        const std::uint64_t target =
+            std::min(job.cycles, result.cycles + BatchRunner::SLICE_CYCLES);
+        const Chip8Base::StopReason reason =
+            runWithInput(emulator, job.input, nextEvent, result.cycles, target);
+        if (reason == Chip8Base::StopReason::Error) {
+            result.status = BatchStatus::Failed;
+            result.error = emulator.getLastErrorRecord();
+            break;
+        }
+        // Stuck, as in a key wait that no remaining event ends
+        if (reason != Chip8Base::StopReason::CycleLimit) {
+            result.status = BatchStatus::Stalled;
+            break;
+        }
+    }
+    if (result.cycles >= job.cycles) {
+        result.status = BatchStatus::Completed;
+    }
+    result.stateHash = hashState(emulator);
+    return result;
+}
+
+}  // namespace
+
+BatchResult runBatchJob(const BatchJob& job, const std::function<bool()>& cancelled) {
+    // Results carry the error records, so the emulators don't log
+    static NullLogger logger;
+    const auto emulator = makeChip8(job.profile, job.backend, logger);
+    return std::visit([&](auto& chip8) { return runOn(chip8, job, cancelled); }, *emulator);
+}
+
+BatchRunner::BatchRunner(std::size_t threadCount)
+    : threadCount_(threadCount != 0
+                       ? threadCount
+                       : std::max<std::size_t>(std::thread::hardware_concurrency(), 1)) {}
+
+std::vector<BatchResult> BatchRunner::run(const std::vector<BatchJob>& jobs,
+                                          const ResultCallback& onResult) {
+    const std::lock_guard<std::mutex> runLock(runMutex_);
+    {
+        const std::lock_guard<std::mutex> lock(cancelMutex_);
+        cancelled_ = std::make_unique<std::atomic<bool>[]>(jobs.size());
+        jobCount_ = jobs.size();
+        cancelAll_.store(false, std::memory_order_relaxed);
+    }
+
+    // Contiguous shares: neighbouring jobs often share a ROM, which then
+    // stays in one worker's cache
+    const std::size_t workers = std::min(threadCount_, std::max<std::size_t>(jobs.size(), 1));
+    std::vector<JobQueue> queues(workers);
+    for (std::size_t job = 0; job < jobs.size(); ++job) {
+        queues[job * workers / jobs.size()].push(job);
+    }
+
+    std::vector<BatchResult> results(jobs.size());
+    const auto work = [&](std::size_t self) {
+        std::size_t job = 0;
+        for (;;) {
+            bool found = queues[self].pop(job);
+            for (std::size_t i = 1; !found && i < workers; ++i) {
+                found = queues[(self + i) % workers].steal(job);
+            }
+            if (!found) {
+                return;
+            }
+
+            BatchResult& result = results[job];
+            if (!isCancelled(job)) {
+                result = runBatchJob(jobs[job], [&] { return isCancelled(job); });
+            }
+            if (onResult) {
+                onResult(job, result);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (std::size_t self = 1; self < workers; ++self) {
+        threads.emplace_back(work, self);
+    }
+    work(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    const std::lock_guard<std::mutex> lock(cancelMutex_);
+    cancelled_.reset();
+    jobCount_ = 0;
+    return results;
+}
+
+void BatchRunner::cancel(std::size_t job) {
+    const std::lock_guard<std::mutex> lock(cancelMutex_);
+    if (cancelled_ && job < jobCount_) {
+        cancelled_[job].store(true, std::memory_order_relaxed);
+    }
+}
+
+void BatchRunner::cancelAll() { cancelAll_.store(true, std::memory_order_relaxed); }
+
+bool BatchRunner::isCancelled(std::size_t job) const {
+    return cancelAll_.load(std::memory_order_relaxed) ||
+           cancelled_[job].load(std::memory_order_relaxed);
+}
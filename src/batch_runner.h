@@ -0,0 +1,90 @@
+#ifndef CHIP8_BATCH_RUNNER_H
+#define CHIP8_BATCH_RUNNER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "chip8.h"
+#include "chip8_factory.h"
+#include "input_recording.h"
+
+// One emulator run: a ROM, the profile to run it with, the keys to press, a
+// random seed and a cycle budget. The same job always gives the same result.
+// The ROM is shared, so thousands of jobs can point at one image without
+// copying it.
+struct BatchJob {
+    std::shared_ptr<const std::vector<std::uint8_t>> rom;
+    QuirkProfile profile = QuirkProfile::Default;
+    Chip8Base::Backend backend = Chip8Base::Backend::Threaded;
+    std::vector<KeyEvent> input;  // Sorted by cycle
+    std::uint64_t seed = 0;       // For CXNN
+    std::uint64_t cycles = 0;
+};
+
+enum class BatchStatus : std::uint8_t {
+    Completed,  // The whole budget ran
+    Failed,     // The ROM did not load or an instruction failed; see error
+    Stalled,    // Stuck before the end of the budget, as in a key wait no event ends
+    Cancelled   // Stopped by cancel() or cancelAll(), possibly before it started
+};
+
+struct BatchResult {
+    BatchStatus status = BatchStatus::Cancelled;
+    std::uint64_t cycles = 0;  // Instructions executed
+    Chip8Base::ErrorRecord error{};
+    // FNV-1a over the final display planes and registers, for comparing runs
+    std::uint64_t stateHash = 0;
+};
+
+// Runs batches of independent jobs on a work-stealing pool, one emulator per
+// job. Each worker starts on its own contiguous share of the batch, taking
+// jobs from the back of its queue; once that is empty it steals from the
+// front of the others', so a share full of long jobs gets spread out.
+//
+// cancel() and cancelAll() may be called from any thread, including from
+// the result callback. Running jobs notice within SLICE_CYCLES cycles.
+class BatchRunner {
+  public:
+    // Running jobs check for cancellation at least this often
+    static constexpr std::uint32_t SLICE_CYCLES = 100000;
+
+    using ResultCallback = std::function<void(std::size_t job, const BatchResult& result)>;
+
+    // threadCount 0 uses every hardware thread
+    explicit BatchRunner(std::size_t threadCount = 0);
+
+    BatchRunner(const BatchRunner&) = delete;
+    BatchRunner& operator=(const BatchRunner&) = delete;
+
+    // Blocks until every job has finished or been cancelled and returns the
+    // results in job order. onResult, if set, runs on the worker thread as
+    // each job finishes. One batch runs at a time.
+    std::vector<BatchResult> run(const std::vector<BatchJob>& jobs,
+                                 const ResultCallback& onResult = {});
+
+    // Affect the batch in progress; without one they do nothing
+    void cancel(std::size_t job);
+    void cancelAll();
+
+    std::size_t getThreadCount() const { return threadCount_; }
+
+  private:
+    bool isCancelled(std::size_t job) const;
+
+    std::size_t threadCount_;
+    std::mutex runMutex_;     // Held for the whole of run()
+    std::mutex cancelMutex_;  // Guards swapping cancelled_ in and out
+    std::unique_ptr<std::atomic<bool>[]> cancelled_;
+    std::size_t jobCount_ = 0;
+    std::atomic<bool> cancelAll_{false};
+};
+
+// Runs one job on the calling thread. cancelled is polled between slices.
+BatchResult runBatchJob(const BatchJob& job, const std::function<bool()>& cancelled = {});
+
+#endif
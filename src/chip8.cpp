@@ -1,24 +1,119 @@
 #include "chip8.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
-#include <fstream>
+#include <cstring>
 #include <iomanip>
 #include <ios>
-#include <iostream>
+#include <limits>
+#include <memory>
 #include <sstream>
 #include <vector>
 
-#include "random.h"
+#include "mapped_file.h"
+#include "state_io.h"
+
+// Computed goto ("labels as values") is a GCC/Clang extension
+#if defined(__GNUC__) || defined(__clang__)
+#define CHIP8_HAS_COMPUTED_GOTO 1
+#else
+#define CHIP8_HAS_COMPUTED_GOTO 0
+#endif
+
+// Guaranteed tail calls keep the tail-call backend from growing the stack
+#if defined(__has_cpp_attribute)
+#if __has_cpp_attribute(clang::musttail)
+#define CHIP8_HAS_MUSTTAIL 1
+#define CHIP8_MUSTTAIL [[clang::musttail]]
+#endif
+#endif
+#ifndef CHIP8_HAS_MUSTTAIL
+#define CHIP8_HAS_MUSTTAIL 0
+#define CHIP8_MUSTTAIL
+#endif
+
+namespace {
 
 // Helper function to format hex addresses
-std::string formatHex(std::uint16_t value) {
+std::string formatHex(std::uint32_t value) {
     std::stringstream ss;
     ss << "0x" << std::hex << std::uppercase << value;
     return ss.str();
 }
 
-constexpr std::array<std::uint8_t, Chip8::FONT_SET_SIZE> FONT_SET = {
+// Builds the message for an error record; only runs when a caller asks for it
+std::string formatErrorMessage(const Chip8Base::ErrorRecord& error, const std::string& romPath) {
+    using Site = Chip8Base::ErrorSite;
+    const std::uint32_t first = error.operands[0];
+    const std::uint32_t second = error.operands[1];
+
+    switch (error.site) {
+        case Site::None:
+            return std::string();
+        case Site::RomOpen:
+            return "Failed to open ROM: " + romPath;
+        case Site::RomSize:
+            return "ROM size invalid or too large: " + std::to_string(first) + " bytes";
+        case Site::RomRead:
+            return "Failed to read ROM: " + romPath;
+        case Site::CompiledRomMismatch:
+            return "Compiled ROM does not match memory";
+        case Site::ProgramCounterBounds:
+            return "Program counter out of bounds: " + std::to_string(first);
+        case Site::BreakpointAddress:
+            return "Invalid breakpoint address: " + formatHex(first);
+        case Site::PixelCoordinates:
+            return "Pixel coordinates out of bounds: (" + std::to_string(first) + ", " +
+                   std::to_string(second) + ")";
+        case Site::KeyIndex:
+            return "Invalid key index: " + std::to_string(first);
+        case Site::MemoryAddress:
+            return "Invalid memory address: " + formatHex(first);
+        case Site::ProgramCounterAddress:
+            return "Invalid program counter address: " + std::to_string(first);
+        case Site::StackIndex:
+            return "Stack index out of bounds: " + std::to_string(first);
+        case Site::StackPointer:
+            return "Stack pointer out of bounds: " + std::to_string(first);
+        case Site::RegisterIndex:
+            return "Invalid register index: " + std::to_string(first);
+        case Site::RegisterIndices:
+            return "Invalid register indices: " + std::to_string(first) + ", " +
+                   std::to_string(second);
+        case Site::Return:
+            return "Stack underflow on return";
+        case Site::JumpAddress:
+            return "Invalid jump address: " + std::to_string(first);
+        case Site::Call:
+            return "Stack overflow on subroutine call";
+        case Site::CallAddress:
+            return "Invalid call address: " + formatHex(first);
+        case Site::IndexRegisterAddress:
+            return "Invalid index register address: " + std::to_string(first);
+        case Site::ComputedJumpAddress:
+            return "Invalid computed jump address: " + std::to_string(first);
+        case Site::SpriteData:
+            return "Sprite data out of memory bounds: " + formatHex(first);
+        case Site::SpriteDigit:
+            return "Invalid sprite digit: " + std::to_string(first);
+        case Site::BcdStorage:
+            return "BCD storage out of memory bounds: " + formatHex(first);
+        case Site::RegisterDump:
+            return "Register dump out of memory bounds: " + formatHex(first);
+        case Site::RegisterLoad:
+            return "Register load out of memory bounds: " + formatHex(first);
+        case Site::AudioPattern:
+            return "Audio pattern out of memory bounds: " + formatHex(first);
+        case Site::UnknownOpcode:
+            return "Unknown opcode: " + formatHex(first);
+    }
+    return std::string();
+}
+
+}  // namespace
+
+constexpr std::array<std::uint8_t, Chip8Base::FONT_SET_SIZE> FONT_SET = {
     0xF0, 0x90, 0x90, 0x90, 0xF0,  // 0
     0x20, 0x60, 0x20, 0x20, 0x70,  // 1
     0xF0, 0x10, 0xF0, 0x80, 0xF0,  // 2
@@ -37,728 +132,2934 @@ constexpr std::array<std::uint8_t, Chip8::FONT_SET_SIZE> FONT_SET = {
     0xF0, 0x80, 0xF0, 0x80, 0x80,  // F
 };
 
-Chip8::Chip8() : lastError_(ErrorCode::None) { init(); }
+constexpr std::array<std::uint8_t, Chip8Base::BIG_FONT_SET_SIZE> BIG_FONT_SET = {
+    0x3C, 0x7E, 0xE7, 0xC3, 0xC3, 0xC3, 0xC3, 0xE7, 0x7E, 0x3C,  // 0
+    0x18, 0x38, 0x58, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x3C,  // 1
+    0x3E, 0x7F, 0xC3, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xFF, 0xFF,  // 2
+    0x3C, 0x7E, 0xC3, 0x03, 0x0E, 0x0E, 0x03, 0xC3, 0x7E, 0x3C,  // 3
+    0x06, 0x0E, 0x1E, 0x36, 0x66, 0xC6, 0xFF, 0xFF, 0x06, 0x06,  // 4
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFC, 0xFE, 0x03, 0xC3, 0x7E, 0x3C,  // 5
+    0x3E, 0x7C, 0xE0, 0xC0, 0xFC, 0xFE, 0xC3, 0xC3, 0x7E, 0x3C,  // 6
+    0xFF, 0xFF, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x60, 0x60,  // 7
+    0x3C, 0x7E, 0xC3, 0xC3, 0x7E, 0x7E, 0xC3, 0xC3, 0x7E, 0x3C,  // 8
+    0x3C, 0x7E, 0xC3, 0xC3, 0x7F, 0x3F, 0x03, 0x03, 0x3E, 0x7C,  // 9
+    0x7E, 0xFF, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xC3,  // A
+    0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC,  // B
+    0x3C, 0xFF, 0xC3, 0xC0, 0xC0, 0xC0, 0xC0, 0xC3, 0xFF, 0x3C,  // C
+    0xFC, 0xFE, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFE, 0xFC,  // D
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF,  // E
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xC0, 0xC0,  // F
+};
+
+// Columns 00FB/00FC scroll by
+constexpr std::uint16_t HORIZONTAL_SCROLL = 4;
 
-bool Chip8::loadRom(const std::string& path) {
+// Packed display addressing; see Chip8Base::DisplayPlane
+constexpr std::size_t displayWord(std::uint16_t x, std::uint16_t y) {
+    return y * Chip8Base::DISPLAY_ROW_WORDS + x / 64;
+}
+constexpr std::uint64_t displayBit(std::uint16_t x) { return std::uint64_t{1} << (63 - x % 64); }
+
+// Saved states start with this tag, the format version and the memory size.
+// The machine state's fields follow in declaration order, little-endian.
+constexpr std::uint32_t STATE_MAGIC = 0x54533843;  // "C8ST" in little-endian order
+
+// Visits the machine state's fields in serialization order, as far as the
+// given format version has them
+template <typename State, typename Visitor>
+void visitState(State& state, Visitor& visitor, std::uint16_t version) {
+    visitor(state.memory);
+    visitor(state.registers);
+    visitor(state.stack);
+    visitor(state.displayPlanes);
+    visitor(state.keyboard);
+    visitor(state.flagRegisters);
+    visitor(state.audioPattern);
+    visitor(state.indexRegister);
+    visitor(state.stackPointer);
+    visitor(state.delayTimer);
+    visitor(state.soundTimer);
+    visitor(state.programCounter);
+    visitor(state.opcode);
+    visitor(state.drawFlag);
+    visitor(state.highResolution);
+    visitor(state.planes);
+    visitor(state.audioPitch);
+    visitor(state.timerPhase);
+    if (version >= 2) {
+        visitor(state.random.state);
+    }
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+BasicChip8<Policy, Quirks, Rng>::BasicChip8(Backend backend, Logger& logger)
+    : state_{},
+      lastError_{},
+      logger_(&logger),
+      decodeCache_{},
+      decodeGeneration_(0),
+      backend_(backend),
+      stopMask_(0),
+      pendingStops_(0),
+      cyclesPerFrame_(DEFAULT_CYCLES_PER_FRAME),
+      cpuFrequency_(DEFAULT_CPU_FREQUENCY),
+      timerStep_(TIMER_FREQUENCY),
+      timerPeriod_(DEFAULT_CPU_FREQUENCY),
+      hasBreakpoints_(false),
+      fusionEnabled_(true),
+      fusionLimit_(0),
+      compiledRom_(nullptr) {
+    state_.random.seed(freshSeed());
+    init();
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::loadRom(const std::string& path) {
     clearError();
+    romPath_ = path;
 
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
-        setError(ErrorCode::InvalidMemoryAccess, "Failed to open ROM: " + path);
+    MappedFile file;
+    if (!file.open(path)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::RomOpen);
         return false;
     }
 
-    std::streamsize size = file.tellg();
-    const std::streamsize maxRomSize = MEMORY_SIZE - ROM_START_ADDRESS;
+    const std::size_t size = file.size();
+    if (size == 0 || size > MEMORY_SIZE - ROM_START_ADDRESS) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::RomSize,
+                 static_cast<std::uint32_t>(
+                     std::min<std::size_t>(size, std::numeric_limits<std::uint32_t>::max())));
+        return false;
+    }
 
-    if (size <= 0 || size > maxRomSize) {
-        setError(ErrorCode::InvalidMemoryAccess,
-                 "ROM size invalid or too large: " + std::to_string(size) + " bytes");
+    if (!file.load()) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::RomRead);
         return false;
     }
 
-    file.seekg(0, std::ios::beg);
-    std::vector<std::uint8_t> buffer(size);
+    installRom(file.data(), size);
+    if (logger_->isEnabled(LogLevel::Info)) {
+        log(LogLevel::Info,
+            "Successfully loaded ROM: " + path + " (" + std::to_string(size) + " bytes)");
+    }
+    return true;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::loadRom(const std::uint8_t* rom, std::size_t size) {
+    clearError();
+    romPath_.clear();
 
-    if (!file.read(reinterpret_cast<char*>(buffer.data()), size)) {
-        setError(ErrorCode::InvalidMemoryAccess, "Failed to read ROM: " + path);
+    if (!rom || size == 0 || size > MEMORY_SIZE - ROM_START_ADDRESS) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::RomSize,
+                 static_cast<std::uint32_t>(
+                     std::min<std::size_t>(size, std::numeric_limits<std::uint32_t>::max())));
         return false;
     }
 
-    std::copy(buffer.begin(), buffer.end(), memory_.begin() + ROM_START_ADDRESS);
-    logInfo("Successfully loaded ROM: " + path + " (" + std::to_string(size) + " bytes)");
+    installRom(rom, size);
+    if (logger_->isEnabled(LogLevel::Info)) {
+        log(LogLevel::Info, "Successfully loaded ROM (" + std::to_string(size) + " bytes)");
+    }
     return true;
 }
-void Chip8::init() {
-    programCounter_ = ROM_START_ADDRESS;
-    opcode_ = 0;
-    indexRegister_ = 0;
-    stackPointer_ = 0;
-    drawFlag_ = false;
-    delayTimer_ = 0;
-    soundTimer_ = 0;
+
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::loadRom(const std::vector<std::uint8_t>& rom) {
+    return loadRom(rom.data(), rom.size());
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::installRom(const std::uint8_t* rom, std::size_t size) {
+    std::copy(rom, rom + size, state_.memory.begin() + ROM_START_ADDRESS);
+    invalidateDecodeCache();
+    detachCompiledRom();
+}
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::init() {
+    state_.programCounter = ROM_START_ADDRESS;
+    state_.opcode = 0;
+    state_.indexRegister = 0;
+    state_.stackPointer = 0;
+    state_.drawFlag = false;
+    state_.highResolution = false;
+    state_.planes = 1;
+    state_.audioPitch = DEFAULT_AUDIO_PITCH;
+    state_.delayTimer = 0;
+    state_.soundTimer = 0;
+    state_.timerPhase = 0;
 
     // Clear all arrays
-    frameBuffer_.fill(0);
-    stack_.fill(0);
-    keyboard_.fill(0);
-    registers_.fill(0);
-    memory_.fill(0);
+    for (DisplayPlane& plane : state_.displayPlanes) {
+        plane.fill(0);
+    }
+    dirtyRows_ = visibleRows();
+    frameBufferViewStale_ = true;
+    state_.stack.fill(0);
+    state_.keyboard.fill(0);
+    state_.registers.fill(0);
+    state_.memory.fill(0);
+    state_.audioPattern.fill(0);
 
     // Load font set into memory
-    std::copy(FONT_SET.begin(), FONT_SET.end(), memory_.begin());
+    std::copy(FONT_SET.begin(), FONT_SET.end(), state_.memory.begin());
+    std::copy(BIG_FONT_SET.begin(), BIG_FONT_SET.end(), state_.memory.begin() + BIG_FONT_ADDRESS);
+    invalidateDecodeCache();
+    detachCompiledRom();
 
     clearError();
-    logInfo("CHIP-8 emulator initialized");
+    log(LogLevel::Info, "CHIP-8 emulator initialized");
 }
 
-void Chip8::emulateCycle() {
-    clearError();
-
-    // Bounds check for program counter
-    if (programCounter_ >= MEMORY_SIZE - 1) {
-        setError(ErrorCode::InvalidMemoryAccess,
-                 "Program counter out of bounds: " + std::to_string(programCounter_));
-        return;
-    }
-
-    // Fetch opcode
-    opcode_ = (memory_[programCounter_] << 8) | memory_[programCounter_ + 1];
-    // Decode and execute opcode
-    switch (opcode_ & 0xF000) {
+// Decode cache
+template <typename Policy, typename Quirks, typename Rng>
+typename BasicChip8<Policy, Quirks, Rng>::DecodedInstruction
+BasicChip8<Policy, Quirks, Rng>::decode(std::uint16_t opcode) {
+    DecodedInstruction instr{};
+    instr.opcode = opcode;
+    instr.nnn = opcode & 0x0FFF;
+    instr.x = (opcode & 0x0F00) >> 8;
+    instr.y = (opcode & 0x00F0) >> 4;
+    instr.n = opcode & 0x000F;
+    instr.nn = opcode & 0x00FF;
+    instr.operation = Operation::Unknown;
+    instr.fused = Operation::Unknown;
+
+    switch (opcode & 0xF000) {
         case 0x0000:
-            handleOpcode0xxx();
+            // SUPER-CHIP and XO-CHIP opcodes match exactly; CLS and RET only by
+            // the low nibble
+            if (Quirks::SUPER_CHIP && (opcode & 0xFFF0) == 0x00C0) {
+                instr.operation = Operation::Op00CN;
+            } else if (Quirks::SUPER_CHIP && opcode == 0x00FB) {
+                instr.operation = Operation::Op00FB;
+            } else if (Quirks::SUPER_CHIP && opcode == 0x00FC) {
+                instr.operation = Operation::Op00FC;
+            } else if (Quirks::SUPER_CHIP && opcode == 0x00FD) {
+                instr.operation = Operation::Op00FD;
+            } else if (Quirks::SUPER_CHIP && opcode == 0x00FE) {
+                instr.operation = Operation::Op00FE;
+            } else if (Quirks::SUPER_CHIP && opcode == 0x00FF) {
+                instr.operation = Operation::Op00FF;
+            } else if (Quirks::XO_CHIP && (opcode & 0xFFF0) == 0x00D0) {
+                instr.operation = Operation::Op00DN;
+            } else if (instr.n == 0x0) {
+                instr.operation = Operation::Op00E0;
+            } else if (instr.n == 0xE) {
+                instr.operation = Operation::Op00EE;
+            }
             break;
         case 0x1000:
-            handleOpcode1xxx();
+            instr.operation = Operation::Op1NNN;
             break;
         case 0x2000:
-            handleOpcode2xxx();
+            instr.operation = Operation::Op2NNN;
             break;
         case 0x3000:
-            handleOpcode3xxx();
+            instr.operation = Operation::Op3XNN;
             break;
         case 0x4000:
-            handleOpcode4xxx();
+            instr.operation = Operation::Op4XNN;
             break;
         case 0x5000:
-            handleOpcode5xxx();
+            if (Quirks::XO_CHIP && instr.n == 0x2) {
+                instr.operation = Operation::Op5XY2;
+            } else if (Quirks::XO_CHIP && instr.n == 0x3) {
+                instr.operation = Operation::Op5XY3;
+            } else {
+                instr.operation = Operation::Op5XY0;
+            }
             break;
         case 0x6000:
-            handleOpcode6xxx();
+            instr.operation = Operation::Op6XNN;
             break;
         case 0x7000:
-            handleOpcode7xxx();
+            instr.operation = Operation::Op7XNN;
             break;
         case 0x8000:
-            handleOpcode8xxx();
+            switch (instr.n) {
+                case 0x0:
+                    instr.operation = Operation::Op8XY0;
+                    break;
+                case 0x1:
+                    instr.operation = Operation::Op8XY1;
+                    break;
+                case 0x2:
+                    instr.operation = Operation::Op8XY2;
+                    break;
+                case 0x3:
+                    instr.operation = Operation::Op8XY3;
+                    break;
+                case 0x4:
+                    instr.operation = Operation::Op8XY4;
+                    break;
+                case 0x5:
+                    instr.operation = Operation::Op8XY5;
+                    break;
+                case 0x6:
+                    instr.operation = Operation::Op8XY6;
+                    break;
+                case 0x7:
+                    instr.operation = Operation::Op8XY7;
+                    break;
+                case 0xE:
+                    instr.operation = Operation::Op8XYE;
+                    break;
+                default:
+                    break;
+            }
             break;
         case 0x9000:
-            handleOpcode9xxx();
+            instr.operation = Operation::Op9XY0;
             break;
         case 0xA000:
-            handleOpcodeAxxx();
+            instr.operation = Operation::OpANNN;
             break;
         case 0xB000:
-            handleOpcodeBxxx();
+            instr.operation = Operation::OpBNNN;
             break;
         case 0xC000:
-            handleOpcodeCxxx();
+            instr.operation = Operation::OpCXNN;
             break;
         case 0xD000:
-            handleOpcodeDxxx();
+            instr.operation = Operation::OpDXYN;
             break;
         case 0xE000:
-            handleOpcodeExxx();
+            if (instr.n == 0xE) {
+                instr.operation = Operation::OpEX9E;
+            } else if (instr.n == 0x1) {
+                instr.operation = Operation::OpEXA1;
+            }
             break;
         case 0xF000:
-            handleOpcodeFxxx();
+            switch (instr.nn) {
+                case 0x07:
+                    instr.operation = Operation::OpFX07;
+                    break;
+                case 0x0A:
+                    instr.operation = Operation::OpFX0A;
+                    break;
+                case 0x15:
+                    instr.operation = Operation::OpFX15;
+                    break;
+                case 0x18:
+                    instr.operation = Operation::OpFX18;
+                    break;
+                case 0x1E:
+                    instr.operation = Operation::OpFX1E;
+                    break;
+                case 0x29:
+                    instr.operation = Operation::OpFX29;
+                    break;
+                case 0x33:
+                    instr.operation = Operation::OpFX33;
+                    break;
+                case 0x55:
+                    instr.operation = Operation::OpFX55;
+                    break;
+                case 0x65:
+                    instr.operation = Operation::OpFX65;
+                    break;
+                case 0x30:
+                    if (Quirks::SUPER_CHIP) {
+                        instr.operation = Operation::OpFX30;
+                    }
+                    break;
+                case 0x75:
+                    if (Quirks::SUPER_CHIP) {
+                        instr.operation = Operation::OpFX75;
+                    }
+                    break;
+                case 0x85:
+                    if (Quirks::SUPER_CHIP) {
+                        instr.operation = Operation::OpFX85;
+                    }
+                    break;
+                case 0x00:
+                    if (Quirks::XO_CHIP && instr.x == 0) {
+                        instr.operation = Operation::OpF000;
+                    }
+                    break;
+                case 0x01:
+                    if (Quirks::XO_CHIP) {
+                        instr.operation = Operation::OpFN01;
+                    }
+                    break;
+                case 0x02:
+                    if (Quirks::XO_CHIP && instr.x == 0) {
+                        instr.operation = Operation::OpF002;
+                    }
+                    break;
+                case 0x3A:
+                    if (Quirks::XO_CHIP) {
+                        instr.operation = Operation::OpFX3A;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            break;
+    }
+
+    instr.fused = instr.operation;
+    return instr;
+}
+
+// Pairs chosen from dynamic opcode-pair counts over roms/; see ARCHITECTURE.md
+template <typename Policy, typename Quirks, typename Rng>
+typename BasicChip8<Policy, Quirks, Rng>::Operation BasicChip8<Policy, Quirks, Rng>::fuse(
+    const DecodedInstruction& instr, std::uint16_t address) const {
+    const auto decodeAt = [this](std::uint32_t at) {
+        if (at >= MEMORY_SIZE - 1) {
+            return decode(0x0000);  // Decodes to CLS, which never fuses as a follower
+        }
+        return decode(static_cast<std::uint16_t>((state_.memory[at] << 8) | state_.memory[at + 1]));
+    };
+
+    const DecodedInstruction second = decodeAt(address + 2u);
+    switch (instr.operation) {
+        case Operation::Op1NNN:
+            if (instr.nnn == address) {
+                return Operation::OpIdle1NNN;
+            }
+            break;
+        case Operation::OpFX0A:
+            return Operation::OpIdleFX0A;
+        case Operation::Op00FD:
+            return Operation::OpIdle1NNN;  // Exit stays in place, like a jump to itself
+        case Operation::OpANNN:
+            if (second.operation == Operation::OpDXYN) {
+                return Operation::OpANNN_DXYN;
+            }
+            break;
+        case Operation::Op6XNN:
+            if (second.operation == Operation::Op6XNN) {
+                return Operation::Op6XNN_6XNN;
+            }
+            break;
+        case Operation::Op7XNN:
+            if (second.operation == Operation::Op3XNN) {
+                return Operation::Op7XNN_3XNN;
+            }
+            if (second.operation == Operation::Op4XNN) {
+                return Operation::Op7XNN_4XNN;
+            }
+            break;
+        case Operation::OpFX07:
+            if (second.operation == Operation::Op3XNN && second.x == instr.x && second.nn == 0) {
+                const DecodedInstruction third = decodeAt(address + 4u);
+                if (third.operation == Operation::Op1NNN) {
+                    return third.nnn == address ? Operation::OpIdleFX07_3X00_1NNN
+                                                : Operation::OpFX07_3X00_1NNN;
+                }
+            }
             break;
         default:
-            setError(ErrorCode::UnknownOpcode, "Unknown opcode: 0x" + std::to_string(opcode_));
-            return;
+            break;
+    }
+    return instr.operation;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+const typename BasicChip8<Policy, Quirks, Rng>::DecodedInstruction&
+BasicChip8<Policy, Quirks, Rng>::fetchDecoded(std::uint16_t address) {
+    DecodedInstruction& entry = decodeCache_[address];
+    if (entry.generation != decodeGeneration_) {
+        entry = decode(static_cast<std::uint16_t>((state_.memory[address] << 8) |
+                                                  state_.memory[address + 1]));
+        if (Quirks::XO_CHIP && entry.operation == Operation::OpF000) {
+            // The address follows the opcode; writes to it invalidate this
+            // entry like they would a superinstruction's
+            const std::uint32_t next = address + 2u;
+            entry.nnn = static_cast<std::uint16_t>(state_.memory[next & ADDRESS_MASK] << 8 |
+                                                   state_.memory[(next + 1) & ADDRESS_MASK]);
+        }
+        entry.fused = fuse(entry, address);
+        entry.generation = decodeGeneration_;
+    }
+    return entry;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+inline const typename BasicChip8<Policy, Quirks, Rng>::DecodedInstruction&
+BasicChip8<Policy, Quirks, Rng>::fetchFusedPart() {
+    const DecodedInstruction& instr = fetchDecoded(state_.programCounter);
+    state_.opcode = instr.opcode;
+    return instr;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::execute(const DecodedInstruction& instr) {
+    switch (instr.operation) {
+        case Operation::Op00E0:
+            handleOpcode00E0(instr);
+            break;
+        case Operation::Op00EE:
+            handleOpcode00EE(instr);
+            break;
+        case Operation::Op1NNN:
+            handleOpcode1NNN(instr);
+            break;
+        case Operation::Op2NNN:
+            handleOpcode2NNN(instr);
+            break;
+        case Operation::Op3XNN:
+            handleOpcode3XNN(instr);
+            break;
+        case Operation::Op4XNN:
+            handleOpcode4XNN(instr);
+            break;
+        case Operation::Op5XY0:
+            handleOpcode5XY0(instr);
+            break;
+        case Operation::Op6XNN:
+            handleOpcode6XNN(instr);
+            break;
+        case Operation::Op7XNN:
+            handleOpcode7XNN(instr);
+            break;
+        case Operation::Op8XY0:
+            handleOpcode8XY0(instr);
+            break;
+        case Operation::Op8XY1:
+            handleOpcode8XY1(instr);
+            break;
+        case Operation::Op8XY2:
+            handleOpcode8XY2(instr);
+            break;
+        case Operation::Op8XY3:
+            handleOpcode8XY3(instr);
+            break;
+        case Operation::Op8XY4:
+            handleOpcode8XY4(instr);
+            break;
+        case Operation::Op8XY5:
+            handleOpcode8XY5(instr);
+            break;
+        case Operation::Op8XY6:
+            handleOpcode8XY6(instr);
+            break;
+        case Operation::Op8XY7:
+            handleOpcode8XY7(instr);
+            break;
+        case Operation::Op8XYE:
+            handleOpcode8XYE(instr);
+            break;
+        case Operation::Op9XY0:
+            handleOpcode9XY0(instr);
+            break;
+        case Operation::OpANNN:
+            handleOpcodeANNN(instr);
+            break;
+        case Operation::OpBNNN:
+            handleOpcodeBNNN(instr);
+            break;
+        case Operation::OpCXNN:
+            handleOpcodeCXNN(instr);
+            break;
+        case Operation::OpDXYN:
+            handleOpcodeDXYN(instr);
+            break;
+        case Operation::OpEX9E:
+            handleOpcodeEX9E(instr);
+            break;
+        case Operation::OpEXA1:
+            handleOpcodeEXA1(instr);
+            break;
+        case Operation::OpFX07:
+            handleOpcodeFX07(instr);
+            break;
+        case Operation::OpFX0A:
+            handleOpcodeFX0A(instr);
+            break;
+        case Operation::OpFX15:
+            handleOpcodeFX15(instr);
+            break;
+        case Operation::OpFX18:
+            handleOpcodeFX18(instr);
+            break;
+        case Operation::OpFX1E:
+            handleOpcodeFX1E(instr);
+            break;
+        case Operation::OpFX29:
+            handleOpcodeFX29(instr);
+            break;
+        case Operation::OpFX33:
+            handleOpcodeFX33(instr);
+            break;
+        case Operation::OpFX55:
+            handleOpcodeFX55(instr);
+            break;
+        case Operation::OpFX65:
+            handleOpcodeFX65(instr);
+            break;
+        case Operation::Op00CN:
+            handleOpcode00CN(instr);
+            break;
+        case Operation::Op00FB:
+            handleOpcode00FB(instr);
+            break;
+        case Operation::Op00FC:
+            handleOpcode00FC(instr);
+            break;
+        case Operation::Op00FD:
+            handleOpcode00FD(instr);
+            break;
+        case Operation::Op00FE:
+            handleOpcode00FE(instr);
+            break;
+        case Operation::Op00FF:
+            handleOpcode00FF(instr);
+            break;
+        case Operation::OpFX30:
+            handleOpcodeFX30(instr);
+            break;
+        case Operation::OpFX75:
+            handleOpcodeFX75(instr);
+            break;
+        case Operation::OpFX85:
+            handleOpcodeFX85(instr);
+            break;
+        case Operation::OpF000:
+            handleOpcodeF000(instr);
+            break;
+        case Operation::OpFN01:
+            handleOpcodeFN01(instr);
+            break;
+        case Operation::Op5XY2:
+            handleOpcode5XY2(instr);
+            break;
+        case Operation::Op5XY3:
+            handleOpcode5XY3(instr);
+            break;
+        case Operation::OpF002:
+            handleOpcodeF002(instr);
+            break;
+        case Operation::OpFX3A:
+            handleOpcodeFX3A(instr);
+            break;
+        case Operation::Op00DN:
+            handleOpcode00DN(instr);
+            break;
+        // Superinstructions only appear in the fused field
+        case Operation::OpANNN_DXYN:
+        case Operation::Op6XNN_6XNN:
+        case Operation::Op7XNN_3XNN:
+        case Operation::Op7XNN_4XNN:
+        case Operation::OpFX07_3X00_1NNN:
+        case Operation::OpIdle1NNN:
+        case Operation::OpIdleFX0A:
+        case Operation::OpIdleFX07_3X00_1NNN:
+        case Operation::Unknown:
+            handleUnknownOpcode(instr);
+            break;
+    }
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::executeFused(const DecodedInstruction& instr,
+                                                            std::uint32_t budget) {
+    switch (instr.fused) {
+        case Operation::OpANNN_DXYN:
+            return handleFusedANNN_DXYN(instr, budget);
+        case Operation::Op6XNN_6XNN:
+            return handleFused6XNN_6XNN(instr, budget);
+        case Operation::Op7XNN_3XNN:
+            return handleFused7XNN_3XNN(instr, budget);
+        case Operation::Op7XNN_4XNN:
+            return handleFused7XNN_4XNN(instr, budget);
+        case Operation::OpFX07_3X00_1NNN:
+            return handleFusedFX07_3X00_1NNN(instr, budget);
+        case Operation::OpIdle1NNN:
+            return handleIdle1NNN(instr, budget);
+        case Operation::OpIdleFX0A:
+            return handleIdleFX0A(instr, budget);
+        case Operation::OpIdleFX07_3X00_1NNN:
+            return handleIdleFX07_3X00_1NNN(instr, budget);
+        default:
+            execute(instr);
+            updateTimers();
+            return 1;
+    }
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::updateTimers() {
+    // One instruction of the CPU clock
+    state_.timerPhase += timerStep_;
+    if (state_.timerPhase >= timerPeriod_) {
+        state_.timerPhase -= timerPeriod_;
+        applyTimerTicks(1);
+    }
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::advanceTimers(std::uint32_t cycles) {
+    // Same result as calling updateTimers() once per cycle
+    const std::uint64_t phase = state_.timerPhase + std::uint64_t{timerStep_} * cycles;
+    if (phase < timerPeriod_) {
+        state_.timerPhase = static_cast<std::uint32_t>(phase);
+        return;
+    }
+    state_.timerPhase = static_cast<std::uint32_t>(phase % timerPeriod_);
+    applyTimerTicks(phase / timerPeriod_);
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::applyTimerTicks(std::uint64_t ticks) {
+    state_.delayTimer =
+        state_.delayTimer > ticks ? static_cast<std::uint8_t>(state_.delayTimer - ticks) : 0;
+    if (state_.soundTimer > 0) {
+        if (state_.soundTimer <= ticks) {
+            log(LogLevel::Info, "BEEP! Sound timer expired");
+        }
+        state_.soundTimer =
+            state_.soundTimer > ticks ? static_cast<std::uint8_t>(state_.soundTimer - ticks) : 0;
+    }
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::invalidateDecodeCache() {
+    // Generation 0 marks an entry as invalid, so skip it when the counter wraps
+    if (++decodeGeneration_ == 0) {
+        for (auto& entry : decodeCache_) {
+            entry.generation = 0;
+        }
+        decodeGeneration_ = 1;
+    }
+    flushTranslatedBlocks();
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::invalidateDecoded(std::uint16_t address,
+                                                 std::uint16_t count) {
+    // A superinstruction starting up to MAX_FUSED_LENGTH * 2 - 1 bytes before
+    // the write also covers it, and translated blocks hold copies of its entry
+    const std::uint32_t reach = MAX_FUSED_LENGTH * 2 - 1;
+    const std::uint32_t first = address > reach ? address - reach : 0;
+    const std::uint32_t last = std::min<std::uint32_t>(address + count, MEMORY_SIZE);
+    for (std::uint32_t i = first; i < last; ++i) {
+        decodeCache_[i].generation = 0;
+    }
+    invalidateTranslatedBlocks(first, last);
+    invalidateCompiledBlocks(address, last);
+
+    // Writes from the trusted core wrap around the end of memory
+    if (address + count > MEMORY_SIZE) {
+        invalidateDecoded(0, static_cast<std::uint16_t>(address + count - MEMORY_SIZE));
+    }
+}
+
+// Execution backends
+template <typename Policy, typename Quirks, typename Rng>
+Chip8Base::RunResult BasicChip8<Policy, Quirks, Rng>::run(std::uint32_t count,
+                                                   std::uint8_t stopMask) {
+    clearError();
+    stopMask_ = stopMask;
+    pendingStops_ = 0;
+    // Superinstructions must fit the budget, and breakpoints are checked per instruction
+    const bool fusion = fusionEnabled_ && !hasBreakpoints_ && count >= MAX_FUSED_LENGTH;
+    fusionLimit_ = fusion ? count - MAX_FUSED_LENGTH + 1 : 0;
+
+    std::uint32_t executed = 0;
+    if (compiledRom_ != nullptr && !hasBreakpoints_) {
+        executed = runCompiled(count);
+    } else {
+        switch (backend_) {
+            case Backend::Threaded:
+                executed = runThreaded(count);
+                break;
+            case Backend::TailCall:
+                executed = runTailCall(count);
+                break;
+            case Backend::BlockTranslator:
+                executed = runTranslatedBlocks(count);
+                break;
+            case Backend::Switch:
+            default:
+                executed = runSwitch(count);
+                break;
+        }
+    }
+
+    const std::uint8_t stops = pendingStops_;
+    stopMask_ = 0;
+    pendingStops_ = 0;
+    fusionLimit_ = 0;
+
+    StopReason reason = StopReason::CycleLimit;
+    if ((stops & STOP_ERROR) != 0) {
+        reason = StopReason::Error;
+    } else if ((stops & STOP_BREAKPOINT) != 0) {
+        reason = StopReason::Breakpoint;
+    } else if ((stops & STOP_KEY_WAIT) != 0) {
+        reason = StopReason::KeyWait;
+    } else if ((stops & STOP_DRAW) != 0) {
+        reason = StopReason::Draw;
+    } else if ((stopMask & STOP_KEY_WAIT) == 0 && isWaitingForKey()) {
+        reason = StopReason::KeyWait;
+    }
+    return RunResult{reason, executed};
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::isWaitingForKey() {
+    // Keys don't change during a run, so the FX0A at the PC will wait again
+    if (state_.programCounter >= MEMORY_SIZE - 1 ||
+        fetchDecoded(state_.programCounter).operation != Operation::OpFX0A) {
+        return false;
+    }
+    return std::all_of(state_.keyboard.begin(), state_.keyboard.end(),
+                       [](std::uint8_t key) { return key == 0; });
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+inline void BasicChip8<Policy, Quirks, Rng>::raiseStop(std::uint8_t event) {
+    pendingStops_ |= event & stopMask_;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+inline bool BasicChip8<Policy, Quirks, Rng>::readyToExecute(std::uint32_t executed) {
+    if (state_.programCounter >= MEMORY_SIZE - 1) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::ProgramCounterBounds,
+                 state_.programCounter);
+        return false;
+    }
+    if (hasBreakpoints_ && executed > 0 && breakpoints_.test(state_.programCounter)) {
+        raiseStop(STOP_BREAKPOINT);
+        return false;
+    }
+    return true;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::runSwitch(std::uint32_t count) {
+    std::uint32_t executed = 0;
+    while (executed < count && readyToExecute(executed)) {
+        const DecodedInstruction& instr = fetchDecoded(state_.programCounter);
+        state_.opcode = instr.opcode;
+        if (instr.fused != instr.operation && executed < fusionLimit_) {
+            executed += executeFused(instr, count - executed);
+        } else {
+            execute(instr);
+            updateTimers();
+            ++executed;
+        }
+
+        if (pendingStops_ != 0) {
+            break;
+        }
+    }
+    return executed;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::runThreaded(std::uint32_t count) {
+#if CHIP8_HAS_COMPUTED_GOTO
+    // Labels in Operation order; every handler jumps straight to the next one
+    static void* const LABELS[OPERATION_COUNT] = {
+        &&op00E0,
+        &&op00EE,
+        &&op1NNN,
+        &&op2NNN,
+        &&op3XNN,
+        &&op4XNN,
+        &&op5XY0,
+        &&op6XNN,
+        &&op7XNN,
+        &&op8XY0,
+        &&op8XY1,
+        &&op8XY2,
+        &&op8XY3,
+        &&op8XY4,
+        &&op8XY5,
+        &&op8XY6,
+        &&op8XY7,
+        &&op8XYE,
+        &&op9XY0,
+        &&opANNN,
+        &&opBNNN,
+        &&opCXNN,
+        &&opDXYN,
+        &&opEX9E,
+        &&opEXA1,
+        &&opFX07,
+        &&opFX0A,
+        &&opFX15,
+        &&opFX18,
+        &&opFX1E,
+        &&opFX29,
+        &&opFX33,
+        &&opFX55,
+        &&opFX65,
+        &&op00CN,
+        &&op00FB,
+        &&op00FC,
+        &&op00FD,
+        &&op00FE,
+        &&op00FF,
+        &&opFX30,
+        &&opFX75,
+        &&opFX85,
+        &&opF000,
+        &&opFN01,
+        &&op5XY2,
+        &&op5XY3,
+        &&opF002,
+        &&opFX3A,
+        &&op00DN,
+        &&opANNN_DXYN,
+        &&op6XNN_6XNN,
+        &&op7XNN_3XNN,
+        &&op7XNN_4XNN,
+        &&opFX07_3X00_1NNN,
+        &&opIdle1NNN,
+        &&opIdleFX0A,
+        &&opIdleFX07_3X00_1NNN,
+        &&opUnknown,
+    };
+
+    std::uint32_t executed = 0;
+    const DecodedInstruction* instr = nullptr;
+
+#define CHIP8_THREADED_DISPATCH()                                                              \
+    do {                                                                                       \
+        if (executed == count || !readyToExecute(executed)) return executed;                   \
+        instr = &fetchDecoded(state_.programCounter);                                          \
+        state_.opcode = instr->opcode;                                                         \
+        goto* LABELS[static_cast<std::size_t>(executed < fusionLimit_ ? instr->fused           \
+                                                                      : instr->operation)];    \
+    } while (0)
+
+#define CHIP8_THREADED_NEXT()                                                                  \
+    do {                                                                                       \
+        updateTimers();                                                                        \
+        ++executed;                                                                            \
+        if (pendingStops_ != 0) return executed;                                               \
+        CHIP8_THREADED_DISPATCH();                                                             \
+    } while (0)
+
+    // Superinstruction handlers update the timers and count their own cycles
+#define CHIP8_THREADED_NEXT_FUSED(handler)                                                     \
+    do {                                                                                       \
+        executed += handler(*instr, count - executed);                                         \
+        if (pendingStops_ != 0) return executed;                                               \
+        CHIP8_THREADED_DISPATCH();                                                             \
+    } while (0)
+
+    CHIP8_THREADED_DISPATCH();
+
+op00E0:
+    handleOpcode00E0(*instr);
+    CHIP8_THREADED_NEXT();
+op00EE:
+    handleOpcode00EE(*instr);
+    CHIP8_THREADED_NEXT();
+op1NNN:
+    handleOpcode1NNN(*instr);
+    CHIP8_THREADED_NEXT();
+op2NNN:
+    handleOpcode2NNN(*instr);
+    CHIP8_THREADED_NEXT();
+op3XNN:
+    handleOpcode3XNN(*instr);
+    CHIP8_THREADED_NEXT();
+op4XNN:
+    handleOpcode4XNN(*instr);
+    CHIP8_THREADED_NEXT();
+op5XY0:
+    handleOpcode5XY0(*instr);
+    CHIP8_THREADED_NEXT();
+op6XNN:
+    handleOpcode6XNN(*instr);
+    CHIP8_THREADED_NEXT();
+op7XNN:
+    handleOpcode7XNN(*instr);
+    CHIP8_THREADED_NEXT();
+op8XY0:
+    handleOpcode8XY0(*instr);
+    CHIP8_THREADED_NEXT();
+op8XY1:
+    handleOpcode8XY1(*instr);
+    CHIP8_THREADED_NEXT();
+op8XY2:
+    handleOpcode8XY2(*instr);
+    CHIP8_THREADED_NEXT();
+op8XY3:
+    handleOpcode8XY3(*instr);
+    CHIP8_THREADED_NEXT();
+op8XY4:
+    handleOpcode8XY4(*instr);
+    CHIP8_THREADED_NEXT();
+op8XY5:
+    handleOpcode8XY5(*instr);
+    CHIP8_THREADED_NEXT();
+op8XY6:
+    handleOpcode8XY6(*instr);
+    CHIP8_THREADED_NEXT();
+op8XY7:
+    handleOpcode8XY7(*instr);
+    CHIP8_THREADED_NEXT();
+op8XYE:
+    handleOpcode8XYE(*instr);
+    CHIP8_THREADED_NEXT();
+op9XY0:
+    handleOpcode9XY0(*instr);
+    CHIP8_THREADED_NEXT();
+opANNN:
+    handleOpcodeANNN(*instr);
+    CHIP8_THREADED_NEXT();
+opBNNN:
+    handleOpcodeBNNN(*instr);
+    CHIP8_THREADED_NEXT();
+opCXNN:
+    handleOpcodeCXNN(*instr);
+    CHIP8_THREADED_NEXT();
+opDXYN:
+    handleOpcodeDXYN(*instr);
+    CHIP8_THREADED_NEXT();
+opEX9E:
+    handleOpcodeEX9E(*instr);
+    CHIP8_THREADED_NEXT();
+opEXA1:
+    handleOpcodeEXA1(*instr);
+    CHIP8_THREADED_NEXT();
+opFX07:
+    handleOpcodeFX07(*instr);
+    CHIP8_THREADED_NEXT();
+opFX0A:
+    handleOpcodeFX0A(*instr);
+    CHIP8_THREADED_NEXT();
+opFX15:
+    handleOpcodeFX15(*instr);
+    CHIP8_THREADED_NEXT();
+opFX18:
+    handleOpcodeFX18(*instr);
+    CHIP8_THREADED_NEXT();
+opFX1E:
+    handleOpcodeFX1E(*instr);
+    CHIP8_THREADED_NEXT();
+opFX29:
+    handleOpcodeFX29(*instr);
+    CHIP8_THREADED_NEXT();
+opFX33:
+    handleOpcodeFX33(*instr);
+    CHIP8_THREADED_NEXT();
+opFX55:
+    handleOpcodeFX55(*instr);
+    CHIP8_THREADED_NEXT();
+opFX65:
+    handleOpcodeFX65(*instr);
+    CHIP8_THREADED_NEXT();
+op00CN:
+    handleOpcode00CN(*instr);
+    CHIP8_THREADED_NEXT();
+op00FB:
+    handleOpcode00FB(*instr);
+    CHIP8_THREADED_NEXT();
+op00FC:
+    handleOpcode00FC(*instr);
+    CHIP8_THREADED_NEXT();
+op00FD:
+    handleOpcode00FD(*instr);
+    CHIP8_THREADED_NEXT();
+op00FE:
+    handleOpcode00FE(*instr);
+    CHIP8_THREADED_NEXT();
+op00FF:
+    handleOpcode00FF(*instr);
+    CHIP8_THREADED_NEXT();
+opFX30:
+    handleOpcodeFX30(*instr);
+    CHIP8_THREADED_NEXT();
+opFX75:
+    handleOpcodeFX75(*instr);
+    CHIP8_THREADED_NEXT();
+opFX85:
+    handleOpcodeFX85(*instr);
+    CHIP8_THREADED_NEXT();
+opF000:
+    handleOpcodeF000(*instr);
+    CHIP8_THREADED_NEXT();
+opFN01:
+    handleOpcodeFN01(*instr);
+    CHIP8_THREADED_NEXT();
+op5XY2:
+    handleOpcode5XY2(*instr);
+    CHIP8_THREADED_NEXT();
+op5XY3:
+    handleOpcode5XY3(*instr);
+    CHIP8_THREADED_NEXT();
+opF002:
+    handleOpcodeF002(*instr);
+    CHIP8_THREADED_NEXT();
+opFX3A:
+    handleOpcodeFX3A(*instr);
+    CHIP8_THREADED_NEXT();
+op00DN:
+    handleOpcode00DN(*instr);
+    CHIP8_THREADED_NEXT();
+opANNN_DXYN:
+    CHIP8_THREADED_NEXT_FUSED(handleFusedANNN_DXYN);
+op6XNN_6XNN:
+    CHIP8_THREADED_NEXT_FUSED(handleFused6XNN_6XNN);
+op7XNN_3XNN:
+    CHIP8_THREADED_NEXT_FUSED(handleFused7XNN_3XNN);
+op7XNN_4XNN:
+    CHIP8_THREADED_NEXT_FUSED(handleFused7XNN_4XNN);
+opFX07_3X00_1NNN:
+    CHIP8_THREADED_NEXT_FUSED(handleFusedFX07_3X00_1NNN);
+opIdle1NNN:
+    CHIP8_THREADED_NEXT_FUSED(handleIdle1NNN);
+opIdleFX0A:
+    CHIP8_THREADED_NEXT_FUSED(handleIdleFX0A);
+opIdleFX07_3X00_1NNN:
+    CHIP8_THREADED_NEXT_FUSED(handleIdleFX07_3X00_1NNN);
+opUnknown:
+    handleUnknownOpcode(*instr);
+    CHIP8_THREADED_NEXT();
+
+#undef CHIP8_THREADED_NEXT_FUSED
+#undef CHIP8_THREADED_NEXT
+#undef CHIP8_THREADED_DISPATCH
+#else
+    return runSwitch(count);
+#endif
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+const std::array<typename BasicChip8<Policy, Quirks, Rng>::TailCallHandler,
+                 BasicChip8<Policy, Quirks, Rng>::OPERATION_COUNT>
+    BasicChip8<Policy, Quirks, Rng>::TAIL_CALL_HANDLERS = {
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode00E0>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode00EE>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode1NNN>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode2NNN>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode3XNN>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode4XNN>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode5XY0>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode6XNN>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode7XNN>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode8XY0>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode8XY1>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode8XY2>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode8XY3>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode8XY4>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode8XY5>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode8XY6>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode8XY7>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode8XYE>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode9XY0>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeANNN>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeBNNN>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeCXNN>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeDXYN>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeEX9E>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeEXA1>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX07>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX0A>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX15>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX18>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX1E>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX29>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX33>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX55>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX65>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode00CN>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode00FB>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode00FC>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode00FD>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode00FE>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode00FF>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX30>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX75>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX85>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeF000>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFN01>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode5XY2>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode5XY3>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeF002>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcodeFX3A>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleOpcode00DN>,
+    &BasicChip8::tailCallFusedStep<&BasicChip8::handleFusedANNN_DXYN>,
+    &BasicChip8::tailCallFusedStep<&BasicChip8::handleFused6XNN_6XNN>,
+    &BasicChip8::tailCallFusedStep<&BasicChip8::handleFused7XNN_3XNN>,
+    &BasicChip8::tailCallFusedStep<&BasicChip8::handleFused7XNN_4XNN>,
+    &BasicChip8::tailCallFusedStep<&BasicChip8::handleFusedFX07_3X00_1NNN>,
+    &BasicChip8::tailCallFusedStep<&BasicChip8::handleIdle1NNN>,
+    &BasicChip8::tailCallFusedStep<&BasicChip8::handleIdleFX0A>,
+    &BasicChip8::tailCallFusedStep<&BasicChip8::handleIdleFX07_3X00_1NNN>,
+    &BasicChip8::tailCallStep<&BasicChip8::handleUnknownOpcode>,
+};
+
+template <typename Policy, typename Quirks, typename Rng>
+template <typename BasicChip8<Policy, Quirks, Rng>::OpcodeHandler Handler>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::tailCallStep(BasicChip8& self,
+                                                            const DecodedInstruction& instr,
+                                                            std::uint32_t executed,
+                                                            std::uint32_t count) {
+    (self.*Handler)(instr);
+    self.updateTimers();
+    ++executed;
+#if CHIP8_HAS_MUSTTAIL
+    if (self.pendingStops_ != 0) {
+        return executed;
+    }
+    CHIP8_MUSTTAIL return tailCallDispatch(self, instr, executed, count);
+#else
+    // Without guaranteed tail calls the chain would grow the stack, so return
+    // to the driver loop in runTailCall() instead
+    static_cast<void>(count);
+    return executed;
+#endif
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+template <typename BasicChip8<Policy, Quirks, Rng>::FusedHandler Handler>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::tailCallFusedStep(BasicChip8& self,
+                                                                 const DecodedInstruction& instr,
+                                                                 std::uint32_t executed,
+                                                                 std::uint32_t count) {
+    executed += (self.*Handler)(instr, count - executed);
+#if CHIP8_HAS_MUSTTAIL
+    if (self.pendingStops_ != 0) {
+        return executed;
+    }
+    CHIP8_MUSTTAIL return tailCallDispatch(self, instr, executed, count);
+#else
+    return executed;
+#endif
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::tailCallDispatch(
+    BasicChip8& self, const DecodedInstruction& /*previous*/, std::uint32_t executed,
+    std::uint32_t count) {
+    if (executed == count || !self.readyToExecute(executed)) {
+        return executed;
+    }
+
+    const DecodedInstruction& instr = self.fetchDecoded(self.state_.programCounter);
+    self.state_.opcode = instr.opcode;
+    const Operation operation = executed < self.fusionLimit_ ? instr.fused : instr.operation;
+    CHIP8_MUSTTAIL return TAIL_CALL_HANDLERS[static_cast<std::size_t>(operation)](
+        self, instr, executed, count);
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::runTailCall(std::uint32_t count) {
+#if CHIP8_HAS_MUSTTAIL
+    return tailCallDispatch(*this, decodeCache_.front(), 0, count);
+#else
+    std::uint32_t executed = 0;
+    while (executed < count && pendingStops_ == 0) {
+        const std::uint32_t before = executed;
+        executed = tailCallDispatch(*this, decodeCache_.front(), executed, count);
+        if (executed == before) {
+            break;  // Stopped before executing anything
+        }
+    }
+    return executed;
+#endif
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::runTranslatedBlocks(std::uint32_t count) {
+    std::uint32_t executed = 0;
+    std::uint16_t previous = NO_BLOCK;
+
+    while (executed < count && readyToExecute(executed)) {
+        // Translation never flushes, so indices held below stay valid
+        if (blocks_.size() >= NO_BLOCK ||
+            blockCode_.size() + MAX_BLOCK_LENGTH > MAX_TRANSLATED_INSTRUCTIONS) {
+            flushTranslatedBlocks();
+            previous = NO_BLOCK;
+        }
+
+        const std::uint16_t current = previous != NO_BLOCK
+                                          ? followBlockLink(previous, state_.programCounter)
+                                          : findOrTranslateBlock(state_.programCounter);
+        const TranslatedBlock& block = blocks_[current];
+        const std::uint32_t length = std::min<std::uint32_t>(block.codeLength, count - executed);
+
+        for (std::uint32_t i = 0; i < length;) {
+            // The block's first instruction was checked by the loop condition
+            if (i > 0 && hasBreakpoints_ && breakpoints_.test(state_.programCounter)) {
+                raiseStop(STOP_BREAKPOINT);
+                return executed;
+            }
+
+            // A superinstruction retires all its parts here. Those ending in
+            // an instruction endsBlock() stops at close the block. The others
+            // (6XNN 6XNN, ANNN DXYN) continue at the instruction after them,
+            // or past the end of a block cut at MAX_BLOCK_LENGTH, where the
+            // next block is looked up from the PC.
+            const DecodedInstruction& instr = blockCode_[block.codeOffset + i];
+            state_.opcode = instr.opcode;
+            if (instr.fused != instr.operation && executed < fusionLimit_) {
+                const std::uint32_t retired = executeFused(instr, count - executed);
+                executed += retired;
+                i += retired;
+            } else {
+                execute(instr);
+                updateTimers();
+                ++executed;
+                ++i;
+            }
+
+            if (pendingStops_ != 0) {
+                return executed;
+            }
+        }
+
+        previous = current;
+    }
+    return executed;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::endsBlock(Operation operation) {
+    switch (operation) {
+        case Operation::Op00EE:
+        case Operation::Op1NNN:
+        case Operation::Op2NNN:
+        case Operation::Op3XNN:
+        case Operation::Op4XNN:
+        case Operation::Op5XY0:
+        case Operation::Op9XY0:
+        case Operation::OpBNNN:
+        case Operation::OpEX9E:
+        case Operation::OpEXA1:
+        case Operation::OpFX0A:
+        case Operation::OpFX33:
+        case Operation::OpFX55:
+        case Operation::Op00FD:
+        case Operation::Op5XY2:
+        case Operation::Unknown:
+            return true;
+        default:
+            return false;
+    }
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint16_t BasicChip8<Policy, Quirks, Rng>::findOrTranslateBlock(std::uint16_t address) {
+    const std::uint16_t block = blockLookup_[address];
+    if (block != NO_BLOCK) {
+        return block;
+    }
+    return translateBlock(address);
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint16_t BasicChip8<Policy, Quirks, Rng>::translateBlock(std::uint16_t address) {
+    TranslatedBlock block{};
+    block.startAddress = address;
+    block.codeOffset = static_cast<std::uint32_t>(blockCode_.size());
+    block.valid = true;
+    block.links.fill(BlockLink{0, NO_BLOCK});
+
+    std::uint32_t pc = address;
+    while (pc < MEMORY_SIZE - 1 && block.codeLength < MAX_BLOCK_LENGTH) {
+        const DecodedInstruction& instr = fetchDecoded(static_cast<std::uint16_t>(pc));
+        blockCode_.push_back(instr);
+        ++block.codeLength;
+        pc += instr.operation == Operation::OpF000 ? 4 : 2;
+        if (endsBlock(instr.operation)) {
+            break;
+        }
+    }
+    block.endAddress = pc;
+
+    for (std::uint32_t i = address; i < pc; ++i) {
+        translatedBytes_.set(i);
+    }
+
+    const auto id = static_cast<std::uint16_t>(blocks_.size());
+    blocks_.push_back(block);
+    blockLookup_[address] = id;
+    return id;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint16_t BasicChip8<Policy, Quirks, Rng>::followBlockLink(std::uint16_t from,
+                                                               std::uint16_t address) {
+    for (const BlockLink& link : blocks_[from].links) {
+        if (link.target == address && link.block != NO_BLOCK) {
+            const TranslatedBlock& next = blocks_[link.block];
+            if (next.valid && next.startAddress == address) {
+                return link.block;
+            }
+        }
+    }
+
+    const std::uint16_t next = findOrTranslateBlock(address);
+    TranslatedBlock& block = blocks_[from];
+    block.links[block.nextLink] = BlockLink{address, next};
+    block.nextLink ^= 1;
+    return next;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::flushTranslatedBlocks() {
+    blocks_.clear();
+    blockCode_.clear();
+    blockLookup_.fill(NO_BLOCK);
+    translatedBytes_.reset();
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::invalidateTranslatedBlocks(std::uint32_t first,
+                                                                 std::uint32_t last) {
+    bool translated = false;
+    for (std::uint32_t i = first; i < last; ++i) {
+        translated = translated || translatedBytes_[i];
+    }
+    if (!translated) {
+        return;
+    }
+
+    for (TranslatedBlock& block : blocks_) {
+        if (block.valid && block.startAddress < last && block.endAddress > first) {
+            block.valid = false;
+            blockLookup_[block.startAddress] = NO_BLOCK;
+        }
+    }
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::runCompiled(std::uint32_t count) {
+    std::uint32_t executed = 0;
+    while (executed < count && readyToExecute(executed)) {
+        const std::uint32_t compiled = compiledRom_->run(*this, count - executed);
+        executed += compiled;
+        if (pendingStops_ != 0) {
+            break;
+        }
+        if (compiled > 0) {
+            continue;
+        }
+
+        // Nothing compiled at the PC, or the block needs more cycles than are left
+        const DecodedInstruction& instr = fetchDecoded(state_.programCounter);
+        state_.opcode = instr.opcode;
+        execute(instr);
+        updateTimers();
+        ++executed;
+
+        if (pendingStops_ != 0) {
+            break;
+        }
+    }
+    return executed;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::invalidateCompiledBlocks(std::uint32_t first,
+                                                        std::uint32_t last) {
+    if (compiledRom_ == nullptr) {
+        return;
+    }
+    bool compiled = false;
+    for (std::uint32_t i = first; i < last; ++i) {
+        compiled = compiled || compiledBytes_[i];
+    }
+    if (!compiled) {
+        return;
+    }
+
+    for (std::uint16_t i = 0; i < compiledRom_->blockCount; ++i) {
+        const std::uint16_t start = compiledRom_->blocks[2 * i];
+        const std::uint16_t end = compiledRom_->blocks[2 * i + 1];
+        if (start < last && end > first) {
+            compiledValid_.reset(start);
+        }
+    }
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::emulateCycle() {
+    clearError();
+
+    // Bounds check for program counter
+    if (state_.programCounter >= MEMORY_SIZE - 1) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::ProgramCounterBounds,
+                 state_.programCounter);
+        return;
+    }
+
+    // Fetch and decode opcode (served from the decode cache when possible)
+    const DecodedInstruction& instr = fetchDecoded(state_.programCounter);
+    state_.opcode = instr.opcode;
+
+    // Execute opcode
+    execute(instr);
+
+    updateTimers();
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+Chip8Base::RunResult BasicChip8<Policy, Quirks, Rng>::runCycles(std::uint32_t count) {
+    return run(count, STOP_ERROR | STOP_KEY_WAIT | STOP_BREAKPOINT);
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+Chip8Base::RunResult BasicChip8<Policy, Quirks, Rng>::runUntilDraw(std::uint32_t maxCycles) {
+    return run(maxCycles, STOP_ERROR | STOP_DRAW | STOP_KEY_WAIT | STOP_BREAKPOINT);
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+Chip8Base::RunResult BasicChip8<Policy, Quirks, Rng>::runCyclesThroughKeyWaits(
+    std::uint32_t count) {
+    return run(count, STOP_ERROR | STOP_BREAKPOINT);
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+Chip8Base::RunResult BasicChip8<Policy, Quirks, Rng>::runFrame() {
+    return runCycles(cyclesPerFrame_);
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setCyclesPerFrame(std::uint32_t cycles) {
+    cyclesPerFrame_ = cycles;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::getCyclesPerFrame() const { return cyclesPerFrame_; }
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setCpuFrequency(std::uint32_t hz) {
+    cpuFrequency_ = hz == 0 ? 0 : std::max(hz, TIMER_FREQUENCY);
+    timerStep_ = hz == 0 ? 0 : TIMER_FREQUENCY;
+    timerPeriod_ = hz == 0 ? 1 : cpuFrequency_;
+    state_.timerPhase = 0;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::getCpuFrequency() const { return cpuFrequency_; }
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::tickTimers() { applyTimerTicks(1); }
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setRandomSeed(std::uint64_t seed) {
+    state_.random.seed(seed);
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+Chip8Base::Backend BasicChip8<Policy, Quirks, Rng>::getBackend() const { return backend_; }
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::addBreakpoint(std::uint16_t address) {
+    if (!isValidMemoryAddress(address)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::BreakpointAddress, address);
+        return;
+    }
+    breakpoints_.set(address);
+    hasBreakpoints_ = true;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::removeBreakpoint(std::uint16_t address) {
+    if (!isValidMemoryAddress(address)) {
+        return;
+    }
+    breakpoints_.reset(address);
+    hasBreakpoints_ = breakpoints_.any();
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::clearBreakpoints() {
+    breakpoints_.reset();
+    hasBreakpoints_ = false;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setFusionEnabled(bool enabled) { fusionEnabled_ = enabled; }
+
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::isFusionEnabled() const { return fusionEnabled_; }
+
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::attachCompiledRom(const CompiledRom& rom) {
+    if (rom.imageSize > MEMORY_SIZE - ROM_START_ADDRESS ||
+        !std::equal(rom.image, rom.image + rom.imageSize,
+                    state_.memory.begin() + ROM_START_ADDRESS)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::CompiledRomMismatch);
+        return false;
+    }
+
+    compiledRom_ = &rom;
+    compiledValid_.reset();
+    compiledBytes_.reset();
+    for (std::uint16_t i = 0; i < rom.blockCount; ++i) {
+        const std::uint16_t start = rom.blocks[2 * i];
+        const std::uint16_t end = rom.blocks[2 * i + 1];
+        compiledValid_.set(start);
+        for (std::uint32_t address = start; address < end; ++address) {
+            compiledBytes_.set(address);
+        }
+    }
+    return true;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::detachCompiledRom() {
+    compiledRom_ = nullptr;
+    compiledValid_.reset();
+    compiledBytes_.reset();
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::hasCompiledRom() const { return compiledRom_ != nullptr; }
+
+// Public accessor methods
+template <typename Policy, typename Quirks, typename Rng>
+const std::array<std::uint8_t, Chip8Base::FRAME_BUFFER_SIZE>&
+BasicChip8<Policy, Quirks, Rng>::getFrameBuffer() const {
+    if (frameBufferViewStale_) {
+        const std::uint16_t width = getDisplayWidth();
+        const std::uint16_t height = getDisplayHeight();
+        frameBufferView_.fill(0);
+        for (std::uint16_t y = 0; y < height; ++y) {
+            std::uint8_t* line = &frameBufferView_[y * width];
+            for (std::uint16_t x = 0; x < width; ++x) {
+                line[x] = getPixel(x, y);
+            }
+        }
+        frameBufferViewStale_ = false;
+    }
+    return frameBufferView_;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+const Chip8Base::DisplayPlane& BasicChip8<Policy, Quirks, Rng>::getDisplayPlane(
+    std::uint8_t plane) const {
+    return state_.displayPlanes[plane % PLANE_COUNT];
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::isHighResolution() const { return state_.highResolution; }
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint16_t BasicChip8<Policy, Quirks, Rng>::getDisplayWidth() const {
+    return state_.highResolution ? HIRES_DISPLAY_WIDTH : DISPLAY_WIDTH;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint16_t BasicChip8<Policy, Quirks, Rng>::getDisplayHeight() const {
+    return state_.highResolution ? HIRES_DISPLAY_HEIGHT : DISPLAY_HEIGHT;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setPixel(std::uint16_t x, std::uint16_t y,
+                                        std::uint8_t value) {
+    if (x >= getDisplayWidth() || y >= getDisplayHeight()) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::PixelCoordinates, x, y);
+        return;
+    }
+    for (std::uint8_t plane = 0; plane < PLANE_COUNT; ++plane) {
+        std::uint64_t& word = state_.displayPlanes[plane][displayWord(x, y)];
+        if ((value >> plane & 1) != 0) {
+            word |= displayBit(x);
+        } else {
+            word &= ~displayBit(x);
+        }
+    }
+    dirtyRows_ |= RowMask{1} << y;
+    frameBufferViewStale_ = true;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint8_t BasicChip8<Policy, Quirks, Rng>::getPixel(std::uint16_t x, std::uint16_t y) const {
+    if (x >= getDisplayWidth() || y >= getDisplayHeight()) {
+        return 0;
+    }
+    std::uint8_t value = 0;
+    for (std::uint8_t plane = 0; plane < PLANE_COUNT; ++plane) {
+        if ((state_.displayPlanes[plane][displayWord(x, y)] & displayBit(x)) != 0) {
+            value |= 1 << plane;
+        }
+    }
+    return value;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint8_t BasicChip8<Policy, Quirks, Rng>::getSelectedPlanes() const { return selectedPlanes(); }
+
+template <typename Policy, typename Quirks, typename Rng>
+Chip8Base::RowMask BasicChip8<Policy, Quirks, Rng>::getDirtyRows() const { return dirtyRows_; }
+
+template <typename Policy, typename Quirks, typename Rng>
+Chip8Base::RowRanges BasicChip8<Policy, Quirks, Rng>::getDirtyRowRanges() const {
+    RowRanges ranges{};
+    const std::uint16_t height = getDisplayHeight();
+    std::uint16_t row = 0;
+    while (row < height) {
+        if ((dirtyRows_ >> row & 1) == 0) {
+            ++row;
+            continue;
+        }
+        const std::uint16_t first = row;
+        while (row < height && (dirtyRows_ >> row & 1) != 0) {
+            ++row;
+        }
+        ranges.ranges[ranges.size++] = {first, static_cast<std::uint16_t>(row - first)};
+    }
+    return ranges;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::acknowledgeDirtyRows() { dirtyRows_ = 0; }
+
+template <typename Policy, typename Quirks, typename Rng>
+const std::array<std::uint8_t, Chip8Base::AUDIO_PATTERN_SIZE>&
+BasicChip8<Policy, Quirks, Rng>::getAudioPattern() const {
+    return state_.audioPattern;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint8_t BasicChip8<Policy, Quirks, Rng>::getAudioPitch() const { return state_.audioPitch; }
+
+template <typename Policy, typename Quirks, typename Rng>
+double BasicChip8<Policy, Quirks, Rng>::getAudioSampleRate() const {
+    // 4000 Hz at the default pitch, one octave per 48 steps
+    return 4000.0 * std::exp2((state_.audioPitch - DEFAULT_AUDIO_PITCH) / 48.0);
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setKeyState(std::uint8_t key, bool pressed) {
+    if (key >= KEYBOARD_SIZE) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::KeyIndex, key);
+        return;
+    }
+    state_.keyboard[key] = pressed ? 1 : 0;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::isKeyPressed(std::uint8_t key) const {
+    if (key >= KEYBOARD_SIZE) {
+        return false;
+    }
+    return state_.keyboard[key] != 0;
+}
+
+// Setters (updated with bounds checking)
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setMemory(std::uint16_t address, std::uint8_t value) {
+    if (!isValidMemoryAddress(address)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::MemoryAddress, address);
+        return;
+    }
+    clearError();  // Clear error on successful operation
+    state_.memory[address] = value;
+    invalidateDecoded(address, 1);
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setProgramCounter(std::uint16_t address) {
+    if (!isValidMemoryAddress(address)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::ProgramCounterAddress, address);
+        return;
+    }
+    state_.programCounter = address;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setStack(std::uint8_t subroutine, std::uint16_t address) {
+    if (subroutine >= STACK_SIZE) {
+        setError(ErrorCode::StackOverflow, ErrorSite::StackIndex, subroutine);
+        return;
+    }
+    clearError();  // Clear error on successful operation
+    state_.stack[subroutine] = address;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setStackPointer(std::uint8_t subroutine) {
+    if (subroutine > STACK_SIZE) {
+        setError(ErrorCode::StackOverflow, ErrorSite::StackPointer, subroutine);
+        return;
+    }
+    clearError();  // Clear error on successful operation
+    state_.stackPointer = subroutine;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setRegisterAt(std::uint8_t reg, std::uint8_t value) {
+    if (!isValidRegisterIndex(reg)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, reg);
+        return;
+    }
+    clearError();  // Clear error on successful operation
+    state_.registers[reg] = value;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setDelayTimer(std::uint8_t value) {
+    state_.delayTimer = value;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setDrawFlag(bool condition) { state_.drawFlag = condition; }
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setIndexRegister(std::uint16_t value) {
+    state_.indexRegister = value;
+}
+
+// Getters (updated with bounds checking)
+template <typename Policy, typename Quirks, typename Rng>
+std::uint8_t BasicChip8<Policy, Quirks, Rng>::getMemoryAt(std::uint16_t address) const {
+    if (!isValidMemoryAddress(address)) {
+        return 0;
+    }
+    return state_.memory[address];
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint16_t BasicChip8<Policy, Quirks, Rng>::getIndexRegister() const {
+    return state_.indexRegister;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint16_t BasicChip8<Policy, Quirks, Rng>::getProgramCounter() const {
+    return state_.programCounter;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint16_t BasicChip8<Policy, Quirks, Rng>::getStackAt(std::uint8_t subroutine) const {
+    if (subroutine >= STACK_SIZE) {
+        return 0;
+    }
+    return state_.stack[subroutine];
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint8_t BasicChip8<Policy, Quirks, Rng>::getStackPointer() const {
+    return state_.stackPointer;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint8_t BasicChip8<Policy, Quirks, Rng>::getRegisterAt(std::uint8_t reg) const {
+    if (!isValidRegisterIndex(reg)) {
+        return 0;
+    }
+    return state_.registers[reg];
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint8_t BasicChip8<Policy, Quirks, Rng>::getDelayTimer() const { return state_.delayTimer; }
+
+template <typename Policy, typename Quirks, typename Rng>
+std::uint8_t BasicChip8<Policy, Quirks, Rng>::getSoundTimer() const { return state_.soundTimer; }
+
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::getDrawFlag() const { return state_.drawFlag; }
+
+// Error handling methods
+template <typename Policy, typename Quirks, typename Rng>
+Chip8Base::ErrorCode BasicChip8<Policy, Quirks, Rng>::getLastError() const {
+    return lastError_.code;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+const std::string& BasicChip8<Policy, Quirks, Rng>::getLastErrorMessage() const {
+    lastErrorMessage_ = formatErrorMessage(lastError_, romPath_);
+    return lastErrorMessage_;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+const Chip8Base::ErrorRecord& BasicChip8<Policy, Quirks, Rng>::getLastErrorRecord() const {
+    return lastError_;
+}
+
+// Logging
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setLogger(Logger& logger) { logger_ = &logger; }
+
+template <typename Policy, typename Quirks, typename Rng>
+Logger& BasicChip8<Policy, Quirks, Rng>::getLogger() const { return *logger_; }
+
+// Snapshots
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::saveState(MachineState& state) const {
+    state = state_;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::loadState(const MachineState& state) {
+    // Code only has to be decoded again where memory changes; a snapshot of
+    // the running program usually differs in a few data bytes at most
+    constexpr std::uint32_t CHUNK = 64;
+    for (std::uint32_t address = 0; address < MEMORY_SIZE; address += CHUNK) {
+        if (std::memcmp(&state_.memory[address], &state.memory[address], CHUNK) != 0) {
+            invalidateDecoded(static_cast<std::uint16_t>(address), CHUNK);
+        }
+    }
+    state_ = state;
+    dirtyRows_ = visibleRows();
+    frameBufferViewStale_ = true;
+    clearError();
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+std::vector<std::uint8_t> BasicChip8<Policy, Quirks, Rng>::serializeState() const {
+    std::vector<std::uint8_t> data;
+    data.reserve(sizeof(MachineState) + 16);
+    StateWriter writer(data);
+    writer.put(STATE_MAGIC);
+    writer.put(STATE_VERSION);
+    writer.put(MEMORY_SIZE);
+    const auto write = [&writer](const auto& field) { writer.put(field); };
+    visitState(state_, write, STATE_VERSION);
+    return data;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::deserializeState(const std::vector<std::uint8_t>& data) {
+    StateReader reader(data);
+    std::uint32_t magic = 0;
+    std::uint16_t version = 0;
+    std::uint32_t memorySize = 0;
+    reader.get(magic);
+    reader.get(version);
+    reader.get(memorySize);
+    if (magic != STATE_MAGIC || version == 0 || version > STATE_VERSION ||
+        memorySize != MEMORY_SIZE) {
+        return false;
+    }
+
+    // Fields the version lacks keep their current values
+    auto state = std::make_unique<MachineState>(state_);
+    const auto read = [&reader](auto& field) { reader.get(field); };
+    visitState(*state, read, version);
+    if (!reader.finished() || state->stackPointer > STACK_SIZE || state->planes > ALL_PLANES) {
+        return false;
+    }
+    loadState(*state);
+    return true;
+}
+
+// Opcode handler implementations
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode00E0(const DecodedInstruction&) {
+    // 0x00E0 - Clear screen (the selected planes)
+    scrollDisplay([](DisplayPlane& plane) { plane.fill(0); });
+    state_.programCounter += 2;
+}
+
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode00EE(const DecodedInstruction&) {
+    // 0x00EE - Return from subroutine
+    if (state_.stackPointer == 0) {
+        setError(ErrorCode::StackUnderflow, ErrorSite::Return);
+        return;
     }
+    state_.stackPointer--;
+    state_.programCounter = state_.stack[state_.stackPointer];
+    state_.programCounter += 2;
+}
 
-    // Update timers
-    if (delayTimer_ > 0) {
-        --delayTimer_;
-    }
-    if (soundTimer_ > 0) {
-        if (soundTimer_ == 1) {
-            logInfo("BEEP! Sound timer expired");
-        }
-        --soundTimer_;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode1NNN(const DecodedInstruction& instr) {
+    // 0x1NNN - Jump to address NNN
+    if (!isAddressInRange(instr.nnn)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::JumpAddress, instr.nnn);
+        return;
     }
+    state_.programCounter = instr.nnn;
 }
 
-// Public accessor methods
-const std::array<std::uint8_t, Chip8::DISPLAY_SIZE>& Chip8::getFrameBuffer() const {
-    return frameBuffer_;
-}
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode2NNN(const DecodedInstruction& instr) {
+    // 0x2NNN - Call subroutine at NNN
+    if (state_.stackPointer >= STACK_SIZE) {
+        setError(ErrorCode::StackOverflow, ErrorSite::Call);
+        state_.programCounter += 2;  // Advance PC even on error to prevent infinite loop
+        return;
+    }
 
-void Chip8::setPixel(std::uint16_t x, std::uint16_t y, std::uint8_t value) {
-    if (x >= DISPLAY_WIDTH || y >= DISPLAY_HEIGHT) {
-        setError(ErrorCode::InvalidMemoryAccess, "Pixel coordinates out of bounds: (" +
-                                                     std::to_string(x) + ", " + std::to_string(y) +
-                                                     ")");
+    if (!isAddressInRange(instr.nnn)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::CallAddress, instr.nnn);
+        state_.programCounter += 2;  // Advance PC even on error to prevent infinite loop
         return;
     }
-    frameBuffer_[y * DISPLAY_WIDTH + x] = value;
+
+    state_.stack[state_.stackPointer] = state_.programCounter;
+    state_.stackPointer++;
+    state_.programCounter = instr.nnn;
 }
 
-std::uint8_t Chip8::getPixel(std::uint16_t x, std::uint16_t y) const {
-    if (x >= DISPLAY_WIDTH || y >= DISPLAY_HEIGHT) {
-        return 0;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode3XNN(const DecodedInstruction& instr) {
+    // 0x3XNN - Skip next instruction if VX equals NN
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
+        return;
+    }
+
+    if (state_.registers[instr.x] == instr.nn) {
+        state_.programCounter += skipDistance();
+    } else {
+        state_.programCounter += 2;
     }
-    return frameBuffer_[y * DISPLAY_WIDTH + x];
 }
 
-void Chip8::setKeyState(std::uint8_t key, bool pressed) {
-    if (key >= KEYBOARD_SIZE) {
-        setError(ErrorCode::InvalidRegisterAccess, "Invalid key index: " + std::to_string(key));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode4XNN(const DecodedInstruction& instr) {
+    // 0x4XNN - Skip next instruction if VX doesn't equal NN
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
         return;
     }
-    keyboard_[key] = pressed ? 1 : 0;
+
+    if (state_.registers[instr.x] != instr.nn) {
+        state_.programCounter += skipDistance();
+    } else {
+        state_.programCounter += 2;
+    }
 }
 
-bool Chip8::isKeyPressed(std::uint8_t key) const {
-    if (key >= KEYBOARD_SIZE) {
-        return false;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode5XY0(const DecodedInstruction& instr) {
+    // 0x5XY0 - Skip next instruction if VX equals VY
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
+        return;
+    }
+
+    if (state_.registers[instr.x] == state_.registers[instr.y]) {
+        state_.programCounter += skipDistance();
+    } else {
+        state_.programCounter += 2;
     }
-    return keyboard_[key] != 0;
 }
 
-// Setters (updated with bounds checking)
-void Chip8::setMemory(std::uint16_t address, std::uint8_t value) {
-    if (!isValidMemoryAddress(address)) {
-        setError(ErrorCode::InvalidMemoryAccess, "Invalid memory address: " + formatHex(address));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode6XNN(const DecodedInstruction& instr) {
+    // 0x6XNN - Set VX to NN
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
         return;
     }
-    clearError();  // Clear error on successful operation
-    memory_[address] = value;
+
+    state_.registers[instr.x] = instr.nn;
+    state_.programCounter += 2;
 }
 
-void Chip8::setProgramCounter(std::uint16_t address) {
-    if (!isValidMemoryAddress(address)) {
-        setError(ErrorCode::InvalidMemoryAccess,
-                 "Invalid program counter address: " + std::to_string(address));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode7XNN(const DecodedInstruction& instr) {
+    // 0x7XNN - Add NN to VX
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
         return;
     }
-    programCounter_ = address;
+
+    state_.registers[instr.x] += instr.nn;
+    state_.programCounter += 2;
 }
 
-void Chip8::setStack(std::uint8_t subroutine, std::uint16_t address) {
-    if (subroutine >= STACK_SIZE) {
-        setError(ErrorCode::StackOverflow,
-                 "Stack index out of bounds: " + std::to_string(subroutine));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode8XY0(const DecodedInstruction& instr) {
+    // 0x8XY0 - Set VX to VY
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
         return;
     }
-    clearError();  // Clear error on successful operation
-    stack_[subroutine] = address;
+
+    state_.registers[instr.x] = state_.registers[instr.y];
+    state_.programCounter += 2;
 }
 
-void Chip8::setStackPointer(std::uint8_t subroutine) {
-    if (subroutine > STACK_SIZE) {
-        setError(ErrorCode::StackOverflow,
-                 "Stack pointer out of bounds: " + std::to_string(subroutine));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode8XY1(const DecodedInstruction& instr) {
+    // 0x8XY1 - Set VX to VX OR VY
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
         return;
     }
-    clearError();  // Clear error on successful operation
-    stackPointer_ = subroutine;
+
+    state_.registers[instr.x] |= state_.registers[instr.y];
+    if constexpr (Quirks::LOGIC_RESETS_VF) {
+        state_.registers[0xF] = 0;
+    }
+    state_.programCounter += 2;
 }
 
-void Chip8::setRegisterAt(std::uint8_t reg, std::uint8_t value) {
-    if (!isValidRegisterIndex(reg)) {
-        setError(ErrorCode::InvalidRegisterAccess,
-                 "Invalid register index: " + std::to_string(reg));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode8XY2(const DecodedInstruction& instr) {
+    // 0x8XY2 - Set VX to VX AND VY
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
         return;
     }
-    clearError();  // Clear error on successful operation
-    registers_[reg] = value;
+
+    state_.registers[instr.x] &= state_.registers[instr.y];
+    if constexpr (Quirks::LOGIC_RESETS_VF) {
+        state_.registers[0xF] = 0;
+    }
+    state_.programCounter += 2;
 }
 
-void Chip8::setDelayTimer(std::uint8_t value) { delayTimer_ = value; }
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode8XY3(const DecodedInstruction& instr) {
+    // 0x8XY3 - Set VX to VX XOR VY
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
+        return;
+    }
 
-void Chip8::setDrawFlag(bool condition) { drawFlag_ = condition; }
+    state_.registers[instr.x] ^= state_.registers[instr.y];
+    if constexpr (Quirks::LOGIC_RESETS_VF) {
+        state_.registers[0xF] = 0;
+    }
+    state_.programCounter += 2;
+}
 
-void Chip8::setIndexRegister(std::uint16_t value) { indexRegister_ = value; }
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode8XY4(const DecodedInstruction& instr) {
+    // 0x8XY4 - Add VY to VX, VF = carry
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
+        return;
+    }
 
-// Getters (updated with bounds checking)
-std::uint8_t Chip8::getMemoryAt(std::uint16_t address) const {
-    if (!isValidMemoryAddress(address)) {
-        return 0;
+    if (state_.registers[instr.y] > 0xFF - state_.registers[instr.x]) {
+        state_.registers[0xF] = 1;  // Carry
+    } else {
+        state_.registers[0xF] = 0;
     }
-    return memory_[address];
+    state_.registers[instr.x] += state_.registers[instr.y];
+    state_.programCounter += 2;
 }
 
-std::uint16_t Chip8::getIndexRegister() const { return indexRegister_; }
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode8XY5(const DecodedInstruction& instr) {
+    // 0x8XY5 - Subtract VY from VX, VF = NOT borrow
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
+        return;
+    }
 
-std::uint16_t Chip8::getProgramCounter() const { return programCounter_; }
+    if (state_.registers[instr.x] >= state_.registers[instr.y]) {
+        state_.registers[0xF] = 1;  // NOT borrow
+    } else {
+        state_.registers[0xF] = 0;
+    }
+    state_.registers[instr.x] -= state_.registers[instr.y];
+    state_.programCounter += 2;
+}
 
-std::uint16_t Chip8::getStackAt(std::uint8_t subroutine) const {
-    if (subroutine >= STACK_SIZE) {
-        return 0;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode8XY6(const DecodedInstruction& instr) {
+    // 0x8XY6 - Shift VX (or VY, by quirk) right by one into VX, VF = LSB
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
+        return;
     }
-    return stack_[subroutine];
+
+    const std::uint8_t value = state_.registers[Quirks::SHIFT_USES_VY ? instr.y : instr.x];
+    state_.registers[0xF] = value & 1;
+    state_.registers[instr.x] = value >> 1;
+    state_.programCounter += 2;
 }
 
-std::uint8_t Chip8::getStackPointer() const { return stackPointer_; }
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode8XY7(const DecodedInstruction& instr) {
+    // 0x8XY7 - Set VX to VY - VX, VF = NOT borrow
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
+        return;
+    }
 
-std::uint8_t Chip8::getRegisterAt(std::uint8_t reg) const {
-    if (!isValidRegisterIndex(reg)) {
-        return 0;
+    if (state_.registers[instr.y] >= state_.registers[instr.x]) {
+        state_.registers[0xF] = 1;  // NOT borrow
+    } else {
+        state_.registers[0xF] = 0;
     }
-    return registers_[reg];
+    state_.registers[instr.x] = state_.registers[instr.y] - state_.registers[instr.x];
+    state_.programCounter += 2;
 }
 
-std::uint8_t Chip8::getDelayTimer() const { return delayTimer_; }
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode8XYE(const DecodedInstruction& instr) {
+    // 0x8XYE - Shift VX (or VY, by quirk) left by one into VX, VF = MSB
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
+        return;
+    }
 
-std::uint8_t Chip8::getSoundTimer() const { return soundTimer_; }
+    const std::uint8_t value = state_.registers[Quirks::SHIFT_USES_VY ? instr.y : instr.x];
+    state_.registers[0xF] = value >> 7;
+    state_.registers[instr.x] = static_cast<std::uint8_t>(value << 1);
+    state_.programCounter += 2;
+}
 
-bool Chip8::getDrawFlag() const { return drawFlag_; }
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode9XY0(const DecodedInstruction& instr) {
+    // 0x9XY0 - Skip next instruction if VX doesn't equal VY
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
+        return;
+    }
 
-// Error handling methods
-Chip8::ErrorCode Chip8::getLastError() const { return lastError_; }
+    if (state_.registers[instr.x] != state_.registers[instr.y]) {
+        state_.programCounter += skipDistance();
+    } else {
+        state_.programCounter += 2;
+    }
+}
 
-const std::string& Chip8::getLastErrorMessage() const { return lastErrorMessage_; }
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeANNN(const DecodedInstruction& instr) {
+    // 0xANNN - Set I to address NNN
+    if (!isAddressInRange(instr.nnn)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::IndexRegisterAddress, instr.nnn);
+        return;
+    }
 
-// Opcode handler implementations
-void Chip8::handleOpcode0xxx() {
-    switch (opcode_ & 0x000F) {
-        case 0x0000:  // 0x00E0 - Clear screen
-            frameBuffer_.fill(0);
-            drawFlag_ = true;
-            programCounter_ += 2;
-            break;
-
-        case 0x000E:  // 0x00EE - Return from subroutine
-            if (stackPointer_ == 0) {
-                setError(ErrorCode::StackUnderflow, "Stack underflow on return");
-                return;
-            }
-            stackPointer_--;
-            programCounter_ = stack_[stackPointer_];
-            programCounter_ += 2;
-            break;
+    state_.indexRegister = instr.nnn;
+    state_.programCounter += 2;
+}
 
-        default:
-            setError(ErrorCode::UnknownOpcode,
-                     "Unknown 0x0xxx opcode: 0x" + std::to_string(opcode_));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeBNNN(const DecodedInstruction& instr) {
+    // 0xBNNN - Jump to address NNN + V0 (BXNN: XNN + VX, by quirk)
+    const std::uint8_t offset = state_.registers[Quirks::JUMP_USES_VX ? instr.x : 0];
+    const std::uint16_t address = memoryIndex(offset + instr.nnn);
+    if (!isAddressInRange(address)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::ComputedJumpAddress, address);
+        return;
     }
+
+    state_.programCounter = address;
 }
 
-void Chip8::handleOpcode1xxx() {
-    // 0x1NNN - Jump to address NNN
-    std::uint16_t address = opcode_ & 0x0FFF;
-    if (!isValidMemoryAddress(address)) {
-        setError(ErrorCode::InvalidMemoryAccess,
-                 "Invalid jump address: " + std::to_string(address));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeCXNN(const DecodedInstruction& instr) {
+    // 0xCXNN - Set VX to random number AND NN
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
         return;
     }
-    programCounter_ = address;
+
+    // The top byte, which is the best mixed in every generator provided
+    const auto randomNumber = static_cast<std::uint8_t>(state_.random() >> 24);
+    state_.registers[instr.x] = randomNumber & instr.nn;
+    state_.programCounter += 2;
 }
 
-void Chip8::handleOpcode2xxx() {
-    // 0x2NNN - Call subroutine at NNN
-    if (stackPointer_ >= STACK_SIZE) {
-        setError(ErrorCode::StackOverflow, "Stack overflow on subroutine call");
-        programCounter_ += 2;  // Advance PC even on error to prevent infinite loop
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeDXYN(const DecodedInstruction& instr) {
+    // 0xDXYN - Draw sprite at (VX, VY) with height N
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
         return;
     }
 
-    std::uint16_t address = opcode_ & 0x0FFF;
-    if (!isValidMemoryAddress(address)) {
-        setError(ErrorCode::InvalidMemoryAccess, "Invalid call address: " + formatHex(address));
-        programCounter_ += 2;  // Advance PC even on error to prevent infinite loop
+    // DXY0 draws a 16x16 sprite under SUPER-CHIP, in either resolution, and
+    // no rows on the classic profiles
+    const bool drawn = Quirks::SUPER_CHIP && instr.n == 0 ? drawSprite<16>(instr, 16)
+                                                          : drawSprite<8>(instr, instr.n);
+    if (!drawn) {
         return;
     }
 
-    stack_[stackPointer_] = programCounter_;
-    stackPointer_++;
-    programCounter_ = address;
+    displayChanged();
+    state_.programCounter += 2;
 }
 
-void Chip8::handleOpcode3xxx() {
-    // 0x3XNN - Skip next instruction if VX equals NN
-    std::uint8_t x = (opcode_ & 0x0F00) >> 8;
-    std::uint8_t nn = opcode_ & 0x00FF;
-
-    if (!isValidRegisterIndex(x)) {
-        setError(ErrorCode::InvalidRegisterAccess, "Invalid register index: " + std::to_string(x));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeEX9E(const DecodedInstruction& instr) {
+    // 0xEX9E - Skip if key VX is pressed
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
         return;
     }
 
-    if (registers_[x] == nn) {
-        programCounter_ += 4;
+    if (state_.registers[instr.x] < KEYBOARD_SIZE &&
+        state_.keyboard[state_.registers[instr.x]] != 0) {
+        state_.programCounter += skipDistance();
     } else {
-        programCounter_ += 2;
+        state_.programCounter += 2;
     }
 }
 
-void Chip8::handleOpcode4xxx() {
-    // 0x4XNN - Skip next instruction if VX doesn't equal NN
-    std::uint8_t x = (opcode_ & 0x0F00) >> 8;
-    std::uint8_t nn = opcode_ & 0x00FF;
-
-    if (!isValidRegisterIndex(x)) {
-        setError(ErrorCode::InvalidRegisterAccess, "Invalid register index: " + std::to_string(x));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeEXA1(const DecodedInstruction& instr) {
+    // 0xEXA1 - Skip if key VX is not pressed
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
         return;
     }
 
-    if (registers_[x] != nn) {
-        programCounter_ += 4;
+    if (state_.registers[instr.x] >= KEYBOARD_SIZE ||
+        state_.keyboard[state_.registers[instr.x]] == 0) {
+        state_.programCounter += skipDistance();
     } else {
-        programCounter_ += 2;
+        state_.programCounter += 2;
     }
 }
 
-void Chip8::handleOpcode5xxx() {
-    // 0x5XY0 - Skip next instruction if VX equals VY
-    std::uint8_t x = (opcode_ & 0x0F00) >> 8;
-    std::uint8_t y = (opcode_ & 0x00F0) >> 4;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX07(const DecodedInstruction& instr) {
+    // 0xFX07 - Set VX to delay timer
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
+        return;
+    }
+
+    state_.registers[instr.x] = state_.delayTimer;
+    state_.programCounter += 2;
+}
 
-    if (!isValidRegisterIndex(x) || !isValidRegisterIndex(y)) {
-        setError(ErrorCode::InvalidRegisterAccess,
-                 "Invalid register indices: " + std::to_string(x) + ", " + std::to_string(y));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX0A(const DecodedInstruction& instr) {
+    // 0xFX0A - Wait for key press
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
         return;
     }
 
-    if (registers_[x] == registers_[y]) {
-        programCounter_ += 4;
-    } else {
-        programCounter_ += 2;
+    for (std::uint8_t i = 0; i < KEYBOARD_SIZE; ++i) {
+        if (state_.keyboard[i] != 0) {
+            state_.registers[instr.x] = i;
+            state_.programCounter += 2;
+            return;
+        }
     }
+    // Don't increment PC, wait for key
+    raiseStop(STOP_KEY_WAIT);
 }
 
-void Chip8::handleOpcode6xxx() {
-    // 0x6XNN - Set VX to NN
-    std::uint8_t x = (opcode_ & 0x0F00) >> 8;
-    std::uint8_t nn = opcode_ & 0x00FF;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX15(const DecodedInstruction& instr) {
+    // 0xFX15 - Set delay timer to VX
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
+        return;
+    }
+
+    state_.delayTimer = state_.registers[instr.x];
+    state_.programCounter += 2;
+}
 
-    if (!isValidRegisterIndex(x)) {
-        setError(ErrorCode::InvalidRegisterAccess, "Invalid register index: " + std::to_string(x));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX18(const DecodedInstruction& instr) {
+    // 0xFX18 - Set sound timer to VX
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
         return;
     }
 
-    registers_[x] = nn;
-    programCounter_ += 2;
+    state_.soundTimer = state_.registers[instr.x];
+    state_.programCounter += 2;
 }
 
-void Chip8::handleOpcode7xxx() {
-    // 0x7XNN - Add NN to VX
-    std::uint8_t x = (opcode_ & 0x0F00) >> 8;
-    std::uint8_t nn = opcode_ & 0x00FF;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX1E(const DecodedInstruction& instr) {
+    // 0xFX1E - Add VX to I
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
+        return;
+    }
+
+    state_.indexRegister += state_.registers[instr.x];
+    state_.programCounter += 2;
+}
 
-    if (!isValidRegisterIndex(x)) {
-        setError(ErrorCode::InvalidRegisterAccess, "Invalid register index: " + std::to_string(x));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX29(const DecodedInstruction& instr) {
+    // 0xFX29 - Set I to sprite location for digit VX
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
         return;
     }
 
-    registers_[x] += nn;
-    programCounter_ += 2;
+    if (state_.registers[instr.x] > 0xF) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::SpriteDigit, state_.registers[instr.x]);
+        return;
+    }
+    state_.indexRegister = state_.registers[instr.x] * 5;  // Each sprite is 5 bytes
+    state_.programCounter += 2;
 }
 
-void Chip8::handleOpcode8xxx() {
-    std::uint8_t x = (opcode_ & 0x0F00) >> 8;
-    std::uint8_t y = (opcode_ & 0x00F0) >> 4;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX33(const DecodedInstruction& instr) {
+    // 0xFX33 - Store BCD representation of VX
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
+        return;
+    }
 
-    if (!isValidRegisterIndex(x) || !isValidRegisterIndex(y)) {
-        setError(ErrorCode::InvalidRegisterAccess,
-                 "Invalid register indices: " + std::to_string(x) + ", " + std::to_string(y));
+    if (!isAddressInRange(state_.indexRegister + 2)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::BcdStorage, state_.indexRegister);
         return;
     }
+    std::uint8_t value = state_.registers[instr.x];
+    state_.memory[memoryIndex(state_.indexRegister)] = value / 100;
+    state_.memory[memoryIndex(state_.indexRegister + 1)] = (value / 10) % 10;
+    state_.memory[memoryIndex(state_.indexRegister + 2)] = value % 10;
+    invalidateDecoded(memoryIndex(state_.indexRegister), 3);
+    state_.programCounter += 2;
+}
 
-    switch (opcode_ & 0x000F) {
-        case 0x0000:  // 0x8XY0 - Set VX to VY
-            registers_[x] = registers_[y];
-            break;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX55(const DecodedInstruction& instr) {
+    // 0xFX55 - Store V0 to VX in memory starting at I
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
+        return;
+    }
 
-        case 0x0001:  // 0x8XY1 - Set VX to VX OR VY
-            registers_[x] |= registers_[y];
-            break;
+    if (!isAddressInRange(state_.indexRegister + instr.x)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::RegisterDump, state_.indexRegister);
+        return;
+    }
+    for (std::uint8_t i = 0; i <= instr.x; ++i) {
+        state_.memory[memoryIndex(state_.indexRegister + i)] = state_.registers[i];
+    }
+    invalidateDecoded(memoryIndex(state_.indexRegister), instr.x + 1);
+    if constexpr (Quirks::LOAD_STORE_ADVANCES_I) {
+        state_.indexRegister += instr.x + 1;
+    }
+    state_.programCounter += 2;
+}
 
-        case 0x0002:  // 0x8XY2 - Set VX to VX AND VY
-            registers_[x] &= registers_[y];
-            break;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX65(const DecodedInstruction& instr) {
+    // 0xFX65 - Load V0 to VX from memory starting at I
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
+        return;
+    }
 
-        case 0x0003:  // 0x8XY3 - Set VX to VX XOR VY
-            registers_[x] ^= registers_[y];
-            break;
+    if (!isAddressInRange(state_.indexRegister + instr.x)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::RegisterLoad, state_.indexRegister);
+        return;
+    }
+    for (std::uint8_t i = 0; i <= instr.x; ++i) {
+        state_.registers[i] = state_.memory[memoryIndex(state_.indexRegister + i)];
+    }
+    if constexpr (Quirks::LOAD_STORE_ADVANCES_I) {
+        state_.indexRegister += instr.x + 1;
+    }
+    state_.programCounter += 2;
+}
 
-        case 0x0004:  // 0x8XY4 - Add VY to VX, VF = carry
-            if (registers_[y] > 0xFF - registers_[x]) {
-                registers_[0xF] = 1;  // Carry
-            } else {
-                registers_[0xF] = 0;
-            }
-            registers_[x] += registers_[y];
-            break;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode00CN(const DecodedInstruction& instr) {
+    // 0x00CN - Scroll the display down N rows
+    const std::size_t shift =
+        std::min<std::size_t>(instr.n, getDisplayHeight()) * DISPLAY_ROW_WORDS;
+    const std::size_t size = std::size_t{getDisplayHeight()} * DISPLAY_ROW_WORDS;
+    scrollDisplay([=](DisplayPlane& plane) {
+        std::copy_backward(plane.begin(), plane.begin() + (size - shift), plane.begin() + size);
+        std::fill_n(plane.begin(), shift, 0);
+    });
+    state_.programCounter += 2;
+}
 
-        case 0x0005:  // 0x8XY5 - Subtract VY from VX, VF = NOT borrow
-            if (registers_[x] >= registers_[y]) {
-                registers_[0xF] = 1;  // NOT borrow
-            } else {
-                registers_[0xF] = 0;
+// Horizontal scrolls shift each row's words, carrying bits between the two
+// words of a high-resolution row. Columns shifted past the edge are dropped.
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode00FB(const DecodedInstruction&) {
+    // 0x00FB - Scroll the display right 4 pixels
+    const std::size_t words = getDisplayWidth() / 64;
+    const std::size_t size = std::size_t{getDisplayHeight()} * DISPLAY_ROW_WORDS;
+    scrollDisplay([=](DisplayPlane& plane) {
+        for (std::size_t row = 0; row < size; row += DISPLAY_ROW_WORDS) {
+            std::uint64_t* line = &plane[row];
+            for (std::size_t word = words - 1; word > 0; --word) {
+                line[word] = line[word] >> HORIZONTAL_SCROLL |
+                             line[word - 1] << (64 - HORIZONTAL_SCROLL);
             }
-            registers_[x] -= registers_[y];
-            break;
-
-        case 0x0006:  // 0x8XY6 - Shift VX right by one, VF = LSB
-            registers_[0xF] = registers_[x] & 1;
-            registers_[x] >>= 1;
-            break;
+            line[0] >>= HORIZONTAL_SCROLL;
+        }
+    });
+    state_.programCounter += 2;
+}
 
-        case 0x0007:  // 0x8XY7 - Set VX to VY - VX, VF = NOT borrow
-            if (registers_[y] >= registers_[x]) {
-                registers_[0xF] = 1;  // NOT borrow
-            } else {
-                registers_[0xF] = 0;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode00FC(const DecodedInstruction&) {
+    // 0x00FC - Scroll the display left 4 pixels
+    const std::size_t words = getDisplayWidth() / 64;
+    const std::size_t size = std::size_t{getDisplayHeight()} * DISPLAY_ROW_WORDS;
+    scrollDisplay([=](DisplayPlane& plane) {
+        for (std::size_t row = 0; row < size; row += DISPLAY_ROW_WORDS) {
+            std::uint64_t* line = &plane[row];
+            for (std::size_t word = 0; word + 1 < words; ++word) {
+                line[word] = line[word] << HORIZONTAL_SCROLL |
+                             line[word + 1] >> (64 - HORIZONTAL_SCROLL);
             }
-            registers_[x] = registers_[y] - registers_[x];
-            break;
+            line[words - 1] <<= HORIZONTAL_SCROLL;
+        }
+    });
+    state_.programCounter += 2;
+}
 
-        case 0x000E:  // 0x8XYE - Shift VX left by one, VF = MSB
-            registers_[0xF] = registers_[x] >> 7;
-            registers_[x] <<= 1;
-            break;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode00FD(const DecodedInstruction&) {
+    // 0x00FD - Exit the interpreter. The program counter stays here, so the
+    // machine idles until it is reset.
+}
 
-        default:
-            setError(ErrorCode::UnknownOpcode,
-                     "Unknown 0x8xxx opcode: 0x" + std::to_string(opcode_));
-            return;
-    }
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode00FE(const DecodedInstruction&) {
+    // 0x00FE - Switch to 64x32
+    setResolution(false);
+    state_.programCounter += 2;
+}
 
-    programCounter_ += 2;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode00FF(const DecodedInstruction&) {
+    // 0x00FF - Switch to 128x64
+    setResolution(true);
+    state_.programCounter += 2;
 }
 
-void Chip8::handleOpcode9xxx() {
-    // 0x9XY0 - Skip next instruction if VX doesn't equal VY
-    std::uint8_t x = (opcode_ & 0x0F00) >> 8;
-    std::uint8_t y = (opcode_ & 0x00F0) >> 4;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX30(const DecodedInstruction& instr) {
+    // 0xFX30 - Set I to the big sprite for digit VX
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
+        return;
+    }
 
-    if (!isValidRegisterIndex(x) || !isValidRegisterIndex(y)) {
-        setError(ErrorCode::InvalidRegisterAccess,
-                 "Invalid register indices: " + std::to_string(x) + ", " + std::to_string(y));
+    if (state_.registers[instr.x] > 0xF) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::SpriteDigit, state_.registers[instr.x]);
         return;
     }
+    // Each sprite is 10 bytes
+    state_.indexRegister = BIG_FONT_ADDRESS + state_.registers[instr.x] * 10;
+    state_.programCounter += 2;
+}
 
-    if (registers_[x] != registers_[y]) {
-        programCounter_ += 4;
-    } else {
-        programCounter_ += 2;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX75(const DecodedInstruction& instr) {
+    // 0xFX75 - Store V0 to VX in the flag registers
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
+        return;
     }
+
+    std::copy_n(state_.registers.begin(), instr.x + 1, state_.flagRegisters.begin());
+    state_.programCounter += 2;
 }
 
-void Chip8::handleOpcodeAxxx() {
-    // 0xANNN - Set I to address NNN
-    std::uint16_t address = opcode_ & 0x0FFF;
-    if (!isValidMemoryAddress(address)) {
-        setError(ErrorCode::InvalidMemoryAccess,
-                 "Invalid index register address: " + std::to_string(address));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX85(const DecodedInstruction& instr) {
+    // 0xFX85 - Load V0 to VX from the flag registers
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
         return;
     }
 
-    indexRegister_ = address;
-    programCounter_ += 2;
+    std::copy_n(state_.flagRegisters.begin(), instr.x + 1, state_.registers.begin());
+    state_.programCounter += 2;
 }
 
-void Chip8::handleOpcodeBxxx() {
-    // 0xBNNN - Jump to address NNN + V0
-    std::uint16_t address = registers_[0] + (opcode_ & 0x0FFF);
-    if (!isValidMemoryAddress(address)) {
-        setError(ErrorCode::InvalidMemoryAccess,
-                 "Invalid computed jump address: " + std::to_string(address));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeF000(const DecodedInstruction& instr) {
+    // 0xF000 NNNN - Set I to the 16-bit address NNNN
+    if (!isAddressInRange(instr.nnn)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::IndexRegisterAddress, instr.nnn);
         return;
     }
 
-    programCounter_ = address;
+    state_.indexRegister = instr.nnn;
+    state_.programCounter += 4;
 }
 
-void Chip8::handleOpcodeCxxx() {
-    // 0xCXNN - Set VX to random number AND NN
-    std::uint8_t x = (opcode_ & 0x0F00) >> 8;
-    std::uint8_t nn = opcode_ & 0x00FF;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFN01(const DecodedInstruction& instr) {
+    // 0xFN01 - Select the planes that drawing, clearing and scrolling affect
+    state_.planes = instr.x & ALL_PLANES;
+    state_.programCounter += 2;
+}
 
-    if (!isValidRegisterIndex(x)) {
-        setError(ErrorCode::InvalidRegisterAccess, "Invalid register index: " + std::to_string(x));
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode5XY2(const DecodedInstruction& instr) {
+    // 0x5XY2 - Store VX to VY in memory starting at I, in either direction
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
         return;
     }
 
-    std::uint8_t randomNumber = Random::get<std::uint8_t>(0, 255);
-    registers_[x] = randomNumber & nn;
-    programCounter_ += 2;
+    const int step = instr.x <= instr.y ? 1 : -1;
+    const std::uint8_t count = (instr.x <= instr.y ? instr.y - instr.x : instr.x - instr.y) + 1;
+    if (!isAddressInRange(state_.indexRegister + count - 1u)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::RegisterDump, state_.indexRegister);
+        return;
+    }
+    for (std::uint8_t i = 0; i < count; ++i) {
+        state_.memory[memoryIndex(state_.indexRegister + i)] =
+            state_.registers[(instr.x + i * step) & 0xF];
+    }
+    invalidateDecoded(memoryIndex(state_.indexRegister), count);
+    state_.programCounter += 2;
 }
 
-void Chip8::handleOpcodeDxxx() {
-    // 0xDXYN - Draw sprite at (VX, VY) with height N
-    std::uint8_t x = (opcode_ & 0x0F00) >> 8;
-    std::uint8_t y = (opcode_ & 0x00F0) >> 4;
-    std::uint8_t height = opcode_ & 0x000F;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode5XY3(const DecodedInstruction& instr) {
+    // 0x5XY3 - Load VX to VY from memory starting at I, in either direction
+    if (!isValidRegisterField(instr.x) || !isValidRegisterField(instr.y)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndices, instr.x, instr.y);
+        return;
+    }
 
-    if (!isValidRegisterIndex(x) || !isValidRegisterIndex(y)) {
-        setError(ErrorCode::InvalidRegisterAccess,
-                 "Invalid register indices: " + std::to_string(x) + ", " + std::to_string(y));
+    const int step = instr.x <= instr.y ? 1 : -1;
+    const std::uint8_t count = (instr.x <= instr.y ? instr.y - instr.x : instr.x - instr.y) + 1;
+    if (!isAddressInRange(state_.indexRegister + count - 1u)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::RegisterLoad, state_.indexRegister);
         return;
     }
+    for (std::uint8_t i = 0; i < count; ++i) {
+        state_.registers[(instr.x + i * step) & 0xF] =
+            state_.memory[memoryIndex(state_.indexRegister + i)];
+    }
+    state_.programCounter += 2;
+}
 
-    std::uint8_t xPos = registers_[x];
-    std::uint8_t yPos = registers_[y];
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeF002(const DecodedInstruction&) {
+    // 0xF002 - Load the 16-byte audio pattern from memory starting at I
+    if (!isAddressInRange(state_.indexRegister + AUDIO_PATTERN_SIZE - 1u)) {
+        setError(ErrorCode::InvalidMemoryAccess, ErrorSite::AudioPattern, state_.indexRegister);
+        return;
+    }
+    for (std::uint16_t i = 0; i < AUDIO_PATTERN_SIZE; ++i) {
+        state_.audioPattern[i] = state_.memory[memoryIndex(state_.indexRegister + i)];
+    }
+    state_.programCounter += 2;
+}
 
-    registers_[0xF] = 0;  // Clear collision flag
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcodeFX3A(const DecodedInstruction& instr) {
+    // 0xFX3A - Set the audio pitch register to VX
+    if (!isValidRegisterField(instr.x)) {
+        setError(ErrorCode::InvalidRegisterAccess, ErrorSite::RegisterIndex, instr.x);
+        return;
+    }
 
-    for (std::uint8_t row = 0; row < height; ++row) {
-        if (indexRegister_ + row >= MEMORY_SIZE) {
-            setError(ErrorCode::InvalidMemoryAccess, "Sprite data out of memory bounds");
-            return;
-        }
+    state_.audioPitch = state_.registers[instr.x];
+    state_.programCounter += 2;
+}
 
-        std::uint8_t spriteRow = memory_[indexRegister_ + row];
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleOpcode00DN(const DecodedInstruction& instr) {
+    // 0x00DN - Scroll the display up N rows
+    const std::size_t shift =
+        std::min<std::size_t>(instr.n, getDisplayHeight()) * DISPLAY_ROW_WORDS;
+    const std::size_t size = std::size_t{getDisplayHeight()} * DISPLAY_ROW_WORDS;
+    scrollDisplay([=](DisplayPlane& plane) {
+        std::copy(plane.begin() + shift, plane.begin() + size, plane.begin());
+        std::fill(plane.begin() + (size - shift), plane.begin() + size, 0);
+    });
+    state_.programCounter += 2;
+}
 
-        for (std::uint8_t col = 0; col < 8; ++col) {
-            if ((spriteRow & (0x80 >> col)) != 0) {
-                std::uint16_t pixelX = (xPos + col) % DISPLAY_WIDTH;
-                std::uint16_t pixelY = (yPos + row) % DISPLAY_HEIGHT;
-                std::uint16_t pixelIndex = pixelY * DISPLAY_WIDTH + pixelX;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::handleUnknownOpcode(const DecodedInstruction& instr) {
+    setError(ErrorCode::UnknownOpcode, ErrorSite::UnknownOpcode, instr.opcode);
+}
 
-                if (frameBuffer_[pixelIndex] == 1) {
-                    registers_[0xF] = 1;  // Collision detected
-                }
-                frameBuffer_[pixelIndex] ^= 1;
-            }
-        }
+// Superinstruction handlers. Each runs the original handlers back to back and
+// advances the timer clock after every instruction, exactly like single-stepping.
+// Batch runs always stop on errors, so pendingStops_ ends a sequence early.
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::handleFusedANNN_DXYN(const DecodedInstruction& instr,
+                                                                    std::uint32_t) {
+    // ANNN, DXYN - Point I at a sprite and draw it
+    handleOpcodeANNN(instr);
+    updateTimers();
+    if (pendingStops_ != 0) {
+        return 1;
     }
+    handleOpcodeDXYN(fetchFusedPart());
+    updateTimers();
+    return 2;
+}
 
-    drawFlag_ = true;
-    programCounter_ += 2;
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::handleFused6XNN_6XNN(const DecodedInstruction& instr,
+                                                                    std::uint32_t) {
+    // 6XNN, 6XNN - Load two registers
+    handleOpcode6XNN(instr);
+    updateTimers();
+    if (pendingStops_ != 0) {
+        return 1;
+    }
+    handleOpcode6XNN(fetchFusedPart());
+    updateTimers();
+    return 2;
 }
 
-void Chip8::handleOpcodeExxx() {
-    std::uint8_t x = (opcode_ & 0x0F00) >> 8;
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::handleFused7XNN_3XNN(const DecodedInstruction& instr,
+                                                                    std::uint32_t) {
+    // 7XNN, 3XNN - Step a counter and skip if it reached a value
+    handleOpcode7XNN(instr);
+    updateTimers();
+    if (pendingStops_ != 0) {
+        return 1;
+    }
+    handleOpcode3XNN(fetchFusedPart());
+    updateTimers();
+    return 2;
+}
 
-    if (!isValidRegisterIndex(x)) {
-        setError(ErrorCode::InvalidRegisterAccess, "Invalid register index: " + std::to_string(x));
-        return;
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::handleFused7XNN_4XNN(const DecodedInstruction& instr,
+                                                                    std::uint32_t) {
+    // 7XNN, 4XNN - Step a counter and skip unless it reached a value
+    handleOpcode7XNN(instr);
+    updateTimers();
+    if (pendingStops_ != 0) {
+        return 1;
     }
+    handleOpcode4XNN(fetchFusedPart());
+    updateTimers();
+    return 2;
+}
 
-    switch (opcode_ & 0x000F) {
-        case 0x000E:  // 0xEX9E - Skip if key VX is pressed
-            if (registers_[x] < KEYBOARD_SIZE && keyboard_[registers_[x]] != 0) {
-                programCounter_ += 4;
-            } else {
-                programCounter_ += 2;
-            }
-            break;
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::handleFusedFX07_3X00_1NNN(
+    const DecodedInstruction& instr, std::uint32_t) {
+    // FX07, 3X00, 1NNN - Read the delay timer and jump back until it is zero
+    handleOpcodeFX07(instr);
+    updateTimers();
+    if (pendingStops_ != 0) {
+        return 1;
+    }
+    const std::uint16_t skipAddress = state_.programCounter;
+    handleOpcode3XNN(fetchFusedPart());
+    updateTimers();
+    if (pendingStops_ != 0 || state_.programCounter != skipAddress + 2) {
+        return 2;  // The timer expired and the jump was skipped
+    }
+    handleOpcode1NNN(fetchFusedPart());
+    updateTimers();
+    return 3;
+}
 
-        case 0x0001:  // 0xEXA1 - Skip if key VX is not pressed
-            if (registers_[x] >= KEYBOARD_SIZE || keyboard_[registers_[x]] == 0) {
-                programCounter_ += 4;
-            } else {
-                programCounter_ += 2;
-            }
-            break;
+// Idle loop handlers. Skipping a loop leaves exactly the state that executing
+// it for the same number of cycles would, but costs O(1).
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::handleIdle1NNN(const DecodedInstruction&,
+                                                              std::uint32_t budget) {
+    // 1NNN to itself - Only the timers change until the run ends
+    advanceTimers(budget);
+    return budget;
+}
 
-        default:
-            setError(ErrorCode::UnknownOpcode,
-                     "Unknown 0xExxx opcode: 0x" + std::to_string(opcode_));
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::handleIdleFX0A(const DecodedInstruction& instr,
+                                                              std::uint32_t budget) {
+    // FX0A - Without a key press, FX0A repeats until the run ends, unless the
+    // run stops at key waits (all but runCyclesThroughKeyWaits())
+    const std::uint16_t waitAddress = state_.programCounter;
+    handleOpcodeFX0A(instr);
+    if (pendingStops_ != 0 || state_.programCounter != waitAddress) {
+        updateTimers();
+        return 1;
     }
+    advanceTimers(budget);
+    return budget;
 }
 
-void Chip8::handleOpcodeFxxx() {
-    std::uint8_t x = (opcode_ & 0x0F00) >> 8;
+template <typename Policy, typename Quirks, typename Rng>
+std::uint32_t BasicChip8<Policy, Quirks, Rng>::handleIdleFX07_3X00_1NNN(
+    const DecodedInstruction& instr, std::uint32_t budget) {
+    // FX07, 3X00, 1NNN back to the FX07 - Skip the passes that read a nonzero timer
+    if (state_.delayTimer == 0) {
+        return handleFusedFX07_3X00_1NNN(instr, budget);
+    }
 
-    if (!isValidRegisterIndex(x)) {
-        setError(ErrorCode::InvalidRegisterAccess, "Invalid register index: " + std::to_string(x));
-        return;
+    // Pass i starts 3 * i cycles from now and reads the delay timer minus the
+    // ticks before it. Skip up to the first pass that would read zero; with an
+    // unthrottled CPU the timer never changes here, so the loop lasts the budget.
+    const std::uint64_t passStep = 3ull * timerStep_;
+    std::uint32_t passes = budget / 3u;
+    if (passStep != 0) {
+        const std::uint64_t untilZero =
+            std::uint64_t{state_.delayTimer} * timerPeriod_ - state_.timerPhase;
+        passes = static_cast<std::uint32_t>(
+            std::min<std::uint64_t>((untilZero + passStep - 1) / passStep, passes));
     }
+    const std::uint64_t lastPassTicks =
+        (state_.timerPhase + passStep * (passes - 1u)) / timerPeriod_;
+    state_.registers[instr.x] = static_cast<std::uint8_t>(state_.delayTimer - lastPassTicks);
+    state_.opcode = fetchDecoded(state_.programCounter + 4).opcode;
+    advanceTimers(passes * 3u);
+    return passes * 3u;
+}
 
-    switch (opcode_ & 0x00FF) {
-        case 0x0007:  // 0xFX07 - Set VX to delay timer
-            registers_[x] = delayTimer_;
-            break;
+// Display helpers
+template <typename Policy, typename Quirks, typename Rng>
+template <std::uint8_t Width>
+bool BasicChip8<Policy, Quirks, Rng>::drawSprite(const DecodedInstruction& instr,
+                                          std::uint8_t height) {
+    constexpr std::uint8_t BYTES_PER_ROW = Width / 8;
+    const std::uint16_t displayWidth = getDisplayWidth();
+    const std::uint16_t displayHeight = getDisplayHeight();
+
+    // Both display sizes are powers of two, so wrapping is a mask. Clipping
+    // profiles wrap only the start position and drop what runs off the edge.
+    const std::uint16_t xPos = state_.registers[instr.x] & (displayWidth - 1);
+    std::uint16_t yPos = state_.registers[instr.y];
+    std::uint16_t rows = height;
+    if constexpr (Quirks::DRAW_CLIPS) {
+        yPos &= displayHeight - 1;
+        rows = std::min<std::uint16_t>(rows, displayHeight - yPos);
+    }
 
-        case 0x000A: {  // 0xFX0A - Wait for key press
-            bool keyPressed = false;
-            for (std::uint8_t i = 0; i < KEYBOARD_SIZE; ++i) {
-                if (keyboard_[i] != 0) {
-                    registers_[x] = i;
-                    keyPressed = true;
-                    break;
-                }
+    // A sprite row lands in the word holding column xPos, and its tail spills
+    // into the next word. Past the last word of the row the spill wraps to the
+    // first one, which in low resolution makes the pair a rotate; clipping
+    // profiles drop it instead.
+    const std::size_t rowWords = displayWidth / 64;
+    const std::size_t word = xPos / 64;
+    const std::uint16_t offset = xPos % 64;
+    const bool wraps = word + 1 == rowWords;
+    const std::size_t spillWord = wraps ? 0 : word + 1;
+    const bool spills = offset + Width > 64 && !(Quirks::DRAW_CLIPS && wraps);
+
+    // The first selected plane's image starts at I and the second one follows it
+    const std::uint8_t planes = selectedPlanes();
+    const std::uint32_t planeSize = height * BYTES_PER_ROW;
+    bool collision = false;
+
+    // The rows drawn, wrapped around the bottom edge like the sprite: a rotate
+    // of the whole mask in high resolution, a fold of the upper half in low.
+    // Marked up front, as a read past memory leaves the rows before it drawn.
+    const std::uint16_t top = yPos & (displayHeight - 1);
+    const RowMask span = (RowMask{1} << rows) - 1;
+    const RowMask shifted = span << top;
+    dirtyRows_ |= state_.highResolution ? shifted | span >> ((64 - top) & 63)
+                                  : (shifted | shifted >> DISPLAY_HEIGHT) & visibleRows();
+
+    for (std::uint16_t row = 0; row < rows; ++row) {
+        const std::size_t line = ((yPos + row) & (displayHeight - 1)) * DISPLAY_ROW_WORDS;
+        std::uint32_t address = state_.indexRegister + row * BYTES_PER_ROW;
+        for (std::uint8_t plane = 0; plane < PLANE_COUNT; ++plane) {
+            if ((planes >> plane & 1) == 0) {
+                continue;
             }
-            if (!keyPressed) {
-                return;  // Don't increment PC, wait for key
+            if (!isAddressInRange(address + BYTES_PER_ROW - 1)) {
+                setError(ErrorCode::InvalidMemoryAccess, ErrorSite::SpriteData,
+                         std::max<std::uint32_t>(address, MEMORY_SIZE));
+                state_.registers[0xF] = collision ? 1 : 0;
+                return false;
             }
-            break;
-        }
-
-        case 0x0015:  // 0xFX15 - Set delay timer to VX
-            delayTimer_ = registers_[x];
-            break;
-
-        case 0x0018:  // 0xFX18 - Set sound timer to VX
-            soundTimer_ = registers_[x];
-            break;
-
-        case 0x001E:  // 0xFX1E - Add VX to I
-            indexRegister_ += registers_[x];
-            break;
-
-        case 0x0029:  // 0xFX29 - Set I to sprite location for digit VX
-            if (registers_[x] > 0xF) {
-                setError(ErrorCode::InvalidMemoryAccess,
-                         "Invalid sprite digit: " + std::to_string(registers_[x]));
-                return;
+            std::uint64_t spriteRow = state_.memory[memoryIndex(address)];
+            if constexpr (BYTES_PER_ROW == 2) {
+                spriteRow = spriteRow << 8 | state_.memory[memoryIndex(address + 1)];
             }
-            indexRegister_ = registers_[x] * 5;  // Each sprite is 5 bytes
-            break;
+            address += planeSize;
 
-        case 0x0033: {  // 0xFX33 - Store BCD representation of VX
-            if (indexRegister_ + 2 >= MEMORY_SIZE) {
-                setError(ErrorCode::InvalidMemoryAccess, "BCD storage out of memory bounds");
-                return;
+            const std::uint64_t aligned = spriteRow << (64 - Width);
+            std::array<std::uint64_t, DISPLAY_ROW_WORDS> mask{};
+            mask[word] = aligned >> offset;
+            if (spills) {
+                mask[spillWord] |= aligned << (64 - offset);
             }
-            std::uint8_t value = registers_[x];
-            memory_[indexRegister_] = value / 100;
-            memory_[indexRegister_ + 1] = (value / 10) % 10;
-            memory_[indexRegister_ + 2] = value % 10;
-            break;
-        }
 
-        case 0x0055: {  // 0xFX55 - Store V0 to VX in memory starting at I
-            if (indexRegister_ + x >= MEMORY_SIZE) {
-                setError(ErrorCode::InvalidMemoryAccess, "Register dump out of memory bounds");
-                return;
+            std::uint64_t* pixels = &state_.displayPlanes[plane][line];
+            for (std::size_t i = 0; i < DISPLAY_ROW_WORDS; ++i) {
+                collision = collision || (pixels[i] & mask[i]) != 0;
+                pixels[i] ^= mask[i];
             }
-            for (std::uint8_t i = 0; i <= x; ++i) {
-                memory_[indexRegister_ + i] = registers_[i];
-            }
-            break;
         }
+    }
+    state_.registers[0xF] = collision ? 1 : 0;
+    return true;
+}
 
-        case 0x0065: {  // 0xFX65 - Load V0 to VX from memory starting at I
-            if (indexRegister_ + x >= MEMORY_SIZE) {
-                setError(ErrorCode::InvalidMemoryAccess, "Register load out of memory bounds");
-                return;
-            }
-            for (std::uint8_t i = 0; i <= x; ++i) {
-                registers_[i] = memory_[indexRegister_ + i];
-            }
-            break;
-        }
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setResolution(bool high) {
+    // The row length changes, so the old image is meaningless; start blank
+    state_.highResolution = high;
+    for (DisplayPlane& plane : state_.displayPlanes) {
+        plane.fill(0);
+    }
+    dirtyRows_ = visibleRows();
+    displayChanged();
+}
 
-        default:
-            setError(ErrorCode::UnknownOpcode,
-                     "Unknown 0xFxxx opcode: 0x" + std::to_string(opcode_));
-            return;
+template <typename Policy, typename Quirks, typename Rng>
+template <typename Scroll>
+void BasicChip8<Policy, Quirks, Rng>::scrollDisplay(Scroll scroll) {
+    const std::uint8_t planes = selectedPlanes();
+    for (std::uint8_t plane = 0; plane < PLANE_COUNT; ++plane) {
+        if ((planes >> plane & 1) != 0) {
+            scroll(state_.displayPlanes[plane]);
+        }
     }
+    dirtyRows_ = visibleRows();
+    displayChanged();
+}
 
-    programCounter_ += 2;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::displayChanged() {
+    state_.drawFlag = true;
+    frameBufferViewStale_ = true;
+    raiseStop(STOP_DRAW);
 }
 
-// Utility methods
-void Chip8::setError(ErrorCode error, const std::string& message) {
-    lastError_ = error;
-    lastErrorMessage_ = message;
-    logError(message);
+template <typename Policy, typename Quirks, typename Rng>
+Chip8Base::RowMask BasicChip8<Policy, Quirks, Rng>::visibleRows() const {
+    return state_.highResolution ? ~RowMask{0} : (RowMask{1} << DISPLAY_HEIGHT) - 1;
 }
 
-void Chip8::clearError() {
-    lastError_ = ErrorCode::None;
-    lastErrorMessage_.clear();
+template <typename Policy, typename Quirks, typename Rng>
+std::uint16_t BasicChip8<Policy, Quirks, Rng>::skipDistance() const {
+    // XO-CHIP skips F000 NNNN with its address word
+    if constexpr (Quirks::XO_CHIP) {
+        const std::uint32_t next = state_.programCounter + 2u;
+        if (state_.memory[next & ADDRESS_MASK] == 0xF0 &&
+            state_.memory[(next + 1) & ADDRESS_MASK] == 0x00) {
+            return 6;
+        }
+    }
+    return 4;
 }
 
-bool Chip8::isValidMemoryAddress(std::uint16_t address) const { return address < MEMORY_SIZE; }
+// Utility methods
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::setError(ErrorCode error, ErrorSite site, std::uint32_t first,
+                                               std::uint32_t second) {
+    raiseStop(STOP_ERROR);
+    lastError_ = ErrorRecord{error, site, state_.programCounter, state_.opcode, {first, second}};
+}
 
-bool Chip8::isValidRegisterIndex(std::uint8_t index) const { return index < REGISTER_COUNT; }
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::clearError() { lastError_ = ErrorRecord{}; }
 
-void Chip8::logError(const std::string& message) const {
-    std::cerr << "[ERROR] CHIP-8: " << message << std::endl;
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::isValidMemoryAddress(std::uint16_t address) const {
+    return address < MEMORY_SIZE;
 }
 
-void Chip8::logWarning(const std::string& message) const {
-    std::cerr << "[WARNING] CHIP-8: " << message << std::endl;
+template <typename Policy, typename Quirks, typename Rng>
+bool BasicChip8<Policy, Quirks, Rng>::isValidRegisterIndex(std::uint8_t index) const {
+    return index < REGISTER_COUNT;
 }
 
-void Chip8::logInfo(const std::string& message) const {
-    std::cout << "[INFO] CHIP-8: " << message << std::endl;
+template <typename Policy, typename Quirks, typename Rng>
+void BasicChip8<Policy, Quirks, Rng>::log(LogLevel level, std::string_view message) const {
+    if (logger_->isEnabled(level)) {
+        logger_->write(level, message);
+    }
 }
+
+template class BasicChip8<CheckedPolicy, DefaultQuirks>;
+template class BasicChip8<CheckedPolicy, Chip8Quirks>;
+template class BasicChip8<CheckedPolicy, SuperChipQuirks>;
+template class BasicChip8<CheckedPolicy, XoChipQuirks>;
+template class BasicChip8<TrustedPolicy, DefaultQuirks>;
+template class BasicChip8<TrustedPolicy, Chip8Quirks>;
+template class BasicChip8<TrustedPolicy, SuperChipQuirks>;
+template class BasicChip8<TrustedPolicy, XoChipQuirks>;
+template class BasicChip8<CheckedPolicy, DefaultQuirks, Pcg32>;
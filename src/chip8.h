@@ -2,36 +2,103 @@
 #define CHIP8_H
 
 #include <array>
+#include <bitset>
 #include <cstdint>
 #include <iostream>
 #include <string>
+#include <type_traits>
+#include <vector>
 
-class Chip8 {
+#include "logger.h"
+#include "random.h"
+
+class Chip8Aot;
+
+// Constants and types shared by every BasicChip8 instantiation
+class Chip8Base {
   public:
+    // Classic address space. XO-CHIP profiles have XO_CHIP_MEMORY_SIZE instead;
+    // BasicChip8::MEMORY_SIZE is the size for the instance's profile.
     static constexpr std::uint16_t MEMORY_SIZE = 4096;
+    static constexpr std::uint32_t XO_CHIP_MEMORY_SIZE = 0x10000;
     static constexpr std::uint16_t REGISTER_COUNT = 16;
     static constexpr std::uint16_t STACK_SIZE = 16;
     static constexpr std::uint16_t DISPLAY_WIDTH = 64;
     static constexpr std::uint16_t DISPLAY_HEIGHT = 32;
     static constexpr std::uint16_t DISPLAY_SIZE = DISPLAY_WIDTH * DISPLAY_HEIGHT;
+    // SUPER-CHIP high-resolution mode (00FF). The frame buffer is sized for it.
+    static constexpr std::uint16_t HIRES_DISPLAY_WIDTH = 128;
+    static constexpr std::uint16_t HIRES_DISPLAY_HEIGHT = 64;
+    static constexpr std::uint16_t FRAME_BUFFER_SIZE = HIRES_DISPLAY_WIDTH * HIRES_DISPLAY_HEIGHT;
     static constexpr std::uint16_t KEYBOARD_SIZE = 16;
     static constexpr std::uint16_t ROM_START_ADDRESS = 0x200;
     static constexpr std::uint16_t FONT_SET_SIZE = 80;
+    // SUPER-CHIP 8x10 digits for FX30, stored right after the small font
+    static constexpr std::uint16_t BIG_FONT_ADDRESS = FONT_SET_SIZE;
+    static constexpr std::uint16_t BIG_FONT_SET_SIZE = 160;
+    // SUPER-CHIP persistent flags (FX75/FX85)
+    static constexpr std::uint16_t FLAG_REGISTER_COUNT = 16;
+    // XO-CHIP bitplanes (FN01). Each pixel holds one bit per plane; programs
+    // that never select planes only draw to plane 1, so their pixels are 0 or 1.
+    static constexpr std::uint8_t PLANE_COUNT = 2;
+    static constexpr std::uint8_t ALL_PLANES = (1 << PLANE_COUNT) - 1;
+    // The display is stored bit-packed, one DisplayPlane per plane. Row y takes
+    // DISPLAY_ROW_WORDS words from y * DISPLAY_ROW_WORDS, and column 0 is the most
+    // significant bit of its first word. Low resolution uses the first word of
+    // each of the first DISPLAY_HEIGHT rows; bits outside the image are zero.
+    static constexpr std::uint16_t DISPLAY_ROW_WORDS = HIRES_DISPLAY_WIDTH / 64;
+    using DisplayPlane = std::array<std::uint64_t, HIRES_DISPLAY_HEIGHT * DISPLAY_ROW_WORDS>;
+    // Rows changed since the last acknowledgment, bit y for row y. The
+    // high-resolution height is 64, so one word covers every row.
+    using RowMask = std::uint64_t;
+    struct RowRange {
+        std::uint16_t first;
+        std::uint16_t count;
+    };
+    // Runs of consecutive dirty rows, top to bottom. At worst every other row
+    // is dirty, so the ranges fit without allocating.
+    struct RowRanges {
+        std::array<RowRange, HIRES_DISPLAY_HEIGHT / 2> ranges;
+        std::size_t size;
 
-    Chip8();
+        const RowRange* begin() const { return ranges.data(); }
+        const RowRange* end() const { return ranges.data() + size; }
+    };
+    // XO-CHIP audio: a 1-bit, 128-sample pattern (F002) played while the sound
+    // timer runs, at a rate set by the pitch register (FX3A)
+    static constexpr std::uint16_t AUDIO_PATTERN_SIZE = 16;
+    static constexpr std::uint8_t DEFAULT_AUDIO_PITCH = 64;
 
-    bool loadRom(const std::string& path);
-    void init();
-    void emulateCycle();
+    // Execution backends used by runCycles(). emulateCycle() always single-steps
+    // through the switch interpreter. Backends that need compiler support fall
+    // back to the closest portable design when it is unavailable.
+    enum class Backend {
+        Switch,          // Central switch over the decoded operation
+        Threaded,        // Direct-threaded dispatch with computed goto (GCC/Clang)
+        TailCall,        // One function per operation chained with guaranteed tail calls
+        BlockTranslator  // Translate basic blocks once and chain them directly
+    };
 
-    // Frame buffer access
-    const std::array<std::uint8_t, DISPLAY_SIZE>& getFrameBuffer() const;
-    void setPixel(std::uint16_t x, std::uint16_t y, std::uint8_t value);
-    std::uint8_t getPixel(std::uint16_t x, std::uint16_t y) const;
+    // Why a batch run returned
+    enum class StopReason : std::uint8_t {
+        CycleLimit,  // The requested number of cycles ran
+        Error,       // An instruction failed; see getLastError()
+        Draw,        // runUntilDraw() only: an instruction changed the display
+        KeyWait,     // FX0A is waiting for a key press
+        Breakpoint   // The next instruction is at a breakpoint
+    };
 
-    // Keyboard access
-    void setKeyState(std::uint8_t key, bool pressed);
-    bool isKeyPressed(std::uint8_t key) const;
+    struct RunResult {
+        StopReason reason;
+        std::uint32_t cycles;  // Instructions executed, including a failing one
+    };
+
+    // The delay and sound timers count down at TIMER_FREQUENCY, derived from
+    // the emulated CPU clock rather than from instructions or host time
+    static constexpr std::uint32_t TIMER_FREQUENCY = 60;
+    static constexpr std::uint32_t DEFAULT_CPU_FREQUENCY = 600;
+    static constexpr std::uint32_t DEFAULT_CYCLES_PER_FRAME =
+        DEFAULT_CPU_FREQUENCY / TIMER_FREQUENCY;
 
     // Error handling
     enum class ErrorCode {
@@ -43,8 +110,250 @@ class Chip8 {
         UnknownOpcode
     };
 
+    // The check that raised an error. Together with the operands it selects the
+    // message getLastErrorMessage() formats on demand.
+    enum class ErrorSite : std::uint8_t {
+        None,
+        RomOpen,                // The ROM path is kept by loadRom()
+        RomSize,                // Operands: file size in bytes
+        RomRead,
+        CompiledRomMismatch,
+        ProgramCounterBounds,   // Operands: program counter
+        BreakpointAddress,      // Operands: address
+        PixelCoordinates,       // Operands: x, y
+        KeyIndex,               // Operands: key
+        MemoryAddress,          // Operands: address
+        ProgramCounterAddress,  // Operands: address
+        StackIndex,             // Operands: stack slot
+        StackPointer,           // Operands: stack pointer
+        RegisterIndex,          // Operands: register
+        RegisterIndices,        // Operands: X, Y
+        Return,                 // 00EE with an empty stack
+        JumpAddress,            // Operands: address
+        Call,                   // 2NNN with a full stack
+        CallAddress,            // Operands: address
+        IndexRegisterAddress,   // Operands: address
+        ComputedJumpAddress,    // Operands: address
+        SpriteData,             // Operands: first address past memory
+        SpriteDigit,            // Operands: digit
+        BcdStorage,             // Operands: I
+        RegisterDump,           // Operands: I
+        RegisterLoad,           // Operands: I
+        AudioPattern,           // Operands: I
+        UnknownOpcode           // Operands: opcode
+    };
+
+    // Plain-data error report. Raising an error only fills one of these, so
+    // faulting ROMs cost no allocation or I/O per error.
+    struct ErrorRecord {
+        ErrorCode code;
+        ErrorSite site;
+        std::uint16_t programCounter;  // Where the failing instruction or call happened
+        std::uint16_t opcode;
+        std::array<std::uint32_t, 2> operands;
+    };
+
+    // Format version written by serializeState(). Version 2 added the random
+    // generator's state.
+    static constexpr std::uint16_t STATE_VERSION = 2;
+};
+
+// Execution policies. The checked core validates every operand and reports
+// problems through getLastError(). The trusted core drops checks that decoding
+// already rules out (4-bit register fields, 12-bit addresses) and wraps
+// computed addresses into memory instead of branching on them; stack faults,
+// unknown opcodes and a runaway program counter are still reported.
+struct CheckedPolicy {
+    static constexpr bool CHECKED = true;
+};
+
+struct TrustedPolicy {
+    static constexpr bool CHECKED = false;
+};
+
+// Quirk profiles. CHIP-8 variants disagree on a few instructions; a profile
+// picks one behavior for each at compile time, so every instantiation only
+// contains the code for its own behavior.
+//
+// SHIFT_USES_VY:          8XY6/8XYE shift VY into VX instead of shifting VX
+// LOAD_STORE_ADVANCES_I:  FX55/FX65 leave I pointing past the last register
+// JUMP_USES_VX:           BXNN jumps to XNN + VX instead of NNN + V0
+// DRAW_CLIPS:             DXYN cuts sprites off at the screen edges instead of
+//                         wrapping them (the start position always wraps)
+// LOGIC_RESETS_VF:        8XY1/8XY2/8XY3 clear VF
+// SUPER_CHIP:             The SUPER-CHIP instructions (00CN, 00FB-00FF, DXY0,
+//                         FX30, FX75, FX85); elsewhere 00CN and 00FE decode as
+//                         CLS and RET by their low nibble, DXY0 draws no rows
+//                         and the rest are unknown
+// XO_CHIP:                64 KB of memory and the XO-CHIP instructions (F000 NNNN,
+//                         FN01, 5XY2/5XY3, F002, FX3A, 00DN); skips step over
+//                         F000 NNNN as a whole
+
+// This emulator's original behavior, and the default
+struct DefaultQuirks {
+    static constexpr bool SHIFT_USES_VY = false;
+    static constexpr bool LOAD_STORE_ADVANCES_I = false;
+    static constexpr bool JUMP_USES_VX = false;
+    static constexpr bool DRAW_CLIPS = false;
+    static constexpr bool LOGIC_RESETS_VF = false;
+    static constexpr bool SUPER_CHIP = false;
+    static constexpr bool XO_CHIP = false;
+};
+
+// The original COSMAC VIP interpreter
+struct Chip8Quirks {
+    static constexpr bool SHIFT_USES_VY = true;
+    static constexpr bool LOAD_STORE_ADVANCES_I = true;
+    static constexpr bool JUMP_USES_VX = false;
+    static constexpr bool DRAW_CLIPS = true;
+    static constexpr bool LOGIC_RESETS_VF = true;
+    static constexpr bool SUPER_CHIP = false;
+    static constexpr bool XO_CHIP = false;
+};
+
+// SUPER-CHIP 1.1 on the HP 48
+struct SuperChipQuirks {
+    static constexpr bool SHIFT_USES_VY = false;
+    static constexpr bool LOAD_STORE_ADVANCES_I = false;
+    static constexpr bool JUMP_USES_VX = true;
+    static constexpr bool DRAW_CLIPS = true;
+    static constexpr bool LOGIC_RESETS_VF = false;
+    static constexpr bool SUPER_CHIP = true;
+    static constexpr bool XO_CHIP = false;
+};
+
+// XO-CHIP (Octo)
+struct XoChipQuirks {
+    static constexpr bool SHIFT_USES_VY = true;
+    static constexpr bool LOAD_STORE_ADVANCES_I = true;
+    static constexpr bool JUMP_USES_VX = false;
+    static constexpr bool DRAW_CLIPS = false;
+    static constexpr bool LOGIC_RESETS_VF = false;
+    static constexpr bool SUPER_CHIP = true;
+    static constexpr bool XO_CHIP = true;
+};
+
+// Rng is CXNN's generator (see random.h). Each instance owns one, seeded
+// differently unless setRandomSeed() is called.
+template <typename Policy, typename Quirks = DefaultQuirks, typename Rng = Xoshiro128PlusPlus>
+class BasicChip8 : public Chip8Base {
+  public:
+    // Addressable memory for this profile, in bytes
+    static constexpr std::uint32_t MEMORY_SIZE =
+        Quirks::XO_CHIP ? XO_CHIP_MEMORY_SIZE : Chip8Base::MEMORY_SIZE;
+
+    explicit BasicChip8(Backend backend = Backend::Switch, Logger& logger = defaultLogger());
+
+    // Maps the file rather than reading it into a buffer, and checks its size
+    // before touching the contents
+    bool loadRom(const std::string& path);
+    // Loads a ROM image already in memory, such as one shared by many
+    // instances or embedded in the program. The only copy is into memory.
+    bool loadRom(const std::uint8_t* rom, std::size_t size);
+    bool loadRom(const std::vector<std::uint8_t>& rom);
+    void init();
+    void emulateCycle();
+
+    // Batch execution. Each call runs instructions in one tight loop with the
+    // selected backend and stops early on an error, a key wait or a breakpoint.
+    RunResult runCycles(std::uint32_t count);
+    RunResult runUntilDraw(std::uint32_t maxCycles);
+    RunResult runFrame();
+    // Like runCycles(), but an FX0A with no key pressed repeats until the
+    // budget is used up, skipped in O(1) when fusion is on, so the timers keep
+    // time. Returns KeyWait when the run ends waiting for a key.
+    RunResult runCyclesThroughKeyWaits(std::uint32_t count);
+    void setCyclesPerFrame(std::uint32_t cycles);
+    std::uint32_t getCyclesPerFrame() const;
+    Backend getBackend() const;
+
+    // Emulated instructions per second; the timers tick once every
+    // hz / TIMER_FREQUENCY instructions, carrying the fraction. Rates below
+    // TIMER_FREQUENCY are raised to it. 0 means unthrottled: instructions no
+    // longer tick the timers and the caller calls tickTimers() at 60 Hz.
+    void setCpuFrequency(std::uint32_t hz);
+    std::uint32_t getCpuFrequency() const;
+    void tickTimers();
+
+    // Restarts CXNN's sequence; emulators given the same seed draw the same
+    // numbers. The generator is part of the machine state, and init() and
+    // loadRom() leave it alone.
+    void setRandomSeed(std::uint64_t seed);
+
+    // Breakpoints stop a batch run before the instruction at the address
+    // executes. The first instruction of a run never stops, so runs can resume.
+    void addBreakpoint(std::uint16_t address);
+    void removeBreakpoint(std::uint16_t address);
+    void clearBreakpoints();
+
+    // Superinstructions let batch runs execute common opcode sequences with a
+    // single dispatch, and skip over idle loops (jump to self, delay-timer
+    // polling, FX0A key waits when the run does not stop at them) in O(1).
+    // Machine state and RunResult are identical either way; enabled by default.
+    void setFusionEnabled(bool enabled);
+    bool isFusionEnabled() const;
+
+    // ROM code compiled ahead of time by the chip8-aot tool. While attached,
+    // batch runs execute compiled code wherever it covers the program counter
+    // and interpret elsewhere (indirect jump targets, modified code, the last
+    // few cycles of a run). Breakpoints disable compiled code.
+    struct CompiledRom {
+        using Entry = std::uint32_t (*)(BasicChip8& emulator, std::uint32_t budget);
+
+        const std::uint8_t* image;  // ROM bytes the code was compiled from
+        std::uint16_t imageSize;
+        const std::uint16_t* blocks;  // Start and end address of each block
+        std::uint16_t blockCount;
+        Entry run;  // Returns the cycles executed; 0 when nothing is compiled at the PC
+    };
+
+    // Fails unless memory holds the compiled image at ROM_START_ADDRESS.
+    // loadRom() and init() detach the compiled code.
+    bool attachCompiledRom(const CompiledRom& rom);
+    void detachCompiledRom();
+    bool hasCompiledRom() const;
+
+    // Frame buffer access. The image has getDisplayWidth() x getDisplayHeight()
+    // pixels, row-major from the start of the buffer; bytes past it are zero.
+    // 00FE/00FF switch between 64x32 and 128x64 and clear the screen. Pixel
+    // values are plane masks, 0 to ALL_PLANES. getFrameBuffer() is a byte view
+    // of the packed planes, rebuilt by the first call after the display changes;
+    // getDisplayPlane() returns the packed storage itself.
+    const std::array<std::uint8_t, FRAME_BUFFER_SIZE>& getFrameBuffer() const;
+    const DisplayPlane& getDisplayPlane(std::uint8_t plane) const;
+    bool isHighResolution() const;
+    std::uint16_t getDisplayWidth() const;
+    std::uint16_t getDisplayHeight() const;
+    void setPixel(std::uint16_t x, std::uint16_t y, std::uint8_t value);
+    std::uint8_t getPixel(std::uint16_t x, std::uint16_t y) const;
+    // Planes that drawing, clearing and scrolling affect; always 1 outside XO-CHIP
+    std::uint8_t getSelectedPlanes() const;
+    // Rows changed since acknowledgeDirtyRows(), for presenting only what
+    // changed. Rows are in the current resolution; a resolution switch or a
+    // clear marks the whole display. Independent of the draw flag.
+    RowMask getDirtyRows() const;
+    RowRanges getDirtyRowRanges() const;
+    void acknowledgeDirtyRows();
+
+    // XO-CHIP audio. The pattern's bits are played most significant first at
+    // getAudioSampleRate() samples per second while the sound timer runs.
+    const std::array<std::uint8_t, AUDIO_PATTERN_SIZE>& getAudioPattern() const;
+    std::uint8_t getAudioPitch() const;
+    double getAudioSampleRate() const;
+
+    // Keyboard access
+    void setKeyState(std::uint8_t key, bool pressed);
+    bool isKeyPressed(std::uint8_t key) const;
+
+    // Error handling. The message is formatted from the record on each call.
     ErrorCode getLastError() const;
+    const ErrorRecord& getLastErrorRecord() const;
     const std::string& getLastErrorMessage() const;
+
+    // Logging. Messages go to defaultLogger() unless another logger is given;
+    // pass a NullLogger to silence an instance. The logger must outlive it.
+    void setLogger(Logger& logger);
+    Logger& getLogger() const;
     // Setters
     void setMemory(std::uint16_t address, std::uint8_t value);
     void setProgramCounter(std::uint16_t address);
@@ -65,51 +374,389 @@ class Chip8 {
     std::uint8_t getSoundTimer() const;
     bool getDrawFlag() const;
 
+    // Everything a program can observe or change: memory, registers, the
+    // stack, timers, the display, the keypad and the random generator, so a
+    // restored snapshot replays the same CXNN values. It is trivially
+    // copyable, so a snapshot is one block copy. Clock settings, breakpoints,
+    // the logger and the last error belong to the host and are not part of it.
+    struct MachineState {
+        std::array<std::uint8_t, MEMORY_SIZE> memory;
+        std::array<std::uint8_t, REGISTER_COUNT> registers;
+        std::array<std::uint16_t, STACK_SIZE> stack;
+        std::array<DisplayPlane, PLANE_COUNT> displayPlanes;
+        std::array<std::uint8_t, KEYBOARD_SIZE> keyboard;
+        // Kept across init() and loadRom(), like the HP 48 flags they model
+        std::array<std::uint8_t, FLAG_REGISTER_COUNT> flagRegisters;
+        std::array<std::uint8_t, AUDIO_PATTERN_SIZE> audioPattern;
+
+        std::uint16_t indexRegister;
+        std::uint8_t stackPointer;
+        std::uint8_t delayTimer;
+        std::uint8_t soundTimer;
+        std::uint16_t programCounter;
+        std::uint16_t opcode;
+        bool drawFlag;
+        bool highResolution;
+        std::uint8_t planes;
+        std::uint8_t audioPitch;
+        std::uint32_t timerPhase;  // CPU clock progress towards the next timer tick
+        Rng random;
+    };
+    static_assert(std::is_trivially_copyable_v<MachineState>);
+
+    // Snapshots. loadState() only drops decoded and compiled code for memory
+    // that differs from the snapshot, so restoring a snapshot of the running
+    // program leaves every cache warm. It clears the last error and marks the
+    // whole display dirty.
+    void saveState(MachineState& state) const;
+    void loadState(const MachineState& state);
+
+    // Versioned little-endian encoding of the machine state, the same on every
+    // host and build. deserializeState() accepts STATE_VERSION and earlier
+    // encodings for this profile's memory size, keeping the current generator
+    // for version 1; on failure it returns false and leaves the emulator
+    // unchanged. The generator's words are stored as they are, so a state is
+    // only meaningful to an emulator with the same Rng.
+    std::vector<std::uint8_t> serializeState() const;
+    bool deserializeState(const std::vector<std::uint8_t>& data);
+
   private:
-    // Core emulator state
-    std::array<std::uint8_t, MEMORY_SIZE> memory_;
-    std::array<std::uint8_t, REGISTER_COUNT> registers_;
-    std::array<std::uint16_t, STACK_SIZE> stack_;
-    std::array<std::uint8_t, DISPLAY_SIZE> frameBuffer_;
-    std::array<std::uint8_t, KEYBOARD_SIZE> keyboard_;
-
-    std::uint16_t indexRegister_;
-    std::uint8_t stackPointer_;
-    std::uint8_t delayTimer_;
-    std::uint8_t soundTimer_;
-    std::uint16_t programCounter_;
-    std::uint16_t opcode_;
-    bool drawFlag_;
+    MachineState state_;
 
     // Error handling
-    ErrorCode lastError_;
-    std::string lastErrorMessage_;
+    ErrorRecord lastError_;
+    mutable std::string lastErrorMessage_;  // Formatted by getLastErrorMessage()
+    std::string romPath_;                   // Last path passed to loadRom(), for messages
+    Logger* logger_;
+
+    RowMask dirtyRows_;
+    // Byte-per-pixel copy of the display for getFrameBuffer()
+    mutable std::array<std::uint8_t, FRAME_BUFFER_SIZE> frameBufferView_;
+    mutable bool frameBufferViewStale_;
+
+    // Decoded instruction cache. Every address is decoded at most once into an
+    // operation plus pre-extracted operand fields; entries are tagged with the
+    // generation they were decoded in so the whole cache can be dropped in O(1).
+    // Writes to memory invalidate every entry whose instruction or superinstruction
+    // covers that byte.
+    enum class Operation : std::uint8_t {
+        Op00E0,
+        Op00EE,
+        Op1NNN,
+        Op2NNN,
+        Op3XNN,
+        Op4XNN,
+        Op5XY0,
+        Op6XNN,
+        Op7XNN,
+        Op8XY0,
+        Op8XY1,
+        Op8XY2,
+        Op8XY3,
+        Op8XY4,
+        Op8XY5,
+        Op8XY6,
+        Op8XY7,
+        Op8XYE,
+        Op9XY0,
+        OpANNN,
+        OpBNNN,
+        OpCXNN,
+        OpDXYN,
+        OpEX9E,
+        OpEXA1,
+        OpFX07,
+        OpFX0A,
+        OpFX15,
+        OpFX18,
+        OpFX1E,
+        OpFX29,
+        OpFX33,
+        OpFX55,
+        OpFX65,
+        // SUPER-CHIP. DXY0 (16x16 sprites) is handled by OpDXYN.
+        Op00CN,
+        Op00FB,
+        Op00FC,
+        Op00FD,
+        Op00FE,
+        Op00FF,
+        OpFX30,
+        OpFX75,
+        OpFX85,
+        // XO-CHIP. F000 NNNN is one 4-byte instruction; its decoded nnn holds NNNN.
+        OpF000,
+        OpFN01,
+        Op5XY2,
+        Op5XY3,
+        OpF002,
+        OpFX3A,
+        Op00DN,
+        // Superinstructions. Only batch runs dispatch on these, through the
+        // fused field; each retires every instruction of its sequence.
+        OpANNN_DXYN,       // Point I at a sprite and draw it
+        Op6XNN_6XNN,       // Load two registers, e.g. sprite coordinates
+        Op7XNN_3XNN,       // Step a loop counter and test it
+        Op7XNN_4XNN,       // Step a loop counter and test it
+        OpFX07_3X00_1NNN,  // Poll the delay timer until it expires
+        // Idle loops. These skip ahead over the cycles the loop would spend
+        // spinning, up to the end of the run's budget.
+        OpIdle1NNN,            // Jump to self
+        OpIdleFX0A,            // Wait for a key press
+        OpIdleFX07_3X00_1NNN,  // Delay-timer wait that jumps back to its FX07
+        Unknown
+    };
+
+    struct DecodedInstruction {
+        std::uint16_t opcode;
+        std::uint16_t nnn;
+        std::uint16_t generation;
+        Operation operation;
+        Operation fused;  // Superinstruction starting here, otherwise operation
+        std::uint8_t nn;
+        // 4-bit fields let the compiler see that register indices stay below 16
+        std::uint8_t x : 4;
+        std::uint8_t y : 4;
+        std::uint8_t n : 4;
+    };
+
+    // Tail-call backend: one entry per operation, in Operation order
+    using OpcodeHandler = void (BasicChip8::*)(const DecodedInstruction&);
+    using FusedHandler = std::uint32_t (BasicChip8::*)(const DecodedInstruction&, std::uint32_t);
+    using TailCallHandler = std::uint32_t (*)(BasicChip8&, const DecodedInstruction&, std::uint32_t,
+                                              std::uint32_t);
+    static constexpr std::size_t OPERATION_COUNT = static_cast<std::size_t>(Operation::Unknown) + 1;
+    static const std::array<TailCallHandler, OPERATION_COUNT> TAIL_CALL_HANDLERS;
+
+    template <OpcodeHandler Handler>
+    static std::uint32_t tailCallStep(BasicChip8& self, const DecodedInstruction& instr,
+                                      std::uint32_t executed, std::uint32_t count);
+    template <FusedHandler Handler>
+    static std::uint32_t tailCallFusedStep(BasicChip8& self, const DecodedInstruction& instr,
+                                           std::uint32_t executed, std::uint32_t count);
+    static std::uint32_t tailCallDispatch(BasicChip8& self, const DecodedInstruction& instr,
+                                          std::uint32_t executed, std::uint32_t count);
+
+    std::array<DecodedInstruction, MEMORY_SIZE> decodeCache_;
+    std::uint16_t decodeGeneration_;
+
+    // Longest superinstruction, in instructions
+    static constexpr std::uint16_t MAX_FUSED_LENGTH = 3;
+
+    static DecodedInstruction decode(std::uint16_t opcode);
+    Operation fuse(const DecodedInstruction& instr, std::uint16_t address) const;
+    const DecodedInstruction& fetchDecoded(std::uint16_t address);
+    const DecodedInstruction& fetchFusedPart();
+    void execute(const DecodedInstruction& instr);
+    std::uint32_t executeFused(const DecodedInstruction& instr, std::uint32_t budget);
+    void updateTimers();
+    void advanceTimers(std::uint32_t cycles);
+    void applyTimerTicks(std::uint64_t ticks);
+    void invalidateDecodeCache();
+    void invalidateDecoded(std::uint16_t address, std::uint16_t count);
+
+    // Basic-block translator. A block is a run of decoded instructions that ends
+    // at a control transfer (1NNN/2NNN/00EE/BNNN/skips), at FX0A, or at an
+    // instruction that writes memory. Each block remembers the blocks it last
+    // continued into so hot loops chain without touching the lookup table.
+    static constexpr std::uint16_t MAX_BLOCK_LENGTH = 64;
+    static constexpr std::uint16_t NO_BLOCK = 0xFFFF;
+    static constexpr std::size_t MAX_TRANSLATED_INSTRUCTIONS = 1u << 16;
+
+    struct BlockLink {
+        std::uint16_t target;
+        std::uint16_t block;
+    };
+
+    struct TranslatedBlock {
+        std::uint16_t startAddress;
+        std::uint32_t endAddress;  // One past the last byte covered
+        std::uint32_t codeOffset;
+        std::uint16_t codeLength;
+        bool valid;
+        std::uint8_t nextLink;
+        std::array<BlockLink, 2> links;
+    };
+
+    Backend backend_;
+    std::vector<TranslatedBlock> blocks_;
+    std::vector<DecodedInstruction> blockCode_;
+    std::array<std::uint16_t, MEMORY_SIZE> blockLookup_;
+    std::bitset<MEMORY_SIZE> translatedBytes_;
+
+    // Batch run state. Handlers report stop events with raiseStop(); only the
+    // events enabled for the current run are latched in pendingStops_.
+    static constexpr std::uint8_t STOP_ERROR = 1 << 0;
+    static constexpr std::uint8_t STOP_DRAW = 1 << 1;
+    static constexpr std::uint8_t STOP_KEY_WAIT = 1 << 2;
+    static constexpr std::uint8_t STOP_BREAKPOINT = 1 << 3;
+
+    std::uint8_t stopMask_;
+    std::uint8_t pendingStops_;
+    std::uint32_t cyclesPerFrame_;
+
+    // Timer clock divider: each instruction adds timerStep_ to the state's
+    // timerPhase and the timers tick whenever it reaches timerPeriod_. With an
+    // unthrottled CPU the step is 0 and only tickTimers() ticks them.
+    std::uint32_t cpuFrequency_;
+    std::uint32_t timerStep_;
+    std::uint32_t timerPeriod_;
+
+    std::bitset<MEMORY_SIZE> breakpoints_;
+    bool hasBreakpoints_;
+    bool fusionEnabled_;
+    // Runs dispatch on superinstructions while fewer cycles than this have run
+    std::uint32_t fusionLimit_;
+
+    // Attached ahead-of-time code. A block stays valid until a write lands in
+    // the bytes it was compiled from.
+    friend class Chip8Aot;
+    const CompiledRom* compiledRom_;
+    std::bitset<MEMORY_SIZE> compiledValid_;  // Indexed by block start address
+    std::bitset<MEMORY_SIZE> compiledBytes_;
+
+    std::uint32_t runCompiled(std::uint32_t count);
+    void invalidateCompiledBlocks(std::uint32_t first, std::uint32_t last);
+
+    RunResult run(std::uint32_t count, std::uint8_t stopMask);
+    bool isWaitingForKey();
+    void raiseStop(std::uint8_t event);
+    bool readyToExecute(std::uint32_t executed);
+
+    static bool endsBlock(Operation operation);
+    std::uint32_t runSwitch(std::uint32_t count);
+    std::uint32_t runThreaded(std::uint32_t count);
+    std::uint32_t runTailCall(std::uint32_t count);
+    std::uint32_t runTranslatedBlocks(std::uint32_t count);
+    std::uint16_t findOrTranslateBlock(std::uint16_t address);
+    std::uint16_t translateBlock(std::uint16_t address);
+    std::uint16_t followBlockLink(std::uint16_t from, std::uint16_t address);
+    void flushTranslatedBlocks();
+    void invalidateTranslatedBlocks(std::uint32_t first, std::uint32_t last);
 
     // Opcode handler methods
-    void handleOpcode0xxx();
-    void handleOpcode1xxx();
-    void handleOpcode2xxx();
-    void handleOpcode3xxx();
-    void handleOpcode4xxx();
-    void handleOpcode5xxx();
-    void handleOpcode6xxx();
-    void handleOpcode7xxx();
-    void handleOpcode8xxx();
-    void handleOpcode9xxx();
-    void handleOpcodeAxxx();
-    void handleOpcodeBxxx();
-    void handleOpcodeCxxx();
-    void handleOpcodeDxxx();
-    void handleOpcodeExxx();
-    void handleOpcodeFxxx();
+    void handleOpcode00E0(const DecodedInstruction& instr);
+    void handleOpcode00EE(const DecodedInstruction& instr);
+    void handleOpcode1NNN(const DecodedInstruction& instr);
+    void handleOpcode2NNN(const DecodedInstruction& instr);
+    void handleOpcode3XNN(const DecodedInstruction& instr);
+    void handleOpcode4XNN(const DecodedInstruction& instr);
+    void handleOpcode5XY0(const DecodedInstruction& instr);
+    void handleOpcode6XNN(const DecodedInstruction& instr);
+    void handleOpcode7XNN(const DecodedInstruction& instr);
+    void handleOpcode8XY0(const DecodedInstruction& instr);
+    void handleOpcode8XY1(const DecodedInstruction& instr);
+    void handleOpcode8XY2(const DecodedInstruction& instr);
+    void handleOpcode8XY3(const DecodedInstruction& instr);
+    void handleOpcode8XY4(const DecodedInstruction& instr);
+    void handleOpcode8XY5(const DecodedInstruction& instr);
+    void handleOpcode8XY6(const DecodedInstruction& instr);
+    void handleOpcode8XY7(const DecodedInstruction& instr);
+    void handleOpcode8XYE(const DecodedInstruction& instr);
+    void handleOpcode9XY0(const DecodedInstruction& instr);
+    void handleOpcodeANNN(const DecodedInstruction& instr);
+    void handleOpcodeBNNN(const DecodedInstruction& instr);
+    void handleOpcodeCXNN(const DecodedInstruction& instr);
+    void handleOpcodeDXYN(const DecodedInstruction& instr);
+    void handleOpcodeEX9E(const DecodedInstruction& instr);
+    void handleOpcodeEXA1(const DecodedInstruction& instr);
+    void handleOpcodeFX07(const DecodedInstruction& instr);
+    void handleOpcodeFX0A(const DecodedInstruction& instr);
+    void handleOpcodeFX15(const DecodedInstruction& instr);
+    void handleOpcodeFX18(const DecodedInstruction& instr);
+    void handleOpcodeFX1E(const DecodedInstruction& instr);
+    void handleOpcodeFX29(const DecodedInstruction& instr);
+    void handleOpcodeFX33(const DecodedInstruction& instr);
+    void handleOpcodeFX55(const DecodedInstruction& instr);
+    void handleOpcodeFX65(const DecodedInstruction& instr);
+    void handleOpcode00CN(const DecodedInstruction& instr);
+    void handleOpcode00FB(const DecodedInstruction& instr);
+    void handleOpcode00FC(const DecodedInstruction& instr);
+    void handleOpcode00FD(const DecodedInstruction& instr);
+    void handleOpcode00FE(const DecodedInstruction& instr);
+    void handleOpcode00FF(const DecodedInstruction& instr);
+    void handleOpcodeFX30(const DecodedInstruction& instr);
+    void handleOpcodeFX75(const DecodedInstruction& instr);
+    void handleOpcodeFX85(const DecodedInstruction& instr);
+    void handleOpcodeF000(const DecodedInstruction& instr);
+    void handleOpcodeFN01(const DecodedInstruction& instr);
+    void handleOpcode5XY2(const DecodedInstruction& instr);
+    void handleOpcode5XY3(const DecodedInstruction& instr);
+    void handleOpcodeF002(const DecodedInstruction& instr);
+    void handleOpcodeFX3A(const DecodedInstruction& instr);
+    void handleOpcode00DN(const DecodedInstruction& instr);
+    void handleUnknownOpcode(const DecodedInstruction& instr);
+
+    // Superinstruction handlers return the number of instructions retired. The
+    // budget is the rest of the run, at least MAX_FUSED_LENGTH cycles.
+    std::uint32_t handleFusedANNN_DXYN(const DecodedInstruction& instr, std::uint32_t budget);
+    std::uint32_t handleFused6XNN_6XNN(const DecodedInstruction& instr, std::uint32_t budget);
+    std::uint32_t handleFused7XNN_3XNN(const DecodedInstruction& instr, std::uint32_t budget);
+    std::uint32_t handleFused7XNN_4XNN(const DecodedInstruction& instr, std::uint32_t budget);
+    std::uint32_t handleFusedFX07_3X00_1NNN(const DecodedInstruction& instr, std::uint32_t budget);
+    std::uint32_t handleIdle1NNN(const DecodedInstruction& instr, std::uint32_t budget);
+    std::uint32_t handleIdleFX0A(const DecodedInstruction& instr, std::uint32_t budget);
+    std::uint32_t handleIdleFX07_3X00_1NNN(const DecodedInstruction& instr, std::uint32_t budget);
+
+    // Display helpers. Sprites are Width pixels wide, Width / 8 bytes per row;
+    // drawSprite() returns false after a sprite read past the end of memory.
+    // Selected planes take consecutive sprite images, one per plane. Each
+    // sprite row becomes a two-word mask with one shift; drawing is an XOR and
+    // the collision test an AND per word. Rows it changes are marked dirty.
+    template <std::uint8_t Width>
+    bool drawSprite(const DecodedInstruction& instr, std::uint8_t height);
+    void setResolution(bool high);
+    // Runs a scroll on each selected plane
+    template <typename Scroll>
+    void scrollDisplay(Scroll scroll);
+    // Sets the draw flag and marks the byte view stale
+    void displayChanged();
+    // Every row of the current resolution, for changes to the whole display
+    RowMask visibleRows() const;
+    std::uint8_t selectedPlanes() const { return Quirks::XO_CHIP ? state_.planes : 1; }
+    // Bytes a taken skip advances the program counter
+    std::uint16_t skipDistance() const;
 
     // Utility methods
-    void setError(ErrorCode error, const std::string& message);
+    // Copies a ROM image whose size loadRom() has checked into memory
+    void installRom(const std::uint8_t* rom, std::size_t size);
+    void setError(ErrorCode error, ErrorSite site, std::uint32_t first = 0,
+                  std::uint32_t second = 0);
     void clearError();
     bool isValidMemoryAddress(std::uint16_t address) const;
     bool isValidRegisterIndex(std::uint8_t index) const;
-    void logError(const std::string& message) const;
-    void logWarning(const std::string& message) const;
-    void logInfo(const std::string& message) const;
+
+    // Operand checks inside opcode handlers. Both are constant true in the
+    // trusted core, which indexes memory through memoryIndex() instead.
+    static constexpr std::uint16_t ADDRESS_MASK = MEMORY_SIZE - 1;
+
+    static constexpr bool isValidRegisterField(std::uint8_t index) {
+        return !Policy::CHECKED || index < REGISTER_COUNT;
+    }
+    static constexpr bool isAddressInRange(std::uint32_t address) {
+        return !Policy::CHECKED || address < MEMORY_SIZE;
+    }
+    static constexpr std::uint32_t memoryIndex(std::uint32_t address) {
+        return Policy::CHECKED ? address : address & ADDRESS_MASK;
+    }
+    void log(LogLevel level, std::string_view message) const;
 };
+
+// Every policy and quirk profile pair is compiled once, in chip8.cpp, with the
+// default generator; the default profile is also compiled with PCG32
+extern template class BasicChip8<CheckedPolicy, DefaultQuirks>;
+extern template class BasicChip8<CheckedPolicy, Chip8Quirks>;
+extern template class BasicChip8<CheckedPolicy, SuperChipQuirks>;
+extern template class BasicChip8<CheckedPolicy, XoChipQuirks>;
+extern template class BasicChip8<TrustedPolicy, DefaultQuirks>;
+extern template class BasicChip8<TrustedPolicy, Chip8Quirks>;
+extern template class BasicChip8<TrustedPolicy, SuperChipQuirks>;
+extern template class BasicChip8<TrustedPolicy, XoChipQuirks>;
+extern template class BasicChip8<CheckedPolicy, DefaultQuirks, Pcg32>;
+
+// The frontend and tests use the checked core; batch runs that only need
+// throughput can use the trusted one.
+using Chip8 = BasicChip8<CheckedPolicy>;
+using TrustedChip8 = BasicChip8<TrustedPolicy>;
+
 #endif
@@ -0,0 +1,175 @@
+#ifndef CHIP8_AOT_H
+#define CHIP8_AOT_H
+
+#include <cstdint>
+
+#include "chip8.h"
+
+// Runtime support for C++ emitted by the chip8-aot tool. Generated code keeps
+// the program counter implicit and batches timer ticks between the points
+// where they are observable, so state is only written back at block
+// boundaries and before calling into the interpreter's handlers. Register
+// operations mirror the handlers in chip8.cpp and must stay bit-exact with them.
+class Chip8Aot {
+  public:
+    static std::uint8_t* registers(Chip8& m) { return m.state_.registers.data(); }
+    static std::uint16_t programCounter(const Chip8& m) { return m.state_.programCounter; }
+
+    // Block entry: the block's bytes are unmodified and the budget covers all of it
+    static bool enter(Chip8& m, std::uint32_t executed, std::uint32_t budget,
+                      std::uint16_t address, std::uint32_t length) {
+        if (budget - executed < length || !m.compiledValid_.test(address)) {
+            m.state_.programCounter = address;
+            return false;
+        }
+        return true;
+    }
+
+    static bool valid(const Chip8& m, std::uint16_t block) { return m.compiledValid_.test(block); }
+
+    static std::uint32_t leave(Chip8& m, std::uint32_t executed, std::uint16_t address) {
+        m.state_.programCounter = address;
+        return executed;
+    }
+
+    // Counts count instructions as executed and runs the timer clock for them
+    static void retire(Chip8& m, std::uint32_t& executed, std::uint32_t count,
+                       std::uint16_t lastOpcode) {
+        executed += count;
+        m.state_.opcode = lastOpcode;
+        m.advanceTimers(count);
+    }
+
+    // 1NNN to itself: only the timers change until the run ends
+    static std::uint32_t spin(Chip8& m, std::uint32_t executed, std::uint32_t budget,
+                              std::uint16_t address, std::uint16_t opcode) {
+        m.state_.programCounter = address;
+        m.state_.opcode = opcode;
+        m.advanceTimers(budget - executed);
+        return budget;
+    }
+
+    // Inline operations
+    static void op6XNN(std::uint8_t* v, std::uint8_t x, std::uint8_t nn) { v[x] = nn; }
+    static void op7XNN(std::uint8_t* v, std::uint8_t x, std::uint8_t nn) { v[x] += nn; }
+    static void op8XY0(std::uint8_t* v, std::uint8_t x, std::uint8_t y) { v[x] = v[y]; }
+    static void op8XY1(std::uint8_t* v, std::uint8_t x, std::uint8_t y) { v[x] |= v[y]; }
+    static void op8XY2(std::uint8_t* v, std::uint8_t x, std::uint8_t y) { v[x] &= v[y]; }
+    static void op8XY3(std::uint8_t* v, std::uint8_t x, std::uint8_t y) { v[x] ^= v[y]; }
+
+    static void op8XY4(std::uint8_t* v, std::uint8_t x, std::uint8_t y) {
+        v[0xF] = v[y] > 0xFF - v[x] ? 1 : 0;
+        v[x] += v[y];
+    }
+
+    static void op8XY5(std::uint8_t* v, std::uint8_t x, std::uint8_t y) {
+        v[0xF] = v[x] >= v[y] ? 1 : 0;
+        v[x] -= v[y];
+    }
+
+    static void op8XY6(std::uint8_t* v, std::uint8_t x) {
+        v[0xF] = v[x] & 1;
+        v[x] >>= 1;
+    }
+
+    static void op8XY7(std::uint8_t* v, std::uint8_t x, std::uint8_t y) {
+        v[0xF] = v[y] >= v[x] ? 1 : 0;
+        v[x] = v[y] - v[x];
+    }
+
+    static void op8XYE(std::uint8_t* v, std::uint8_t x) {
+        v[0xF] = v[x] >> 7;
+        v[x] <<= 1;
+    }
+
+    static void opANNN(Chip8& m, std::uint16_t nnn) { m.state_.indexRegister = nnn; }
+    static void opFX07(Chip8& m, std::uint8_t x) { m.state_.registers[x] = m.state_.delayTimer; }
+    static void opFX15(Chip8& m, std::uint8_t x) { m.state_.delayTimer = m.state_.registers[x]; }
+    static void opFX18(Chip8& m, std::uint8_t x) { m.state_.soundTimer = m.state_.registers[x]; }
+    static void opFX1E(Chip8& m, std::uint8_t x) {
+        m.state_.indexRegister += m.state_.registers[x];
+    }
+
+    static bool keyDown(const Chip8& m, std::uint8_t x) {
+        const std::uint8_t key = m.state_.registers[x];
+        return key < Chip8::KEYBOARD_SIZE && m.state_.keyboard[key] != 0;
+    }
+
+    // Operations executed by the interpreter's handlers. Each returns false when
+    // the run has to stop, with the program counter already written back.
+    static bool op00E0(Chip8& m, std::uint32_t& executed, std::uint16_t pc, std::uint16_t opcode) {
+        return call<&Chip8::handleOpcode00E0>(m, executed, pc, opcode);
+    }
+    static bool op00EE(Chip8& m, std::uint32_t& executed, std::uint16_t pc, std::uint16_t opcode) {
+        return call<&Chip8::handleOpcode00EE>(m, executed, pc, opcode);
+    }
+    static bool op2NNN(Chip8& m, std::uint32_t& executed, std::uint16_t pc, std::uint16_t opcode) {
+        return call<&Chip8::handleOpcode2NNN>(m, executed, pc, opcode);
+    }
+    static bool opBNNN(Chip8& m, std::uint32_t& executed, std::uint16_t pc, std::uint16_t opcode) {
+        return call<&Chip8::handleOpcodeBNNN>(m, executed, pc, opcode);
+    }
+    static bool opCXNN(Chip8& m, std::uint32_t& executed, std::uint16_t pc, std::uint16_t opcode) {
+        return call<&Chip8::handleOpcodeCXNN>(m, executed, pc, opcode);
+    }
+    static bool opDXYN(Chip8& m, std::uint32_t& executed, std::uint16_t pc, std::uint16_t opcode) {
+        return call<&Chip8::handleOpcodeDXYN>(m, executed, pc, opcode);
+    }
+    static bool opFX29(Chip8& m, std::uint32_t& executed, std::uint16_t pc, std::uint16_t opcode) {
+        return call<&Chip8::handleOpcodeFX29>(m, executed, pc, opcode);
+    }
+    static bool opFX33(Chip8& m, std::uint32_t& executed, std::uint16_t pc, std::uint16_t opcode) {
+        return call<&Chip8::handleOpcodeFX33>(m, executed, pc, opcode);
+    }
+    static bool opFX55(Chip8& m, std::uint32_t& executed, std::uint16_t pc, std::uint16_t opcode) {
+        return call<&Chip8::handleOpcodeFX55>(m, executed, pc, opcode);
+    }
+    static bool opFX65(Chip8& m, std::uint32_t& executed, std::uint16_t pc, std::uint16_t opcode) {
+        return call<&Chip8::handleOpcodeFX65>(m, executed, pc, opcode);
+    }
+    static bool opUnknown(Chip8& m, std::uint32_t& executed, std::uint16_t pc,
+                          std::uint16_t opcode) {
+        return call<&Chip8::handleUnknownOpcode>(m, executed, pc, opcode);
+    }
+
+    // FX0A without a key press repeats until the run ends, as in the idle skip,
+    // unless the run stops at key waits (all but runCyclesThroughKeyWaits())
+    static bool opFX0A(Chip8& m, std::uint32_t& executed, std::uint32_t budget, std::uint16_t pc,
+                       std::uint16_t opcode) {
+        m.state_.programCounter = pc;
+        m.state_.opcode = opcode;
+        m.handleOpcodeFX0A(instruction(opcode));
+        if (m.pendingStops_ != 0 || m.state_.programCounter != pc) {
+            m.updateTimers();
+            ++executed;
+            return m.pendingStops_ == 0;
+        }
+        m.advanceTimers(budget - executed);
+        executed = budget;
+        return false;
+    }
+
+  private:
+    static Chip8::DecodedInstruction instruction(std::uint16_t opcode) {
+        Chip8::DecodedInstruction instr{};
+        instr.opcode = opcode;
+        instr.nnn = opcode & 0x0FFF;
+        instr.x = (opcode & 0x0F00) >> 8;
+        instr.y = (opcode & 0x00F0) >> 4;
+        instr.n = opcode & 0x000F;
+        instr.nn = opcode & 0x00FF;
+        return instr;
+    }
+
+    template <Chip8::OpcodeHandler Handler>
+    static bool call(Chip8& m, std::uint32_t& executed, std::uint16_t pc, std::uint16_t opcode) {
+        m.state_.programCounter = pc;
+        m.state_.opcode = opcode;
+        (m.*Handler)(instruction(opcode));
+        m.updateTimers();
+        ++executed;
+        return m.pendingStops_ == 0;
+    }
+};
+
+#endif
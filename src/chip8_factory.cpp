@@ -0,0 +1,121 @@
+#include "chip8_factory.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "mapped_file.h"
+
+namespace {
+
+bool isXoChipOpcode(std::uint16_t opcode) {
+    switch (opcode & 0xF00F) {
+        case 0x5002:  // 5XY2 - Save VX..VY
+        case 0x5003:  // 5XY3 - Load VX..VY
+            return true;
+        default:
+            break;
+    }
+    return opcode == 0xF000                 // F000 NNNN - Long index load
+           || opcode == 0xF002              // F002 - Load audio pattern
+           || (opcode & 0xFFF0) == 0x00D0   // 00DN - Scroll up
+           || (opcode & 0xF0FF) == 0xF001   // FN01 - Select planes
+           || (opcode & 0xF0FF) == 0xF03A;  // FX3A - Set pitch
+}
+
+bool isSuperChipOpcode(std::uint16_t opcode) {
+    switch (opcode) {
+        case 0x00FB:  // Scroll right
+        case 0x00FC:  // Scroll left
+        case 0x00FD:  // Exit
+        case 0x00FE:  // Low resolution
+        case 0x00FF:  // High resolution
+            return true;
+        default:
+            break;
+    }
+    return (opcode & 0xFFF0) == 0x00C0      // 00CN - Scroll down
+           || (opcode & 0xF0FF) == 0xF030   // FX30 - Big font
+           || (opcode & 0xF0FF) == 0xF075   // FX75 - Save flags
+           || (opcode & 0xF0FF) == 0xF085;  // FX85 - Load flags
+}
+
+std::string lowercaseExtension(const std::string& path) {
+    const std::size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || path.find_first_of("/\\", dot) != std::string::npos) {
+        return {};
+    }
+    std::string extension = path.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension;
+}
+
+}  // namespace
+
+QuirkProfile detectQuirkProfile(const std::uint8_t* rom, std::size_t size) {
+    // Programs larger than the classic address space only run on XO-CHIP
+    if (size > Chip8Base::MEMORY_SIZE - Chip8Base::ROM_START_ADDRESS) {
+        return QuirkProfile::XoChip;
+    }
+
+    bool superChip = false;
+    for (std::size_t i = 0; i + 1 < size; i += 2) {
+        const auto opcode = static_cast<std::uint16_t>(rom[i] << 8 | rom[i + 1]);
+        if (isXoChipOpcode(opcode)) {
+            return QuirkProfile::XoChip;
+        }
+        superChip = superChip || isSuperChipOpcode(opcode);
+    }
+    return superChip ? QuirkProfile::SuperChip : QuirkProfile::Default;
+}
+
+QuirkProfile detectQuirkProfile(const std::vector<std::uint8_t>& rom) {
+    return detectQuirkProfile(rom.data(), rom.size());
+}
+
+QuirkProfile detectQuirkProfile(const std::string& path) {
+    const std::string extension = lowercaseExtension(path);
+    if (extension == "sc8") {
+        return QuirkProfile::SuperChip;
+    }
+    if (extension == "xo8") {
+        return QuirkProfile::XoChip;
+    }
+
+    // Only the size is needed for a file too large for the classic memory
+    MappedFile file;
+    if (!file.open(path)) {
+        return QuirkProfile::Default;
+    }
+    if (file.size() > Chip8Base::MEMORY_SIZE - Chip8Base::ROM_START_ADDRESS) {
+        return QuirkProfile::XoChip;
+    }
+    if (!file.load()) {
+        return QuirkProfile::Default;
+    }
+    return detectQuirkProfile(file.data(), file.size());
+}
+
+bool parseQuirkProfile(std::string_view name, QuirkProfile& profile) {
+    for (QuirkProfile candidate : {QuirkProfile::Default, QuirkProfile::Chip8,
+                                   QuirkProfile::SuperChip, QuirkProfile::XoChip}) {
+        if (name == getQuirkProfileName(candidate)) {
+            profile = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* getQuirkProfileName(QuirkProfile profile) {
+    switch (profile) {
+        case QuirkProfile::Chip8:
+            return "chip8";
+        case QuirkProfile::SuperChip:
+            return "schip";
+        case QuirkProfile::XoChip:
+            return "xochip";
+        default:
+            return "default";
+    }
+}
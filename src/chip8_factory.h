@@ -0,0 +1,60 @@
+#ifndef CHIP8_FACTORY_H
+#define CHIP8_FACTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "chip8.h"
+
+enum class QuirkProfile : std::uint8_t { Default, Chip8, SuperChip, XoChip };
+
+// An emulator whose quirk profile is picked at run time. Calls go through
+// std::visit once; everything below that runs the instantiation for the
+// profile, with no quirk checks in the instruction handlers.
+template <typename Policy>
+using AnyBasicChip8 =
+    std::variant<BasicChip8<Policy, DefaultQuirks>, BasicChip8<Policy, Chip8Quirks>,
+                 BasicChip8<Policy, SuperChipQuirks>, BasicChip8<Policy, XoChipQuirks>>;
+using AnyChip8 = AnyBasicChip8<CheckedPolicy>;
+using AnyTrustedChip8 = AnyBasicChip8<TrustedPolicy>;
+
+// Emulators are large, so they are built in place on the heap
+template <typename Policy = CheckedPolicy>
+std::unique_ptr<AnyBasicChip8<Policy>> makeChip8(
+    QuirkProfile profile, Chip8Base::Backend backend = Chip8Base::Backend::Switch,
+    Logger& logger = defaultLogger()) {
+    using Any = AnyBasicChip8<Policy>;
+    switch (profile) {
+        case QuirkProfile::Chip8:
+            return std::make_unique<Any>(std::in_place_type<BasicChip8<Policy, Chip8Quirks>>,
+                                         backend, logger);
+        case QuirkProfile::SuperChip:
+            return std::make_unique<Any>(std::in_place_type<BasicChip8<Policy, SuperChipQuirks>>,
+                                         backend, logger);
+        case QuirkProfile::XoChip:
+            return std::make_unique<Any>(std::in_place_type<BasicChip8<Policy, XoChipQuirks>>,
+                                         backend, logger);
+        default:
+            return std::make_unique<Any>(std::in_place_type<BasicChip8<Policy, DefaultQuirks>>,
+                                         backend, logger);
+    }
+}
+
+// Guesses the profile a ROM was written for. A .sc8 or .xo8 extension decides
+// it; otherwise the ROM is scanned for SUPER-CHIP or XO-CHIP only opcodes, and
+// anything without them gets the default profile. Unreadable files also get
+// the default, so loadRom() reports the error.
+QuirkProfile detectQuirkProfile(const std::uint8_t* rom, std::size_t size);
+QuirkProfile detectQuirkProfile(const std::vector<std::uint8_t>& rom);
+QuirkProfile detectQuirkProfile(const std::string& path);
+
+// Accepts "default", "chip8", "schip" and "xochip"
+bool parseQuirkProfile(std::string_view name, QuirkProfile& profile);
+const char* getQuirkProfileName(QuirkProfile profile);
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef CHIP8_FRAME_EXCHANGE_H
+#define CHIP8_FRAME_EXCHANGE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free hand-off between an emulation thread and a render/input thread.
+// Neither side ever blocks the other, so a slow present cannot stall the
+// emulated CPU and a busy emulator cannot delay a present.
+
+// Single-producer, single-consumer triple buffer. The producer fills
+// writeBuffer() and publishes it; the consumer picks up the newest published
+// value with update(). Each side owns one slot and the third is swapped
+// through an atomic, so the producer never waits for the consumer and frames
+// the consumer was too slow for are dropped rather than queued.
+template <typename T>
+class TripleBuffer {
+  public:
+    // Producer side. The buffer is whatever slot came back from the last
+    // swap, so it must be filled completely before each publish().
+    T& writeBuffer() { return slots_[writeIndex_]; }
+    void publish() {
+        const std::uint8_t previous =
+            middle_.exchange(writeIndex_ | FRESH, std::memory_order_acq_rel);
+        writeIndex_ = previous & INDEX_MASK;
+    }
+
+    // Consumer side. Returns false, keeping readBuffer(), when nothing was
+    // published since the last update().
+    bool update() {
+        if ((middle_.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        const std::uint8_t previous = middle_.exchange(readIndex_, std::memory_order_acq_rel);
+        readIndex_ = previous & INDEX_MASK;
+        return true;
+    }
+    const T& readBuffer() const { return slots_[readIndex_]; }
+
+  private:
+    static constexpr std::uint8_t INDEX_MASK = 3;
+    static constexpr std::uint8_t FRESH = 4;  // The middle slot holds an unread value
+
+    std::array<T, 3> slots_{};
+    alignas(64) std::atomic<std::uint8_t> middle_{1};
+    alignas(64) std::uint8_t writeIndex_ = 0;  // Producer only
+    alignas(64) std::uint8_t readIndex_ = 2;   // Consumer only
+};
+
+// The 16-key keypad as one atomic bitmask, bit N for key N. The UI thread
+// sets keys as events arrive and the emulation thread copies the whole pad
+// into the emulator between batches, so key state needs no lock and no queue.
+class AtomicKeypad {
+  public:
+    static constexpr std::uint8_t KEY_COUNT = 16;
+
+    void setKeyState(std::uint8_t key, bool pressed) {
+        if (key >= KEY_COUNT) {
+            return;
+        }
+        const auto bit = static_cast<std::uint16_t>(1u << key);
+        if (pressed) {
+            keys_.fetch_or(bit, std::memory_order_relaxed);
+        } else {
+            keys_.fetch_and(static_cast<std::uint16_t>(~bit), std::memory_order_relaxed);
+        }
+    }
+    bool isKeyPressed(std::uint8_t key) const {
+        return key < KEY_COUNT && (keys_.load(std::memory_order_relaxed) >> key & 1) != 0;
+    }
+    std::uint16_t getKeys() const { return keys_.load(std::memory_order_relaxed); }
+
+    // Works with any types that have setKeyState(), such as an emulator and
+    // an InputRecorder. All targets get the same reading of the pad.
+    template <typename... Targets>
+    void applyTo(Targets&... targets) const {
+        const std::uint16_t keys = getKeys();
+        for (std::uint8_t key = 0; key < KEY_COUNT; ++key) {
+            (targets.setKeyState(key, (keys >> key & 1) != 0), ...);
+        }
+    }
+
+  private:
+    std::atomic<std::uint16_t> keys_{0};
+};
+
+#endif
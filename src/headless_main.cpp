@@ -0,0 +1,225 @@
+// chip8-headless: runs a ROM with no display, audio or host input, for CI and
+// batch machines. Runs a number of cycles or 60 Hz frames, optionally
+// replaying a recording made with `chip8 --record`, then prints throughput
+// and a hash of the final framebuffer. The run is deterministic: the same
+// ROM, options and recording always give the same hash.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include "chip8.h"
+#include "chip8_factory.h"
+#include "input_recording.h"
+
+namespace {
+
+// Exit statuses besides EXIT_SUCCESS and EXIT_FAILURE (bad arguments or an
+// unreadable ROM or recording)
+constexpr int EXIT_EMULATOR_ERROR = 2;  // An instruction failed
+constexpr int EXIT_STALLED = 3;         // Stopped early, such as at a key wait no input ends
+
+// Ten seconds of emulated time
+constexpr std::uint64_t DEFAULT_FRAMES = 10 * Chip8::TIMER_FREQUENCY;
+
+constexpr std::uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325;
+constexpr std::uint64_t FNV_PRIME = 0x100000001B3;
+
+void printUsage(std::string_view programName) {
+    std::cerr << "Usage: " << programName << " [options] <rom_file>" << std::endl;
+    std::cerr << "  --quirks=NAME: default, chip8, schip or xochip (detected from the ROM if"
+              << " omitted)" << std::endl;
+    std::cerr << "  --backend=NAME: switch, threaded, tailcall or blocks (default threaded)"
+              << std::endl;
+    std::cerr << "  --cycles=N: instructions to run" << std::endl;
+    std::cerr << "  --frames=N: 60 Hz frames to run (default " << DEFAULT_FRAMES << ")"
+              << std::endl;
+    std::cerr << "  --cpu=HZ: instructions per emulated second, at least 60 (default "
+              << Chip8::DEFAULT_CPU_FREQUENCY << ")" << std::endl;
+    std::cerr << "  --seed=N: random seed (default 0)" << std::endl;
+    std::cerr << "  --input=FILE: replay a recording from chip8 --record, which sets the quirks,"
+              << " cpu and seed, and by default the length" << std::endl;
+    std::cerr << "Exit status: 0 when the run completes, 1 for bad arguments or files, "
+              << EXIT_EMULATOR_ERROR << " on an emulator error, " << EXIT_STALLED
+              << " when the ROM stalls" << std::endl;
+    std::cerr << "Example: " << programName << " --frames=3600 --input=game.c8in roms/game.ch8"
+              << std::endl;
+}
+
+bool parseNumber(const char* text, std::uint64_t& number) {
+    // strtoull() would skip leading whitespace and accept a sign
+    if (*text < '0' || *text > '9') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long value = std::strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE) {
+        return false;
+    }
+    number = value;
+    return true;
+}
+
+bool parseBackend(std::string_view name, Chip8Base::Backend& backend) {
+    if (name == "switch") {
+        backend = Chip8Base::Backend::Switch;
+    } else if (name == "threaded") {
+        backend = Chip8Base::Backend::Threaded;
+    } else if (name == "tailcall") {
+        backend = Chip8Base::Backend::TailCall;
+    } else if (name == "blocks") {
+        backend = Chip8Base::Backend::BlockTranslator;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// FNV-1a over the byte-per-pixel framebuffer and the resolution
+template <typename Emulator>
+std::uint64_t hashFrameBuffer(const Emulator& emulator) {
+    std::uint64_t hash = FNV_OFFSET_BASIS;
+    for (std::uint8_t pixel : emulator.getFrameBuffer()) {
+        hash = (hash ^ pixel) * FNV_PRIME;
+    }
+    return (hash ^ static_cast<std::uint8_t>(emulator.isHighResolution())) * FNV_PRIME;
+}
+
+template <typename Emulator>
+int runHeadless(Emulator& emulator, const std::string& romPath,
+                const InputRecording& recording) {
+    if (!emulator.loadRom(romPath)) {
+        std::cerr << emulator.getLastErrorMessage() << std::endl;
+        return EXIT_FAILURE;
+    }
+    BasicInputReplayer<Emulator> replayer(recording);
+    replayer.start(emulator);
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const Chip8Base::StopReason reason = replayer.runToEnd(emulator);
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    const double seconds = std::max(elapsed.count(), 1e-9);
+    const auto cycles = static_cast<double>(replayer.getCycle());
+    const double frames = cycles * Chip8::TIMER_FREQUENCY / recording.cpuFrequency;
+    std::cout << "profile: " << getQuirkProfileName(recording.profile) << std::endl;
+    std::cout << "cycles: " << replayer.getCycle() << std::endl;
+    std::cout << "frames: " << static_cast<std::uint64_t>(frames) << std::endl;
+    std::cout << "key events: " << recording.events.size() << std::endl;
+    std::cout << "seconds: " << seconds << std::endl;
+    std::cout << "instructions per second: " << static_cast<std::uint64_t>(cycles / seconds)
+              << std::endl;
+    std::cout << "frames per second: " << static_cast<std::uint64_t>(frames / seconds)
+              << std::endl;
+    std::cout << "framebuffer hash: " << std::hex << std::setw(16) << std::setfill('0')
+              << hashFrameBuffer(emulator) << std::dec << std::endl;
+
+    if (reason == Chip8Base::StopReason::Error) {
+        std::cerr << "Emulator error: " << emulator.getLastErrorMessage() << std::endl;
+        return EXIT_EMULATOR_ERROR;
+    }
+    if (!replayer.isFinished()) {
+        std::cerr << "Stalled at cycle " << replayer.getCycle() << std::endl;
+        return EXIT_STALLED;
+    }
+    return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const char* romPath = nullptr;
+    const char* quirksName = nullptr;
+    const char* backendName = nullptr;
+    const char* cyclesText = nullptr;
+    const char* framesText = nullptr;
+    const char* cpuText = nullptr;
+    const char* seedText = nullptr;
+    const char* inputPath = nullptr;
+    bool validArguments = true;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument = argv[i];
+        const auto option = [&](std::string_view prefix, const char*& value) {
+            if (argument.rfind(prefix, 0) != 0) {
+                return false;
+            }
+            value = argv[i] + prefix.size();
+            return true;
+        };
+        if (option("--quirks=", quirksName) || option("--backend=", backendName) ||
+            option("--cycles=", cyclesText) || option("--frames=", framesText) ||
+            option("--cpu=", cpuText) || option("--seed=", seedText) ||
+            option("--input=", inputPath)) {
+            continue;
+        }
+        if (!romPath && argument.rfind("--", 0) != 0) {
+            romPath = argv[i];
+        } else {
+            validArguments = false;
+        }
+    }
+
+    // A recording decides the profile, clock and seed, so they can't be given
+    // with one; only the length may change
+    InputRecording recording;
+    Chip8Base::Backend backend = Chip8Base::Backend::Threaded;
+    std::uint64_t cycles = 0;
+    std::uint64_t frames = DEFAULT_FRAMES;
+    std::uint64_t cpuFrequency = Chip8::DEFAULT_CPU_FREQUENCY;
+    if (!validArguments || !romPath || (cyclesText && framesText) ||
+        (inputPath && (quirksName || cpuText || seedText)) ||
+        (quirksName && !parseQuirkProfile(quirksName, recording.profile)) ||
+        (backendName && !parseBackend(backendName, backend)) ||
+        (cyclesText && !parseNumber(cyclesText, cycles)) ||
+        (framesText && !parseNumber(framesText, frames)) ||
+        (cpuText && (!parseNumber(cpuText, cpuFrequency) ||
+                     cpuFrequency < Chip8::TIMER_FREQUENCY ||
+                     cpuFrequency > std::numeric_limits<std::uint32_t>::max())) ||
+        (seedText && !parseNumber(seedText, recording.seed))) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (inputPath) {
+        if (!loadRecording(inputPath, recording)) {
+            std::cerr << "Could not read the recording " << inputPath << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (recording.cpuFrequency < Chip8::TIMER_FREQUENCY) {
+            std::cerr << "The recording's CPU frequency is below 60 Hz" << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else {
+        recording.cpuFrequency = static_cast<std::uint32_t>(cpuFrequency);
+        if (!quirksName) {
+            recording.profile = detectQuirkProfile(std::string(romPath));
+        }
+    }
+    // Frames follow the emulated clock, cpu/60 cycles each. The clock may come
+    // from the recording, so --frames is range-checked only now.
+    if (cyclesText) {
+        recording.cycles = cycles;
+    } else if (framesText || !inputPath) {
+        if (frames > std::numeric_limits<std::uint64_t>::max() / recording.cpuFrequency) {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        recording.cycles = frames * recording.cpuFrequency / Chip8::TIMER_FREQUENCY;
+    }
+
+    // Errors are reported from the run's result, so the emulator doesn't log
+    NullLogger logger;
+    const auto emulator = makeChip8(recording.profile, backend, logger);
+    return std::visit(
+        [&](auto& chip8) { return runHeadless(chip8, romPath, recording); }, *emulator);
+}
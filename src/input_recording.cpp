@@ -0,0 +1,114 @@
+#include "input_recording.h"
+
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#include "state_io.h"
+
+namespace {
+
+constexpr std::uint32_t RECORDING_MAGIC = 0x4E493843;  // "C8IN" in little-endian order
+// Serialized sizes: the tag, version, profile, frequency, seed, length and
+// event count, then each event's cycle, key and flag
+constexpr std::size_t HEADER_SIZE = 35;
+constexpr std::size_t EVENT_SIZE = 10;
+
+}  // namespace
+
+std::vector<std::uint8_t> serializeRecording(const InputRecording& recording) {
+    std::vector<std::uint8_t> data;
+    data.reserve(HEADER_SIZE + recording.events.size() * EVENT_SIZE);
+    StateWriter writer(data);
+    writer.put(RECORDING_MAGIC);
+    writer.put(RECORDING_VERSION);
+    writer.put(static_cast<std::uint8_t>(recording.profile));
+    writer.put(recording.cpuFrequency);
+    writer.put(recording.seed);
+    writer.put(recording.cycles);
+    writer.put(static_cast<std::uint64_t>(recording.events.size()));
+    for (const KeyEvent& event : recording.events) {
+        writer.put(event.cycle);
+        writer.put(event.key);
+        writer.put(event.pressed);
+    }
+    return data;
+}
+
+bool deserializeRecording(const std::vector<std::uint8_t>& data, InputRecording& recording) {
+    StateReader reader(data);
+    std::uint32_t magic = 0;
+    std::uint16_t version = 0;
+    std::uint8_t profile = 0;
+    InputRecording read;
+    std::uint64_t eventCount = 0;
+    reader.get(magic);
+    reader.get(version);
+    reader.get(profile);
+    reader.get(read.cpuFrequency);
+    reader.get(read.seed);
+    reader.get(read.cycles);
+    reader.get(eventCount);
+    // A count the data cannot hold is rejected before allocating for it
+    if (magic != RECORDING_MAGIC || version == 0 || version > RECORDING_VERSION ||
+        profile > static_cast<std::uint8_t>(QuirkProfile::XoChip) ||
+        eventCount > data.size() / EVENT_SIZE) {
+        return false;
+    }
+    read.profile = static_cast<QuirkProfile>(profile);
+
+    read.events.resize(eventCount);
+    std::uint64_t previous = 0;
+    for (KeyEvent& event : read.events) {
+        reader.get(event.cycle);
+        reader.get(event.key);
+        reader.get(event.pressed);
+        if (event.cycle < previous || event.cycle > read.cycles ||
+            event.key >= Chip8Base::KEYBOARD_SIZE) {
+            return false;
+        }
+        previous = event.cycle;
+    }
+    if (!reader.finished()) {
+        return false;
+    }
+    recording = std::move(read);
+    return true;
+}
+
+bool saveRecording(const std::string& path, const InputRecording& recording) {
+    const std::vector<std::uint8_t> data = serializeRecording(recording);
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(data.data()),
+               static_cast<std::streamsize>(data.size()));
+    return file.good();
+}
+
+bool loadRecording(const std::string& path, InputRecording& recording) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    const std::vector<std::uint8_t> data{std::istreambuf_iterator<char>(file),
+                                         std::istreambuf_iterator<char>()};
+    return deserializeRecording(data, recording);
+}
+
+InputRecorder::InputRecorder(QuirkProfile profile, std::uint32_t cpuFrequency,
+                             std::uint64_t seed) {
+    recording_.profile = profile;
+    recording_.cpuFrequency = cpuFrequency;
+    recording_.seed = seed;
+}
+
+void InputRecorder::setKeyState(std::uint8_t key, bool pressed) {
+    if (key >= Chip8Base::KEYBOARD_SIZE) {
+        return;
+    }
+    const auto bit = static_cast<std::uint16_t>(1u << key);
+    if (((keys_ & bit) != 0) == pressed) {
+        return;
+    }
+    keys_ ^= bit;
+    recording_.events.push_back(KeyEvent{recording_.cycles, key, pressed});
+}
@@ -0,0 +1,142 @@
+#ifndef CHIP8_INPUT_RECORDING_H
+#define CHIP8_INPUT_RECORDING_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "chip8.h"
+#include "chip8_factory.h"
+
+// A key press or release, applied before the instruction at `cycle`
+struct KeyEvent {
+    std::uint64_t cycle;
+    std::uint8_t key;
+    bool pressed;
+};
+
+// Everything besides the ROM that decides a session: the profile, the CPU
+// frequency the timers count cycles at, the random seed and the key changes.
+// Replaying it against the same ROM repeats the session bit for bit.
+struct InputRecording {
+    QuirkProfile profile = QuirkProfile::Default;
+    std::uint32_t cpuFrequency = Chip8Base::DEFAULT_CPU_FREQUENCY;
+    std::uint64_t seed = 0;
+    std::uint64_t cycles = 0;      // Length of the session
+    std::vector<KeyEvent> events;  // Sorted by cycle, all within the session
+};
+
+// The portable form starts with the tag C8IN and RECORDING_VERSION, followed
+// by the fields little-endian. deserializeRecording() fails, leaving the
+// recording untouched, on truncated data, trailing bytes or bad values.
+constexpr std::uint16_t RECORDING_VERSION = 1;
+std::vector<std::uint8_t> serializeRecording(const InputRecording& recording);
+bool deserializeRecording(const std::vector<std::uint8_t>& data, InputRecording& recording);
+bool saveRecording(const std::string& path, const InputRecording& recording);
+bool loadRecording(const std::string& path, InputRecording& recording);
+
+// Records a session as it is played. Pass it every key state given to the
+// emulator, through setKeyState() or AtomicKeypad::applyTo(), and the cycles
+// each run executed. It keeps only the changes, stamped with the cycle count
+// at the time. The emulator must start from a fresh loadRom() with the
+// recording's frequency and seed; see prepareForRecording().
+class InputRecorder {
+  public:
+    InputRecorder(QuirkProfile profile, std::uint32_t cpuFrequency, std::uint64_t seed);
+
+    void setKeyState(std::uint8_t key, bool pressed);
+    void advance(std::uint64_t cycles) { recording_.cycles += cycles; }
+
+    std::uint64_t getCycle() const { return recording_.cycles; }
+    const InputRecording& getRecording() const { return recording_; }
+
+  private:
+    InputRecording recording_;
+    std::uint16_t keys_ = 0;  // Bit per key, as last recorded
+};
+
+// Gives a freshly loaded emulator the recording's frequency and seed
+template <typename Emulator>
+void prepareForRecording(Emulator& emulator, const InputRecording& recording) {
+    emulator.setCpuFrequency(recording.cpuFrequency);
+    emulator.setRandomSeed(recording.seed);
+}
+
+// Runs emulator from `cycle` to `target`, applying events from `next` on
+// before the instruction at their cycle, and advances cycle and next. Runs
+// are split at events, so the result does not depend on how the caller
+// splits the target. Returns CycleLimit at the target, Error after a failing
+// instruction, KeyWait at a key wait no remaining event will end, or the stop
+// reason of a run that made no progress.
+template <typename Emulator>
+Chip8Base::StopReason runWithInput(Emulator& emulator, const std::vector<KeyEvent>& events,
+                                   std::size_t& next, std::uint64_t& cycle,
+                                   std::uint64_t target) {
+    while (cycle < target) {
+        for (; next < events.size() && events[next].cycle <= cycle; ++next) {
+            emulator.setKeyState(events[next].key, events[next].pressed);
+        }
+
+        std::uint64_t end = std::min<std::uint64_t>(
+            target, cycle + std::numeric_limits<std::uint32_t>::max());
+        if (next < events.size()) {
+            end = std::min(end, events[next].cycle);
+        }
+        // A key wait lasts until the next event at least, so it is skipped in
+        // one call. FX0A stops only with every key up, so without further
+        // events it waits forever: stop there instead.
+        const auto cycles = static_cast<std::uint32_t>(end - cycle);
+        const bool noEventsLeft = next == events.size();
+        const Chip8Base::RunResult run = noEventsLeft ? emulator.runCycles(cycles)
+                                                    : emulator.runCyclesThroughKeyWaits(cycles);
+        cycle += run.cycles;
+        if (run.reason == Chip8Base::StopReason::Error || run.cycles == 0) {
+            return run.reason;
+        }
+        if (run.reason == Chip8Base::StopReason::KeyWait && noEventsLeft) {
+            return run.reason;
+        }
+    }
+    return Chip8Base::StopReason::CycleLimit;
+}
+
+// Plays a recording back into an emulator as fast as it will run, with each
+// key change applied at the cycle it was recorded at
+template <typename Emulator = Chip8>
+class BasicInputReplayer {
+  public:
+    explicit BasicInputReplayer(InputRecording recording) : recording_(std::move(recording)) {}
+
+    // Call after loadRom() and before run()
+    void start(Emulator& emulator) {
+        prepareForRecording(emulator, recording_);
+        cycle_ = 0;
+        next_ = 0;
+    }
+
+    // Runs up to `cycles` more of the session; see runWithInput()
+    Chip8Base::StopReason run(Emulator& emulator, std::uint64_t cycles) {
+        const std::uint64_t target = cycle_ + std::min(cycles, recording_.cycles - cycle_);
+        return runWithInput(emulator, recording_.events, next_, cycle_, target);
+    }
+    Chip8Base::StopReason runToEnd(Emulator& emulator) {
+        return run(emulator, recording_.cycles - cycle_);
+    }
+
+    bool isFinished() const { return cycle_ >= recording_.cycles; }
+    std::uint64_t getCycle() const { return cycle_; }
+    const InputRecording& getRecording() const { return recording_; }
+
+  private:
+    InputRecording recording_;
+    std::uint64_t cycle_ = 0;
+    std::size_t next_ = 0;
+};
+
+using InputReplayer = BasicInputReplayer<>;
+
+#endif
@@ -0,0 +1,645 @@
+#include "instance_batch.h"
+
+#include <algorithm>
+
+namespace {
+
+// A fixed non-zero state for seed 0, which would lock xorshift at zero
+constexpr std::uint32_t ZERO_SEED_STATE = 0x9E3779B9;
+
+std::uint32_t xorshift(std::uint32_t state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Branch-free choice for one lane: value where member is 1, otherwise where
+// it is 0. Loops over lanes built from it vectorize.
+template <typename T>
+T select(std::uint8_t member, T value, T otherwise) {
+    const auto mask = static_cast<T>(0 - static_cast<T>(member));
+    return static_cast<T>((value & mask) | (otherwise & ~mask));
+}
+
+}  // namespace
+
+template <typename Quirks>
+BasicInstanceBatch<Quirks>::BasicInstanceBatch(std::size_t laneCount)
+    : laneCount_(laneCount),
+      image_(MEMORY_SIZE),
+      written_(MEMORY_SIZE),
+      memory_(laneCount * MEMORY_SIZE),
+      indexRegister_(laneCount),
+      programCounter_(laneCount),
+      stackPointer_(laneCount),
+      stack_(laneCount),
+      delayTimer_(laneCount),
+      soundTimer_(laneCount),
+      timerPhase_(laneCount),
+      keys_(laneCount),
+      random_(laneCount),
+      display_(laneCount),
+      errors_(laneCount),
+      running_(laneCount),
+      pending_(laneCount),
+      stepped_(laneCount),
+      group_(laneCount) {
+    for (std::vector<std::uint8_t>& reg : registers_) {
+        reg.resize(laneCount);
+    }
+    for (std::size_t lane = 0; lane < laneCount; ++lane) {
+        setSeed(lane, static_cast<std::uint32_t>(lane));
+    }
+    loadRom({});
+}
+
+template <typename Quirks>
+bool BasicInstanceBatch<Quirks>::loadRom(const std::vector<std::uint8_t>& rom) {
+    // The emulator lays out the font and ROM, so lanes start exactly like it
+    NullLogger logger;
+    BasicChip8<CheckedPolicy, Quirks> emulator(Chip8Base::Backend::Switch, logger);
+    if (!emulator.loadRom(rom)) {
+        return false;
+    }
+    for (std::uint16_t address = 0; address < MEMORY_SIZE; ++address) {
+        image_[address] = emulator.getMemoryAt(address);
+    }
+
+    std::fill(written_.begin(), written_.end(), 0);
+    for (std::size_t lane = 0; lane < laneCount_; ++lane) {
+        resetLane(lane);
+    }
+    return true;
+}
+
+template <typename Quirks>
+void BasicInstanceBatch<Quirks>::resetLane(std::size_t lane) {
+    std::copy(image_.begin(), image_.end(), memory_.begin() + lane * MEMORY_SIZE);
+    for (std::vector<std::uint8_t>& reg : registers_) {
+        reg[lane] = 0;
+    }
+    indexRegister_[lane] = 0;
+    programCounter_[lane] = Chip8Base::ROM_START_ADDRESS;
+    stackPointer_[lane] = 0;
+    stack_[lane].fill(0);
+    delayTimer_[lane] = 0;
+    soundTimer_[lane] = 0;
+    timerPhase_[lane] = 0;
+    display_[lane].fill(0);
+    errors_[lane] = Chip8Base::ErrorCode::None;
+    running_[lane] = 1;
+}
+
+template <typename Quirks>
+void BasicInstanceBatch<Quirks>::setCpuFrequency(std::uint32_t hz) {
+    cpuFrequency_ = hz == 0 ? 0 : std::max(hz, Chip8Base::TIMER_FREQUENCY);
+    timerStep_ = hz == 0 ? 0 : Chip8Base::TIMER_FREQUENCY;
+    timerPeriod_ = hz == 0 ? 1 : cpuFrequency_;
+    std::fill(timerPhase_.begin(), timerPhase_.end(), 0);
+}
+
+template <typename Quirks>
+void BasicInstanceBatch<Quirks>::setKeyState(std::size_t lane, std::uint8_t key, bool pressed) {
+    if (key >= Chip8Base::KEYBOARD_SIZE) {
+        return;
+    }
+    const auto bit = static_cast<std::uint16_t>(1u << key);
+    keys_[lane] = pressed ? keys_[lane] | bit : keys_[lane] & ~bit;
+}
+
+template <typename Quirks>
+void BasicInstanceBatch<Quirks>::setSeed(std::size_t lane, std::uint32_t seed) {
+    random_[lane] = seed != 0 ? seed : ZERO_SEED_STATE;
+}
+
+template <typename Quirks>
+std::uint8_t BasicInstanceBatch<Quirks>::getPixel(std::size_t lane, std::uint16_t x,
+                                                   std::uint16_t y) const {
+    if (x >= Chip8Base::DISPLAY_WIDTH || y >= Chip8Base::DISPLAY_HEIGHT) {
+        return 0;
+    }
+    return display_[lane][y] >> (63 - x) & 1;
+}
+
+template <typename Quirks>
+std::size_t BasicInstanceBatch<Quirks>::step() {
+    // The lanes that failed this step still count for the timers, as a
+    // failing instruction does in the emulator
+    std::copy(running_.begin(), running_.end(), pending_.begin());
+    std::copy(running_.begin(), running_.end(), stepped_.begin());
+
+    std::size_t groups = 0;
+    std::size_t first = 0;
+    for (;;) {
+        while (first < laneCount_ && pending_[first] == 0) {
+            ++first;
+        }
+        if (first == laneCount_) {
+            break;
+        }
+
+        // The lowest pending lane leads and lanes at the same PC join it.
+        // Where some lane has stored to the opcode, they must also hold the
+        // same bytes there.
+        const std::uint16_t pc = programCounter_[first];
+        if (pc >= MEMORY_SIZE - 1) {
+            fail(first, Chip8Base::ErrorCode::InvalidMemoryAccess);
+            pending_[first] = 0;
+            continue;
+        }
+        const std::uint8_t high = memory_[first * MEMORY_SIZE + pc];
+        const std::uint8_t low = memory_[first * MEMORY_SIZE + pc + 1];
+        const std::uint16_t* pcs = programCounter_.data();
+        std::uint8_t* pending = pending_.data();
+        std::uint8_t* group = group_.data();
+        const std::size_t count = laneCount_;
+        if (written_[pc] == 0 && written_[pc + 1] == 0) {
+            for (std::size_t lane = first; lane < count; ++lane) {
+                const bool joins = (pending[lane] != 0) & (pcs[lane] == pc);
+                group[lane] = joins;
+                pending[lane] &= !joins;
+            }
+        } else {
+            for (std::size_t lane = first; lane < count; ++lane) {
+                const std::uint8_t* code = &memory_[lane * MEMORY_SIZE + pc];
+                const bool joins = pending[lane] != 0 && pcs[lane] == pc && code[0] == high &&
+                                   code[1] == low;
+                group[lane] = joins;
+                pending[lane] &= !joins;
+            }
+        }
+        std::size_t end = count;
+        while (group[end - 1] == 0) {
+            --end;
+        }
+        groupBegin_ = first;
+        groupEnd_ = end;
+
+        execute(static_cast<std::uint16_t>(high << 8 | low));
+        ++groups;
+    }
+
+    // The clock of each lane that ran an instruction advances by one cycle
+    const std::uint8_t* stepped = stepped_.data();
+    std::uint32_t* phases = timerPhase_.data();
+    std::uint8_t* delay = delayTimer_.data();
+    std::uint8_t* sound = soundTimer_.data();
+    const std::uint32_t period = timerPeriod_;
+    const std::size_t count = laneCount_;
+    for (std::size_t lane = 0; lane < count; ++lane) {
+        const std::uint32_t phase =
+            phases[lane] + select<std::uint32_t>(stepped[lane], timerStep_, 0);
+        const std::uint8_t tick = phase >= period;
+        phases[lane] = phase - select<std::uint32_t>(tick, period, 0);
+        delay[lane] -= tick & (delay[lane] != 0);
+        sound[lane] -= tick & (sound[lane] != 0);
+    }
+    return groups;
+}
+
+template <typename Quirks>
+void BasicInstanceBatch<Quirks>::run(std::uint32_t steps) {
+    for (std::uint32_t i = 0; i < steps; ++i) {
+        step();
+    }
+}
+
+template <typename Quirks>
+void BasicInstanceBatch<Quirks>::execute(std::uint16_t opcode) {
+    const std::uint8_t x = opcode >> 8 & 0xF;
+    const std::uint8_t y = opcode >> 4 & 0xF;
+    const std::uint8_t n = opcode & 0xF;
+    const std::uint8_t nn = opcode & 0xFF;
+    const std::uint16_t nnn = opcode & 0xFFF;
+    std::uint8_t* vx = registers_[x].data();
+    const std::uint8_t* vy = registers_[y].data();
+    const std::uint8_t* group = group_.data();
+    const std::size_t begin = groupBegin_;
+    const std::size_t end = groupEnd_;
+
+    switch (opcode >> 12) {
+        case 0x0: {
+            // CLS and RET match by the low nibble, as in the emulator, once the
+            // profile's SUPER-CHIP opcodes are ruled out
+            const bool superChip = Quirks::SUPER_CHIP && ((opcode & 0xFFF0) == 0x00C0 ||
+                                                          (opcode >= 0x00FB && opcode <= 0x00FF));
+            if (!superChip && n == 0x0) {
+                for (std::size_t lane = begin; lane < end; ++lane) {
+                    if (group[lane] != 0) {
+                        display_[lane].fill(0);
+                    }
+                }
+                advance();
+            } else if (!superChip && n == 0xE) {
+                for (std::size_t lane = begin; lane < end; ++lane) {
+                    if (group[lane] == 0) {
+                        continue;
+                    }
+                    if (stackPointer_[lane] == 0) {
+                        fail(lane, Chip8Base::ErrorCode::StackUnderflow);
+                        continue;
+                    }
+                    --stackPointer_[lane];
+                    programCounter_[lane] = stack_[lane][stackPointer_[lane]] + 2;
+                }
+            } else {
+                for (std::size_t lane = begin; lane < end; ++lane) {
+                    if (group[lane] != 0) {
+                        fail(lane, Chip8Base::ErrorCode::UnknownOpcode);
+                    }
+                }
+            }
+            break;
+        }
+        case 0x1:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                programCounter_[lane] = select(group[lane], nnn, programCounter_[lane]);
+            }
+            break;
+        case 0x2:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                if (group[lane] == 0) {
+                    continue;
+                }
+                if (stackPointer_[lane] >= Chip8Base::STACK_SIZE) {
+                    fail(lane, Chip8Base::ErrorCode::StackOverflow);
+                    programCounter_[lane] += 2;
+                    continue;
+                }
+                stack_[lane][stackPointer_[lane]++] = programCounter_[lane];
+                programCounter_[lane] = nnn;
+            }
+            break;
+        case 0x3:
+            advance([&](std::size_t lane) { return vx[lane] == nn; });
+            break;
+        case 0x4:
+            advance([&](std::size_t lane) { return vx[lane] != nn; });
+            break;
+        case 0x5:
+            advance([&](std::size_t lane) { return vx[lane] == vy[lane]; });
+            break;
+        case 0x6:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                vx[lane] = select(group[lane], nn, vx[lane]);
+            }
+            advance();
+            break;
+        case 0x7:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                vx[lane] += select<std::uint8_t>(group[lane], nn, 0);
+            }
+            advance();
+            break;
+        case 0x8:
+            executeArithmetic(x, y, n);
+            break;
+        case 0x9:
+            advance([&](std::size_t lane) { return vx[lane] != vy[lane]; });
+            break;
+        case 0xA:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                indexRegister_[lane] = select(group[lane], nnn, indexRegister_[lane]);
+            }
+            advance();
+            break;
+        case 0xB: {
+            // BNNN, or BXNN by quirk
+            const std::uint8_t* offset = registers_[Quirks::JUMP_USES_VX ? x : 0].data();
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                if (group[lane] == 0) {
+                    continue;
+                }
+                const std::uint16_t address = offset[lane] + nnn;
+                if (address >= MEMORY_SIZE) {
+                    fail(lane, Chip8Base::ErrorCode::InvalidMemoryAccess);
+                    continue;
+                }
+                programCounter_[lane] = address;
+            }
+            break;
+        }
+        case 0xC: {
+            std::uint32_t* random = random_.data();
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                const std::uint32_t next = xorshift(random[lane]);
+                random[lane] = select(group[lane], next, random[lane]);
+                const auto value = static_cast<std::uint8_t>(next >> 24 & nn);
+                vx[lane] = select(group[lane], value, vx[lane]);
+            }
+            advance();
+            break;
+        }
+        case 0xD:
+            if (Quirks::SUPER_CHIP && n == 0) {
+                // SUPER-CHIP 16x16 sprites; the classic profiles draw no rows
+                for (std::size_t lane = begin; lane < end; ++lane) {
+                    if (group[lane] != 0) {
+                        fail(lane, Chip8Base::ErrorCode::UnknownOpcode);
+                    }
+                }
+                break;
+            }
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                if (group[lane] != 0) {
+                    draw(lane, x, y, n);
+                }
+            }
+            break;
+        case 0xE:
+            if (n == 0xE) {
+                advance([&](std::size_t lane) { return keyPressed(lane, vx[lane]); });
+            } else if (n == 0x1) {
+                advance([&](std::size_t lane) { return !keyPressed(lane, vx[lane]); });
+            } else {
+                for (std::size_t lane = begin; lane < end; ++lane) {
+                    if (group[lane] != 0) {
+                        fail(lane, Chip8Base::ErrorCode::UnknownOpcode);
+                    }
+                }
+            }
+            break;
+        default:
+            executeMisc(x, nn);
+            break;
+    }
+}
+
+template <typename Quirks>
+void BasicInstanceBatch<Quirks>::executeArithmetic(std::uint8_t x, std::uint8_t y, std::uint8_t n) {
+    // Each pass reads what the previous one wrote, so VF as X or Y behaves as
+    // in the emulator
+    std::uint8_t* vx = registers_[x].data();
+    const std::uint8_t* vy = registers_[y].data();
+    std::uint8_t* vf = registers_[0xF].data();
+    const std::uint8_t* source = registers_[Quirks::SHIFT_USES_VY ? y : x].data();
+    const std::uint8_t* group = group_.data();
+    const std::size_t begin = groupBegin_;
+    const std::size_t end = groupEnd_;
+
+    // The 8XY1-8XY3 flag reset, by quirk
+    const auto resetFlag = [&] {
+        if constexpr (Quirks::LOGIC_RESETS_VF) {
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                vf[lane] = select<std::uint8_t>(group[lane], 0, vf[lane]);
+            }
+        }
+    };
+
+    switch (n) {
+        case 0x0:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                vx[lane] = select(group[lane], vy[lane], vx[lane]);
+            }
+            break;
+        case 0x1:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                vx[lane] |= select<std::uint8_t>(group[lane], vy[lane], 0);
+            }
+            resetFlag();
+            break;
+        case 0x2:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                vx[lane] &= select<std::uint8_t>(group[lane], vy[lane], 0xFF);
+            }
+            resetFlag();
+            break;
+        case 0x3:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                vx[lane] ^= select<std::uint8_t>(group[lane], vy[lane], 0);
+            }
+            resetFlag();
+            break;
+        case 0x4:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                const bool carry = vy[lane] > 0xFF - vx[lane];
+                vf[lane] = select<std::uint8_t>(group[lane], carry, vf[lane]);
+            }
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                vx[lane] += select<std::uint8_t>(group[lane], vy[lane], 0);
+            }
+            break;
+        case 0x5:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                const bool noBorrow = vx[lane] >= vy[lane];
+                vf[lane] = select<std::uint8_t>(group[lane], noBorrow, vf[lane]);
+            }
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                vx[lane] -= select<std::uint8_t>(group[lane], vy[lane], 0);
+            }
+            break;
+        case 0x6:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                const std::uint8_t value = source[lane];
+                vf[lane] = select<std::uint8_t>(group[lane], value & 1, vf[lane]);
+                vx[lane] = select<std::uint8_t>(group[lane], value >> 1, vx[lane]);
+            }
+            break;
+        case 0x7:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                const bool noBorrow = vy[lane] >= vx[lane];
+                vf[lane] = select<std::uint8_t>(group[lane], noBorrow, vf[lane]);
+            }
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                vx[lane] = select<std::uint8_t>(group[lane], vy[lane] - vx[lane], vx[lane]);
+            }
+            break;
+        case 0xE:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                const std::uint8_t value = source[lane];
+                vf[lane] = select<std::uint8_t>(group[lane], value >> 7, vf[lane]);
+                vx[lane] = select<std::uint8_t>(group[lane], value << 1, vx[lane]);
+            }
+            break;
+        default:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                if (group[lane] != 0) {
+                    fail(lane, Chip8Base::ErrorCode::UnknownOpcode);
+                }
+            }
+            return;
+    }
+    advance();
+}
+
+template <typename Quirks>
+void BasicInstanceBatch<Quirks>::executeMisc(std::uint8_t x, std::uint8_t nn) {
+    std::uint8_t* vx = registers_[x].data();
+    const std::uint8_t* group = group_.data();
+    const std::size_t begin = groupBegin_;
+    const std::size_t end = groupEnd_;
+    std::uint8_t* delay = delayTimer_.data();
+    std::uint8_t* sound = soundTimer_.data();
+    std::uint16_t* index = indexRegister_.data();
+
+    switch (nn) {
+        case 0x07:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                vx[lane] = select(group[lane], delay[lane], vx[lane]);
+            }
+            break;
+        case 0x0A:
+            // Lanes without a key stay on the instruction
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                if (group[lane] == 0 || keys_[lane] == 0) {
+                    continue;
+                }
+                std::uint8_t key = 0;
+                while ((keys_[lane] >> key & 1) == 0) {
+                    ++key;
+                }
+                vx[lane] = key;
+                programCounter_[lane] += 2;
+            }
+            return;
+        case 0x15:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                delay[lane] = select(group[lane], vx[lane], delay[lane]);
+            }
+            break;
+        case 0x18:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                sound[lane] = select(group[lane], vx[lane], sound[lane]);
+            }
+            break;
+        case 0x1E:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                index[lane] += select<std::uint16_t>(group[lane], vx[lane], 0);
+            }
+            break;
+        case 0x29:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                if (group[lane] == 0) {
+                    continue;
+                }
+                if (vx[lane] > 0xF) {
+                    fail(lane, Chip8Base::ErrorCode::InvalidMemoryAccess);
+                    continue;
+                }
+                indexRegister_[lane] = vx[lane] * 5;  // Each digit is 5 bytes
+                programCounter_[lane] += 2;
+            }
+            return;
+        case 0x33:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                if (group[lane] == 0) {
+                    continue;
+                }
+                const std::uint16_t address = indexRegister_[lane];
+                if (address + 2 >= MEMORY_SIZE) {
+                    fail(lane, Chip8Base::ErrorCode::InvalidMemoryAccess);
+                    continue;
+                }
+                std::uint8_t* memory = &memory_[lane * MEMORY_SIZE + address];
+                std::fill_n(&written_[address], 3, 1);
+                memory[0] = vx[lane] / 100;
+                memory[1] = vx[lane] / 10 % 10;
+                memory[2] = vx[lane] % 10;
+                programCounter_[lane] += 2;
+            }
+            return;
+        case 0x55:
+        case 0x65:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                if (group[lane] == 0) {
+                    continue;
+                }
+                const std::uint16_t address = indexRegister_[lane];
+                if (address + x >= MEMORY_SIZE) {
+                    fail(lane, Chip8Base::ErrorCode::InvalidMemoryAccess);
+                    continue;
+                }
+                std::uint8_t* memory = &memory_[lane * MEMORY_SIZE + address];
+                if (nn == 0x55) {
+                    std::fill_n(&written_[address], x + 1, 1);
+                }
+                for (std::uint8_t i = 0; i <= x; ++i) {
+                    if (nn == 0x55) {
+                        memory[i] = registers_[i][lane];
+                    } else {
+                        registers_[i][lane] = memory[i];
+                    }
+                }
+                if constexpr (Quirks::LOAD_STORE_ADVANCES_I) {
+                    indexRegister_[lane] += x + 1;
+                }
+                programCounter_[lane] += 2;
+            }
+            return;
+        default:
+            for (std::size_t lane = begin; lane < end; ++lane) {
+                if (group[lane] != 0) {
+                    fail(lane, Chip8Base::ErrorCode::UnknownOpcode);
+                }
+            }
+            return;
+    }
+    advance();
+}
+
+template <typename Quirks>
+void BasicInstanceBatch<Quirks>::draw(std::size_t lane, std::uint8_t x, std::uint8_t y,
+                                      std::uint8_t height) {
+    // The emulator's low-resolution draw: a row is the sprite byte rotated
+    // into place, or shifted with the tail dropped when the profile clips
+    const std::uint16_t xPos = registers_[x][lane] & (Chip8Base::DISPLAY_WIDTH - 1);
+    std::uint16_t yPos = registers_[y][lane];
+    std::uint16_t rows = height;
+    if constexpr (Quirks::DRAW_CLIPS) {
+        yPos &= Chip8Base::DISPLAY_HEIGHT - 1;
+        rows = std::min<std::uint16_t>(rows, Chip8Base::DISPLAY_HEIGHT - yPos);
+    }
+    const bool spills = xPos > 56 && !Quirks::DRAW_CLIPS;
+
+    const std::uint8_t* memory = &memory_[lane * MEMORY_SIZE];
+    DisplayRows& display = display_[lane];
+    std::uint64_t collision = 0;
+    for (std::uint16_t row = 0; row < rows; ++row) {
+        const std::uint32_t address = indexRegister_[lane] + row;
+        if (address >= MEMORY_SIZE) {
+            fail(lane, Chip8Base::ErrorCode::InvalidMemoryAccess);
+            registers_[0xF][lane] = collision != 0 ? 1 : 0;
+            return;
+        }
+        const std::uint64_t aligned = std::uint64_t{memory[address]} << 56;
+        const std::uint64_t mask = aligned >> xPos | (spills ? aligned << (64 - xPos) : 0);
+        std::uint64_t& pixels = display[(yPos + row) & (Chip8Base::DISPLAY_HEIGHT - 1)];
+        collision |= pixels & mask;
+        pixels ^= mask;
+    }
+    registers_[0xF][lane] = collision != 0 ? 1 : 0;
+    programCounter_[lane] += 2;
+}
+
+template <typename Quirks>
+template <typename Condition>
+void BasicInstanceBatch<Quirks>::advance(Condition condition) {
+    std::uint16_t* pc = programCounter_.data();
+    const std::uint8_t* group = group_.data();
+    const std::size_t end = groupEnd_;
+    for (std::size_t lane = groupBegin_; lane < end; ++lane) {
+        const std::uint16_t distance = 2 + 2 * condition(lane);
+        pc[lane] += select<std::uint16_t>(group[lane], distance, 0);
+    }
+}
+
+template <typename Quirks>
+void BasicInstanceBatch<Quirks>::advance() {
+    std::uint16_t* pc = programCounter_.data();
+    const std::uint8_t* group = group_.data();
+    const std::size_t end = groupEnd_;
+    for (std::size_t lane = groupBegin_; lane < end; ++lane) {
+        pc[lane] += select<std::uint16_t>(group[lane], 2, 0);
+    }
+}
+
+template <typename Quirks>
+void BasicInstanceBatch<Quirks>::fail(std::size_t lane, Chip8Base::ErrorCode error) {
+    errors_[lane] = error;
+    running_[lane] = 0;
+}
+
+template class BasicInstanceBatch<DefaultQuirks>;
+template class BasicInstanceBatch<Chip8Quirks>;
+template class BasicInstanceBatch<SuperChipQuirks>;
@@ -0,0 +1,141 @@
+#ifndef CHIP8_INSTANCE_BATCH_H
+#define CHIP8_INSTANCE_BATCH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "chip8.h"
+
+// Many copies of one ROM run in lockstep, for rollouts that step hundreds of
+// instances with different keys and random seeds. State is stored
+// structure-of-arrays: each register, I, PC and timer is one vector with an
+// entry per lane.
+//
+// Each step() runs one instruction on every lane. Lanes at the same PC with the
+// same opcode form a group, and the group runs the instruction as one pass
+// over the lanes with a per-lane mask, which the compiler vectorizes. When
+// control flow diverges, the lanes split into more groups and run one after
+// another.
+//
+// The batch covers the classic CHIP-8 instruction set in low resolution, with
+// the checked core's semantics for the Quirks profile. SUPER-CHIP and XO-CHIP
+// instructions fail with UnknownOpcode. A lane that fails stops where it is
+// and keeps its error until it is reset; the other lanes keep running.
+template <typename Quirks = DefaultQuirks>
+class BasicInstanceBatch {
+    static_assert(!Quirks::XO_CHIP, "XO-CHIP programs need the full emulator");
+
+  public:
+    // One lane's display, row y in word y. Column 0 is the most significant
+    // bit, as in the first word of each row of Chip8Base::DisplayPlane.
+    using DisplayRows = std::array<std::uint64_t, Chip8Base::DISPLAY_HEIGHT>;
+
+    explicit BasicInstanceBatch(std::size_t laneCount);
+
+    // Installs the ROM and resets every lane. Fails, leaving the batch as it
+    // was, when the ROM does not fit in memory.
+    bool loadRom(const std::vector<std::uint8_t>& rom);
+    // Restarts one lane on the loaded ROM, with its timer clock at zero like a
+    // reset emulator's. Its keys and random state are kept.
+    void resetLane(std::size_t lane);
+
+    // Runs one instruction on every running lane and returns how many groups
+    // it took: 1 while all lanes agree, up to the lane count when none do
+    std::size_t step();
+    void run(std::uint32_t steps);
+
+    // Timers tick at Chip8Base::TIMER_FREQUENCY against this clock, as in the
+    // emulator. 0 stops them.
+    void setCpuFrequency(std::uint32_t hz);
+    std::uint32_t getCpuFrequency() const { return cpuFrequency_; }
+
+    // Per-lane input. Keys are a bitmask, bit N for key N.
+    void setKeys(std::size_t lane, std::uint16_t keys) { keys_[lane] = keys; }
+    void setKeyState(std::size_t lane, std::uint8_t key, bool pressed);
+    // CXNN draws from a per-lane xorshift generator seeded here
+    void setSeed(std::size_t lane, std::uint32_t seed);
+
+    std::size_t getLaneCount() const { return laneCount_; }
+    bool isRunning(std::size_t lane) const { return running_[lane] != 0; }
+    Chip8Base::ErrorCode getLastError(std::size_t lane) const { return errors_[lane]; }
+
+    std::uint8_t getRegisterAt(std::size_t lane, std::uint8_t reg) const {
+        return registers_[reg][lane];
+    }
+    std::uint16_t getIndexRegister(std::size_t lane) const { return indexRegister_[lane]; }
+    std::uint16_t getProgramCounter(std::size_t lane) const { return programCounter_[lane]; }
+    std::uint8_t getStackPointer(std::size_t lane) const { return stackPointer_[lane]; }
+    std::uint8_t getDelayTimer(std::size_t lane) const { return delayTimer_[lane]; }
+    std::uint8_t getSoundTimer(std::size_t lane) const { return soundTimer_[lane]; }
+    std::uint8_t getMemory(std::size_t lane, std::uint16_t address) const {
+        return memory_[lane * MEMORY_SIZE + address];
+    }
+    const DisplayRows& getDisplay(std::size_t lane) const { return display_[lane]; }
+    std::uint8_t getPixel(std::size_t lane, std::uint16_t x, std::uint16_t y) const;
+
+  private:
+    static constexpr std::uint16_t MEMORY_SIZE = Chip8Base::MEMORY_SIZE;
+
+    void execute(std::uint16_t opcode);
+    void executeArithmetic(std::uint8_t x, std::uint8_t y, std::uint8_t n);
+    void executeMisc(std::uint8_t x, std::uint8_t nn);
+    void draw(std::size_t lane, std::uint8_t x, std::uint8_t y, std::uint8_t height);
+    // Moves each lane of the group to the next instruction, or past it where
+    // the condition holds
+    template <typename Condition>
+    void advance(Condition condition);
+    void advance();
+    void fail(std::size_t lane, Chip8Base::ErrorCode error);
+    // Keys past the keypad read as released
+    bool keyPressed(std::size_t lane, std::uint8_t key) const {
+        return (key < Chip8Base::KEYBOARD_SIZE) & (keys_[lane] >> (key & 0xF) & 1);
+    }
+
+    std::size_t laneCount_;
+    std::vector<std::uint8_t> image_;  // Font and ROM, copied into a lane on reset
+    // Addresses some lane has stored to since loadRom(). Elsewhere every lane
+    // still holds the image, so opcodes there need no per-lane comparison.
+    std::vector<std::uint8_t> written_;
+
+    std::vector<std::uint8_t> memory_;  // MEMORY_SIZE bytes per lane
+    std::array<std::vector<std::uint8_t>, Chip8Base::REGISTER_COUNT> registers_;
+    std::vector<std::uint16_t> indexRegister_;
+    std::vector<std::uint16_t> programCounter_;
+    std::vector<std::uint8_t> stackPointer_;
+    std::vector<std::array<std::uint16_t, Chip8Base::STACK_SIZE>> stack_;
+    std::vector<std::uint8_t> delayTimer_;
+    std::vector<std::uint8_t> soundTimer_;
+    // Timer clock fraction, times cpuFrequency_. Lanes reset at different
+    // times tick at different steps.
+    std::vector<std::uint32_t> timerPhase_;
+    std::vector<std::uint16_t> keys_;
+    std::vector<std::uint32_t> random_;
+    std::vector<DisplayRows> display_;
+    std::vector<Chip8Base::ErrorCode> errors_;
+    std::vector<std::uint8_t> running_;
+
+    // The step in progress: lanes not yet run, lanes that were running when
+    // it started, and the group being run, which lies within
+    // [groupBegin_, groupEnd_)
+    std::vector<std::uint8_t> pending_;
+    std::vector<std::uint8_t> stepped_;
+    std::vector<std::uint8_t> group_;
+    std::size_t groupBegin_ = 0;
+    std::size_t groupEnd_ = 0;
+
+    // Every lane runs one instruction per step, so they share the clock rate
+    std::uint32_t cpuFrequency_ = Chip8Base::DEFAULT_CPU_FREQUENCY;
+    std::uint32_t timerStep_ = Chip8Base::TIMER_FREQUENCY;
+    std::uint32_t timerPeriod_ = Chip8Base::DEFAULT_CPU_FREQUENCY;
+};
+
+// Compiled for the classic profiles, in instance_batch.cpp
+extern template class BasicInstanceBatch<DefaultQuirks>;
+extern template class BasicInstanceBatch<Chip8Quirks>;
+extern template class BasicInstanceBatch<SuperChipQuirks>;
+
+using InstanceBatch = BasicInstanceBatch<>;
+
+#endif
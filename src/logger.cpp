@@ -0,0 +1,181 @@
+#include "logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug:
+            return "DEBUG";
+        case LogLevel::Info:
+            return "INFO";
+        case LogLevel::Warning:
+            return "WARNING";
+        case LogLevel::Error:
+            return "ERROR";
+        default:
+            return "";
+    }
+}
+
+std::size_t roundUpToPowerOfTwo(std::size_t value) {
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}  // namespace
+
+void ConsoleLogger::write(LogLevel level, std::string_view message) {
+    // stdout is flushed by flush() rather than per line; stderr never buffers
+    std::FILE* stream = level >= LogLevel::Warning ? stderr : stdout;
+    std::fprintf(stream, "[%s] CHIP-8: %.*s\n", levelName(level),
+                 static_cast<int>(message.size()), message.data());
+}
+
+void ConsoleLogger::flush() {
+    std::fflush(stdout);
+    std::fflush(stderr);
+}
+
+AsyncLogger::AsyncLogger(Logger& sink, std::size_t capacity, LogLevel level)
+    : Logger(level),
+      sink_(sink),
+      mask_(roundUpToPowerOfTwo(std::max<std::size_t>(capacity, 2)) - 1),
+      slots_(new Slot[mask_ + 1]),
+      enqueuePosition_(0),
+      dequeuePosition_(0),
+      written_(0),
+      dropped_(0),
+      stopping_(false),
+      idle_(false) {
+    for (std::size_t i = 0; i <= mask_; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    thread_ = std::thread(&AsyncLogger::drain, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_.store(true, std::memory_order_release);
+    }
+    wake_.notify_one();
+    thread_.join();
+    sink_.flush();
+}
+
+void AsyncLogger::write(LogLevel level, std::string_view message) {
+    std::size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots_[position & mask_];
+        const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto difference =
+            static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+        if (difference == 0) {
+            if (enqueuePosition_.compare_exchange_weak(position, position + 1,
+                                                       std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // The drain thread has not freed this slot yet: the ring is full
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = enqueuePosition_.load(std::memory_order_relaxed);
+        }
+    }
+
+    const std::size_t length = std::min(message.size(), MAX_MESSAGE_LENGTH);
+    slot->entry.level = level;
+    slot->entry.length = static_cast<std::uint8_t>(length);
+    std::memcpy(slot->entry.text.data(), message.data(), length);
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    // Only the first writer after the drain thread went idle pays for a
+    // wake-up. The fence pairs with the drain thread's: either it sees this
+    // message before sleeping, or this writer sees it idle.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (idle_.load(std::memory_order_relaxed) &&
+        idle_.exchange(false, std::memory_order_acq_rel)) {
+        // Taking the lock waits out a drain thread between its check and its wait
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wake_.notify_one();
+    }
+}
+
+void AsyncLogger::flush() {
+    const std::size_t target = enqueuePosition_.load(std::memory_order_acquire);
+    while (written_.load(std::memory_order_acquire) < target) {
+        wake_.notify_one();
+        std::this_thread::yield();
+    }
+    sink_.flush();
+}
+
+std::uint64_t AsyncLogger::getDroppedCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+bool AsyncLogger::tryPop(Entry& entry) {
+    Slot& slot = slots_[dequeuePosition_ & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition_ + 1) {
+        return false;
+    }
+    entry = slot.entry;
+    slot.sequence.store(dequeuePosition_ + mask_ + 1, std::memory_order_release);
+    ++dequeuePosition_;
+    return true;
+}
+
+void AsyncLogger::drain() {
+    Entry entry;
+    bool unflushed = false;
+    while (true) {
+        if (tryPop(entry)) {
+            sink_.write(entry.level, std::string_view(entry.text.data(), entry.length));
+            written_.fetch_add(1, std::memory_order_release);
+            unflushed = true;
+            continue;
+        }
+        if (stopping_.load(std::memory_order_acquire)) {
+            // Writers have stopped; the ring is empty apart from messages still
+            // being published, which were reserved before the destructor ran
+            if (written_.load(std::memory_order_relaxed) ==
+                enqueuePosition_.load(std::memory_order_acquire)) {
+                return;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Nothing queued: push console output out now instead of per line,
+        // then sleep until a writer or the destructor wakes this thread
+        if (unflushed) {
+            sink_.flush();
+            unflushed = false;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        idle_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wake_.wait(lock, [this] {
+            return stopping_.load(std::memory_order_acquire) ||
+                   slots_[dequeuePosition_ & mask_].sequence.load(std::memory_order_acquire) ==
+                       dequeuePosition_ + 1;
+        });
+        idle_.store(false, std::memory_order_relaxed);
+    }
+}
+
+Logger& defaultLogger() {
+    // Destroyed in reverse order, so the queue drains into a live console
+    static ConsoleLogger console(LogLevel::Debug);
+    static AsyncLogger logger(console);
+    return logger;
+}
@@ -0,0 +1,117 @@
+#ifndef CHIP8_LOGGER_H
+#define CHIP8_LOGGER_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+enum class LogLevel : std::uint8_t { Debug, Info, Warning, Error, Off };
+
+// Destination for emulator log messages. Callers test isEnabled() before
+// building a message, so a filtered-out level costs one relaxed load.
+class Logger {
+  public:
+    explicit Logger(LogLevel level = LogLevel::Info) : level_(level) {}
+    virtual ~Logger() = default;
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    bool isEnabled(LogLevel level) const {
+        return level >= level_.load(std::memory_order_relaxed) && level != LogLevel::Off;
+    }
+    void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    LogLevel getLevel() const { return level_.load(std::memory_order_relaxed); }
+
+    // Only called for enabled levels
+    virtual void write(LogLevel level, std::string_view message) = 0;
+    virtual void flush() {}
+
+  private:
+    std::atomic<LogLevel> level_;
+};
+
+// Discards everything. Its level is fixed at Off, so log calls stop at the
+// isEnabled() test and never format a message.
+class NullLogger final : public Logger {
+  public:
+    NullLogger() : Logger(LogLevel::Off) {}
+
+    void write(LogLevel, std::string_view) override {}
+};
+
+// Writes "[LEVEL] CHIP-8: message" lines, Info and below to stdout and
+// warnings and errors to stderr, on the calling thread. stdout is buffered
+// until flush(); stderr is unbuffered, so warnings and errors appear at once.
+class ConsoleLogger final : public Logger {
+  public:
+    using Logger::Logger;
+
+    void write(LogLevel level, std::string_view message) override;
+    void flush() override;
+};
+
+// Queues messages in a fixed-size lock-free ring buffer and hands them to
+// another logger on a background thread, so writers never block on I/O.
+// Messages longer than MAX_MESSAGE_LENGTH are truncated; when the ring is
+// full new messages are dropped and counted.
+class AsyncLogger final : public Logger {
+  public:
+    static constexpr std::size_t MAX_MESSAGE_LENGTH = 119;
+    static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+    // capacity is rounded up to a power of two. The sink must outlive this
+    // logger; its level is ignored, filtering happens here.
+    explicit AsyncLogger(Logger& sink, std::size_t capacity = DEFAULT_CAPACITY,
+                         LogLevel level = LogLevel::Info);
+    ~AsyncLogger() override;
+
+    void write(LogLevel level, std::string_view message) override;
+    // Blocks until every message queued so far has reached the sink
+    void flush() override;
+    std::uint64_t getDroppedCount() const;
+
+  private:
+    struct Entry {
+        LogLevel level;
+        std::uint8_t length;
+        std::array<char, MAX_MESSAGE_LENGTH> text;
+    };
+
+    // Bounded multi-producer ring: a slot is free for position p when its
+    // sequence is p, and holds the message for p when it is p + 1
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        Entry entry;
+    };
+
+    bool tryPop(Entry& entry);
+    void drain();
+
+    Logger& sink_;
+    const std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<std::size_t> enqueuePosition_;
+    alignas(64) std::size_t dequeuePosition_;  // Drain thread only
+    std::atomic<std::size_t> written_;         // Messages handed to the sink
+    std::atomic<std::uint64_t> dropped_;
+    std::atomic<bool> stopping_;
+    std::atomic<bool> idle_;
+
+    // Only the drain thread waits; writers just notify when it is idle
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    std::thread thread_;
+};
+
+// Shared logger used by emulators unless setLogger() picks another one: an
+// AsyncLogger in front of a ConsoleLogger, at Info level.
+Logger& defaultLogger();
+
+#endif
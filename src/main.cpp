@@ -1,167 +1,472 @@
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_events.h>
-#include <SDL2/SDL_keycode.h>
-#include <SDL2/SDL_render.h>
-#include <SDL2/SDL_timer.h>
-
-#include <array>
-#include <cstdint>
-#include <cstdlib>
-#include <iostream>
-#include <string_view>
-
-#include "chip8.h"
-
-namespace {
-constexpr int WINDOW_WIDTH = 1024;
-constexpr int WINDOW_HEIGHT = 512;
-constexpr int TARGET_FPS = 60;
-constexpr int FRAME_DELAY = 1000 / TARGET_FPS;
-constexpr int DISPLAY_WIDTH = 64;
-constexpr int DISPLAY_HEIGHT = 32;
-constexpr int DISPLAY_SIZE = DISPLAY_WIDTH * DISPLAY_HEIGHT;
-
-constexpr std::array<SDL_Keycode, 16> KEYMAP = {SDLK_1, SDLK_2, SDLK_3, SDLK_4, SDLK_q, SDLK_w,
-                                                SDLK_e, SDLK_r, SDLK_a, SDLK_s, SDLK_d, SDLK_f,
-                                                SDLK_z, SDLK_x, SDLK_c, SDLK_v};
-
-struct SDLCleanup {
-    ~SDLCleanup() { SDL_Quit(); }
-};
-
-class SDLRenderer {
-  public:
-    SDLRenderer() = default;
-    ~SDLRenderer() {
-        if (texture_) SDL_DestroyTexture(texture_);
-        if (renderer_) SDL_DestroyRenderer(renderer_);
-        if (window_) SDL_DestroyWindow(window_);
-    }
-
-    SDLRenderer(const SDLRenderer&) = delete;
-    SDLRenderer& operator=(const SDLRenderer&) = delete;
-    SDLRenderer(SDLRenderer&&) = delete;
-    SDLRenderer& operator=(SDLRenderer&&) = delete;
-
-    [[nodiscard]] bool initialize() {
-        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-            std::cerr << "SDL could not initialize! SDL Error: " << SDL_GetError() << std::endl;
-            return false;
-        }
-
-        window_ =
-            SDL_CreateWindow("CHIP-8 Emulator", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                             WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_SHOWN);
-        if (!window_) {
-            std::cerr << "Window could not be created! SDL Error: " << SDL_GetError() << std::endl;
-            return false;
-        }
-
-        renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_ACCELERATED);
-        if (!renderer_) {
-            std::cerr << "Renderer could not be created! SDL Error: " << SDL_GetError()
-                      << std::endl;
-            return false;
-        }
-
-        texture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_ARGB8888,
-                                     SDL_TEXTUREACCESS_STREAMING, DISPLAY_WIDTH, DISPLAY_HEIGHT);
-        if (!texture_) {
-            std::cerr << "Texture could not be created! SDL Error: " << SDL_GetError() << std::endl;
-            return false;
-        }
-
-        return true;
-    }
-
-    void render(const Chip8& emulator) {
-        if (!emulator.getDrawFlag()) return;
-
-        std::array<std::uint32_t, DISPLAY_SIZE> pixels;
-        const auto& frameBuffer = emulator.getFrameBuffer();
-
-        for (std::size_t i = 0; i < pixels.size(); ++i) {
-            pixels[i] = frameBuffer[i] ? 0xFFFFFFFF : 0xFF000000;
-        }
-
-        SDL_UpdateTexture(texture_, nullptr, pixels.data(), DISPLAY_WIDTH * sizeof(std::uint32_t));
-        SDL_RenderClear(renderer_);
-        SDL_RenderCopy(renderer_, texture_, nullptr, nullptr);
-        SDL_RenderPresent(renderer_);
-    }
-
-  private:
-    SDL_Window* window_ = nullptr;
-    SDL_Renderer* renderer_ = nullptr;
-    SDL_Texture* texture_ = nullptr;
-};
-
-void handleKeyEvent(const SDL_Event& event, Chip8& emulator) {
-    if (event.type != SDL_KEYDOWN && event.type != SDL_KEYUP) return;
-
-    const bool isPressed = (event.type == SDL_KEYDOWN);
-
-    for (std::size_t i = 0; i < KEYMAP.size(); ++i) {
-        if (event.key.keysym.sym == KEYMAP[i]) {
-            emulator.setKeyState(static_cast<std::uint8_t>(i), isPressed);
-            break;
-        }
-    }
-}
-
-void printUsage(std::string_view programName) {
-    std::cerr << "Usage: " << programName << " <rom_file>" << std::endl;
-    std::cerr << "Example: " << programName << " roms/maze.ch8" << std::endl;
-}
-}  // namespace
-
-int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        printUsage(argv[0]);
-        return EXIT_FAILURE;
-    }
-
-    const SDLCleanup sdlCleanup;
-
-    Chip8 emulator;
-
-    if (!emulator.loadRom(argv[1])) {
-        std::cerr << "Failed to load ROM: " << argv[1] << std::endl;
-        return EXIT_FAILURE;
-    }
-
-    SDLRenderer renderer;
-    if (!renderer.initialize()) {
-        return EXIT_FAILURE;
-    }
-
-    SDL_Event event;
-    bool running = true;
-
-    while (running) {
-        emulator.emulateCycle();
-
-        // Check for emulator errors
-        if (emulator.getLastError() != Chip8::ErrorCode::None) {
-            std::cerr << "Emulator error: " << emulator.getLastErrorMessage() << std::endl;
-            // Continue running but log the error
-        }
-
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                running = false;
-            } else {
-                handleKeyEvent(event, emulator);
-            }
-        }
-
-        renderer.render(emulator);
-        if (emulator.getDrawFlag()) {
-            emulator.setDrawFlag(false);
-        }
-
-        SDL_Delay(FRAME_DELAY);
-    }
-
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_events.h>
+#include <SDL2/SDL_keycode.h>
+#include <SDL2/SDL_render.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <variant>
+
+#include "chip8.h"
+#include "chip8_factory.h"
+#include "frame_exchange.h"
+#include "input_recording.h"
+#include "random.h"
+#include "rewind_buffer.h"
+#include "scheduler.h"
+
+namespace {
+constexpr int WINDOW_WIDTH = 1024;
+constexpr int WINDOW_HEIGHT = 512;
+// Pixel colors by plane mask: off, plane 1, plane 2 (XO-CHIP), both planes
+constexpr std::array<std::uint32_t, Chip8::ALL_PLANES + 1> PALETTE = {0xFF000000, 0xFFFFFFFF,
+                                                                      0xFFAAAAAA, 0xFF555555};
+
+constexpr std::array<SDL_Keycode, 16> KEYMAP = {SDLK_1, SDLK_2, SDLK_3, SDLK_4, SDLK_q, SDLK_w,
+                                                SDLK_e, SDLK_r, SDLK_a, SDLK_s, SDLK_d, SDLK_f,
+                                                SDLK_z, SDLK_x, SDLK_c, SDLK_v};
+// Held to step back one recorded refresh per refresh
+constexpr SDL_Keycode REWIND_KEY = SDLK_BACKSPACE;
+constexpr std::size_t BYTES_PER_MEGABYTE = 1024 * 1024;
+
+// A finished frame, handed from the emulation thread to the renderer in
+// threaded mode. The packed planes are small enough to copy every refresh.
+struct Frame {
+    std::array<Chip8::DisplayPlane, Chip8::PLANE_COUNT> planes;
+    bool highResolution;
+};
+
+struct SDLCleanup {
+    ~SDLCleanup() { SDL_Quit(); }
+};
+
+class SDLRenderer {
+  public:
+    SDLRenderer() = default;
+    ~SDLRenderer() {
+        if (texture_) SDL_DestroyTexture(texture_);
+        if (renderer_) SDL_DestroyRenderer(renderer_);
+        if (window_) SDL_DestroyWindow(window_);
+    }
+
+    SDLRenderer(const SDLRenderer&) = delete;
+    SDLRenderer& operator=(const SDLRenderer&) = delete;
+    SDLRenderer(SDLRenderer&&) = delete;
+    SDLRenderer& operator=(SDLRenderer&&) = delete;
+
+    // With vsync, present() blocks until the display's next refresh
+    [[nodiscard]] bool initialize(bool vsync) {
+        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+            std::cerr << "SDL could not initialize! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        window_ =
+            SDL_CreateWindow("CHIP-8 Emulator", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                             WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_SHOWN);
+        if (!window_) {
+            std::cerr << "Window could not be created! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        renderer_ = SDL_CreateRenderer(
+            window_, -1, SDL_RENDERER_ACCELERATED | (vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
+        if (!renderer_) {
+            std::cerr << "Renderer could not be created! SDL Error: " << SDL_GetError()
+                      << std::endl;
+            return false;
+        }
+
+        // Sized for high resolution; low-resolution frames use its top-left
+        // quarter, which is stretched over the window
+        texture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_ARGB8888,
+                                     SDL_TEXTUREACCESS_STREAMING, Chip8::HIRES_DISPLAY_WIDTH,
+                                     Chip8::HIRES_DISPLAY_HEIGHT);
+        if (!texture_) {
+            std::cerr << "Texture could not be created! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        // Start blank, which is what shown_ holds
+        pixels_.fill(PALETTE[0]);
+        SDL_UpdateTexture(texture_, nullptr, pixels_.data(),
+                          Chip8::HIRES_DISPLAY_WIDTH * sizeof(std::uint32_t));
+
+        SDL_RendererInfo info;
+        vsync_ = SDL_GetRendererInfo(renderer_, &info) == 0 &&
+                 (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+        return true;
+    }
+
+    // False when vsync was not requested or the driver ignored it
+    bool hasVsync() const { return vsync_; }
+
+    // Converts and uploads only the rows changed since the last frame; the
+    // texture keeps the rest
+    template <typename Emulator>
+    void render(const Emulator& emulator) {
+        if (!emulator.getDrawFlag()) return;
+
+        const auto& frameBuffer = emulator.getFrameBuffer();
+        image_ = {0, 0, emulator.getDisplayWidth(), emulator.getDisplayHeight()};
+
+        for (const Chip8::RowRange& range : emulator.getDirtyRowRanges()) {
+            const int begin = range.first * image_.w;
+            const int end = begin + range.count * image_.w;
+            for (int i = begin; i < end; ++i) {
+                pixels_[i] = PALETTE[frameBuffer[i] & Chip8::ALL_PLANES];
+            }
+            uploadRows(range.first, range.count);
+        }
+        present();
+    }
+
+    // Threaded mode. The renderer does not see the emulator's dirty rows, so
+    // it compares the frame with the one shown last instead.
+    void render(const Frame& frame) {
+        const bool resized = frame.highResolution != shown_.highResolution;
+        const int width = frame.highResolution ? Chip8::HIRES_DISPLAY_WIDTH : Chip8::DISPLAY_WIDTH;
+        const int height =
+            frame.highResolution ? Chip8::HIRES_DISPLAY_HEIGHT : Chip8::DISPLAY_HEIGHT;
+        image_ = {0, 0, width, height};
+
+        for (int y = 0; y < height; ++y) {
+            const std::size_t row = y * Chip8::DISPLAY_ROW_WORDS;
+            if (!resized && !rowChanged(frame, row)) continue;
+            for (int x = 0; x < width; ++x) {
+                const std::size_t word = row + x / 64;
+                const int bit = 63 - x % 64;
+                const auto plane0 = static_cast<std::uint8_t>(frame.planes[0][word] >> bit & 1);
+                const auto plane1 = static_cast<std::uint8_t>(frame.planes[1][word] >> bit & 1);
+                pixels_[y * width + x] = PALETTE[plane0 | plane1 << 1];
+            }
+            uploadRows(y, 1);
+        }
+        shown_ = frame;
+        present();
+    }
+
+    // Shows the current texture again; with vsync this paces the caller
+    void present() {
+        SDL_RenderClear(renderer_);
+        SDL_RenderCopy(renderer_, texture_, &image_, nullptr);
+        SDL_RenderPresent(renderer_);
+    }
+
+  private:
+    bool rowChanged(const Frame& frame, std::size_t row) const {
+        for (std::size_t plane = 0; plane < Chip8::PLANE_COUNT; ++plane) {
+            for (std::size_t word = row; word < row + Chip8::DISPLAY_ROW_WORDS; ++word) {
+                if (frame.planes[plane][word] != shown_.planes[plane][word]) return true;
+            }
+        }
+        return false;
+    }
+
+    void uploadRows(int first, int count) {
+        const SDL_Rect rows{0, first, image_.w, count};
+        SDL_UpdateTexture(texture_, &rows, pixels_.data() + first * image_.w,
+                          image_.w * sizeof(std::uint32_t));
+    }
+
+    SDL_Window* window_ = nullptr;
+    SDL_Renderer* renderer_ = nullptr;
+    SDL_Texture* texture_ = nullptr;
+    bool vsync_ = false;
+    SDL_Rect image_{0, 0, Chip8::DISPLAY_WIDTH, Chip8::DISPLAY_HEIGHT};
+    std::array<std::uint32_t, Chip8::FRAME_BUFFER_SIZE> pixels_{};
+    Frame shown_{};
+};
+
+// Input from the thread polling events for the thread emulating, which may be
+// the same thread. Keys reach the emulator at the start of each refresh.
+struct Controls {
+    AtomicKeypad keypad;
+    std::atomic<bool> rewinding{false};
+};
+
+// What the emulating thread keeps of a session: refreshes to rewind through
+// and, when recording, the input
+template <typename Emulator>
+struct Session {
+    BasicRewindBuffer<Emulator> rewind;
+    std::optional<InputRecorder> recorder;
+};
+
+void handleKeyEvent(const SDL_Event& event, Controls& controls) {
+    if (event.type != SDL_KEYDOWN && event.type != SDL_KEYUP) return;
+
+    const bool isPressed = (event.type == SDL_KEYDOWN);
+
+    if (event.key.keysym.sym == REWIND_KEY) {
+        controls.rewinding.store(isPressed, std::memory_order_relaxed);
+        return;
+    }
+    for (std::size_t i = 0; i < KEYMAP.size(); ++i) {
+        if (event.key.keysym.sym == KEYMAP[i]) {
+            controls.keypad.setKeyState(static_cast<std::uint8_t>(i), isPressed);
+            break;
+        }
+    }
+}
+
+void printUsage(std::string_view programName) {
+    std::cerr << "Usage: " << programName
+              << " [--quirks=NAME] [--threaded] [--rewind=MB] [--record=FILE] <rom_file> [cpu_hz]"
+              << std::endl;
+    std::cerr << "  --quirks: default, chip8, schip or xochip (detected from the ROM if omitted)"
+              << std::endl;
+    std::cerr << "  --threaded: emulate on a separate thread and present at the display's refresh"
+              << std::endl;
+    std::cerr << "  --rewind: memory for rewinding with Backspace, 0 to disable (default "
+              << SnapshotRing::DEFAULT_BUDGET / BYTES_PER_MEGABYTE << ")" << std::endl;
+    std::cerr << "  --record: save the input to FILE on exit, for replaying the session exactly;"
+              << " needs a nonzero cpu_hz and disables rewinding" << std::endl;
+    std::cerr << "  cpu_hz: instructions per second, 0 for unthrottled (default "
+              << Chip8::DEFAULT_CPU_FREQUENCY << ")" << std::endl;
+    std::cerr << "Example: " << programName << " --quirks=chip8 roms/maze.ch8 700" << std::endl;
+}
+
+bool parseNumber(const char* text, std::uint32_t& number) {
+    char* end = nullptr;
+    const unsigned long value = std::strtoul(text, &end, 10);
+    if (end == text || *end != '\0' || value > std::numeric_limits<std::uint32_t>::max()) {
+        return false;
+    }
+    number = static_cast<std::uint32_t>(value);
+    return true;
+}
+
+using Clock = std::chrono::steady_clock;
+
+// Emulates one refresh and returns the cycles run. Emulator errors are
+// reported and then ignored.
+template <typename Emulator>
+std::uint64_t runRefresh(Emulator& emulator, CycleScheduler& scheduler,
+                         Clock::time_point& previous) {
+    const RefreshResult result = emulateRefresh(emulator, scheduler, previous);
+    if (result.reason == Chip8::StopReason::Error) {
+        std::cerr << "Emulator error: " << emulator.getLastErrorMessage() << std::endl;
+    }
+    return result.cycles;
+}
+
+// Sleeps until the next refresh. A refresh that ran late starts the next one
+// immediately rather than sleeping.
+void waitForRefresh(Clock::time_point& nextRefresh) {
+    nextRefresh += CycleScheduler::REFRESH_PERIOD;
+    const Clock::time_point frameEnd = Clock::now();
+    if (nextRefresh > frameEnd) {
+        std::this_thread::sleep_until(nextRefresh);
+    } else {
+        nextRefresh = frameEnd;
+    }
+}
+
+// Emulates one refresh and records it for rewinding and in the input
+// recording. While the rewind key is held it steps back one recorded refresh
+// instead.
+template <typename Emulator>
+void advanceRefresh(Emulator& emulator, const Controls& controls, Session<Emulator>& session,
+                    CycleScheduler& scheduler, Clock::time_point& previous) {
+    if (controls.rewinding.load(std::memory_order_relaxed)) {
+        if (session.rewind.rewind(emulator)) {
+            emulator.setDrawFlag(true);  // Present the restored display
+        }
+        previous = Clock::now();  // Rewinding doesn't leave cycles owed
+        return;
+    }
+    if (session.recorder) {
+        controls.keypad.applyTo(emulator, *session.recorder);
+        session.recorder->advance(runRefresh(emulator, scheduler, previous));
+    } else {
+        controls.keypad.applyTo(emulator);
+        runRefresh(emulator, scheduler, previous);
+    }
+    session.rewind.capture(emulator);
+}
+
+// Returns false once the window is closed
+bool pollEvents(Controls& controls) {
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        if (event.type == SDL_QUIT) {
+            return false;
+        }
+        handleKeyEvent(event, controls);
+    }
+    return true;
+}
+
+// Emulation, input and presenting take turns on one thread, presenting at
+// most once per refresh
+template <typename Emulator>
+void runSingleThreaded(Emulator& emulator, SDLRenderer& renderer, Session<Emulator>& session) {
+    Controls controls;
+    CycleScheduler scheduler(emulator.getCpuFrequency());
+    Clock::time_point previous = Clock::now();
+    Clock::time_point nextRefresh = previous;
+
+    while (pollEvents(controls)) {
+        advanceRefresh(emulator, controls, session, scheduler, previous);
+
+        renderer.render(emulator);
+        if (emulator.getDrawFlag()) {
+            emulator.setDrawFlag(false);
+            emulator.acknowledgeDirtyRows();
+        }
+
+        waitForRefresh(nextRefresh);
+    }
+}
+
+// The emulator runs on its own thread, paced by the refresh period as in
+// single-threaded mode, and owns the session. It reads keys from an atomic
+// keypad and publishes each changed display through a triple buffer, so it
+// never waits on the UI.
+// The UI thread polls events and presents the newest frame, paced by vsync
+// when the driver provides it.
+template <typename Emulator>
+void runThreaded(Emulator& emulator, SDLRenderer& renderer, Session<Emulator>& session) {
+    TripleBuffer<Frame> frames;
+    Controls controls;
+    std::atomic<bool> running{true};
+
+    std::thread emulation([&] {
+        CycleScheduler scheduler(emulator.getCpuFrequency());
+        Clock::time_point previous = Clock::now();
+        Clock::time_point nextRefresh = previous;
+
+        while (running.load(std::memory_order_relaxed)) {
+            advanceRefresh(emulator, controls, session, scheduler, previous);
+
+            if (emulator.getDrawFlag()) {
+                emulator.setDrawFlag(false);
+                emulator.acknowledgeDirtyRows();
+                Frame& frame = frames.writeBuffer();
+                frame.planes = {emulator.getDisplayPlane(0), emulator.getDisplayPlane(1)};
+                frame.highResolution = emulator.isHighResolution();
+                frames.publish();
+            }
+
+            waitForRefresh(nextRefresh);
+        }
+    });
+
+    Clock::time_point nextRefresh = Clock::now();
+    while (pollEvents(controls)) {
+        if (frames.update()) {
+            renderer.render(frames.readBuffer());
+        } else {
+            renderer.present();
+        }
+        if (!renderer.hasVsync()) {
+            waitForRefresh(nextRefresh);
+        }
+    }
+
+    running.store(false, std::memory_order_relaxed);
+    emulation.join();
+}
+
+// The main loop, compiled once per quirk profile. A recording replays only
+// from the start, so recording leaves the rewind budget empty.
+template <typename Emulator>
+int runEmulator(Emulator& emulator, const char* romPath, std::uint32_t cpuFrequency,
+                bool threaded, std::size_t rewindBudget, QuirkProfile profile,
+                const char* recordPath) {
+    emulator.setCpuFrequency(cpuFrequency);
+
+    if (!emulator.loadRom(romPath)) {
+        std::cerr << emulator.getLastErrorMessage() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    SDLRenderer renderer;
+    if (!renderer.initialize(threaded)) {
+        return EXIT_FAILURE;
+    }
+
+    Session<Emulator> session{BasicRewindBuffer<Emulator>(recordPath ? 0 : rewindBudget), {}};
+    if (recordPath) {
+        session.recorder.emplace(profile, cpuFrequency, freshSeed());
+        prepareForRecording(emulator, session.recorder->getRecording());
+    }
+    session.rewind.capture(emulator);
+    if (threaded) {
+        runThreaded(emulator, renderer, session);
+    } else {
+        runSingleThreaded(emulator, renderer, session);
+    }
+
+    if (recordPath && !saveRecording(recordPath, session.recorder->getRecording())) {
+        std::cerr << "Could not write the recording to " << recordPath << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    // Positional arguments are the ROM and an optional CPU frequency
+    const char* romPath = nullptr;
+    const char* frequencyText = nullptr;
+    const char* quirksName = nullptr;
+    const char* rewindText = nullptr;
+    const char* recordPath = nullptr;
+    bool threaded = false;
+    bool validArguments = true;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument = argv[i];
+        if (argument.rfind("--quirks=", 0) == 0) {
+            quirksName = argv[i] + 9;
+        } else if (argument == "--threaded") {
+            threaded = true;
+        } else if (argument.rfind("--rewind=", 0) == 0) {
+            rewindText = argv[i] + 9;
+        } else if (argument.rfind("--record=", 0) == 0) {
+            recordPath = argv[i] + 9;
+        } else if (!romPath) {
+            romPath = argv[i];
+        } else if (!frequencyText) {
+            frequencyText = argv[i];
+        } else {
+            validArguments = false;
+        }
+    }
+
+    std::uint32_t cpuFrequency = Chip8::DEFAULT_CPU_FREQUENCY;
+    std::uint32_t rewindMegabytes = SnapshotRing::DEFAULT_BUDGET / BYTES_PER_MEGABYTE;
+    QuirkProfile profile = QuirkProfile::Default;
+    if (!validArguments || !romPath ||
+        (frequencyText && !parseNumber(frequencyText, cpuFrequency)) ||
+        (rewindText && !parseNumber(rewindText, rewindMegabytes)) ||
+        (quirksName && !parseQuirkProfile(quirksName, profile)) ||
+        (recordPath && (*recordPath == '\0' || cpuFrequency == 0))) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!quirksName) {
+        profile = detectQuirkProfile(std::string(romPath));
+    }
+
+    const SDLCleanup sdlCleanup;
+
+    const auto emulator = makeChip8(profile);
+    return std::visit(
+        [&](auto& chip8) {
+            return runEmulator(chip8, romPath, cpuFrequency, threaded,
+                               std::size_t{rewindMegabytes} * BYTES_PER_MEGABYTE, profile,
+                               recordPath);
+        },
+        *emulator);
+}
@@ -0,0 +1,85 @@
+#include "mapped_file.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CHIP8_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CHIP8_HAS_MMAP 0
+#include <fstream>
+#include <ios>
+#endif
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#if CHIP8_HAS_MMAP
+    descriptor_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor_ < 0) {
+        return false;
+    }
+    struct stat status {};
+    if (::fstat(descriptor_, &status) != 0 || !S_ISREG(status.st_mode)) {
+        close();
+        return false;
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    const std::streamsize size = file.is_open() ? static_cast<std::streamsize>(file.tellg()) : -1;
+    if (size < 0) {
+        return false;
+    }
+    size_ = static_cast<std::size_t>(size);
+#endif
+    path_ = path;
+    return true;
+}
+
+bool MappedFile::load() {
+    if (path_.empty()) {
+        return false;
+    }
+    if (data_ || size_ == 0) {
+        return true;
+    }
+#if CHIP8_HAS_MMAP
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor_, 0);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    // The mapping outlives the descriptor
+    ::close(descriptor_);
+    descriptor_ = -1;
+    data_ = static_cast<const std::uint8_t*>(mapping);
+    mapped_ = true;
+#else
+    std::ifstream file(path_, std::ios::binary);
+    buffer_.resize(size_);
+    if (!file.read(reinterpret_cast<char*>(buffer_.data()),
+                   static_cast<std::streamsize>(size_))) {
+        buffer_.clear();
+        return false;
+    }
+    data_ = buffer_.data();
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+#if CHIP8_HAS_MMAP
+    if (mapped_) {
+        ::munmap(const_cast<std::uint8_t*>(data_), size_);
+    }
+    if (descriptor_ >= 0) {
+        ::close(descriptor_);
+    }
+#endif
+    descriptor_ = -1;
+    path_.clear();
+    size_ = 0;
+    data_ = nullptr;
+    mapped_ = false;
+    buffer_ = {};
+}
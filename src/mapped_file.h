@@ -0,0 +1,40 @@
+#ifndef CHIP8_MAPPED_FILE_H
+#define CHIP8_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A read-only view of a whole file. open() only finds the size, so a caller
+// can reject a file by size before touching its contents. load() then maps
+// the file where the platform has mmap, which costs no buffer and no copy,
+// and reads it into memory elsewhere.
+class MappedFile {
+  public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Fails when the file cannot be opened or is not a regular file
+    bool open(const std::string& path);
+    // Fails when the contents cannot be mapped or read. An empty file loads
+    // with a null data().
+    bool load();
+    void close();
+
+    std::size_t size() const { return size_; }
+    const std::uint8_t* data() const { return data_; }
+
+  private:
+    int descriptor_ = -1;         // Open between open() and load() with mmap
+    std::string path_;            // For reading without mmap
+    std::size_t size_ = 0;
+    const std::uint8_t* data_ = nullptr;
+    bool mapped_ = false;
+    std::vector<std::uint8_t> buffer_;  // The contents without mmap
+};
+
+#endif
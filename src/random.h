@@ -1,41 +1,96 @@
-#ifndef RANDOM_MT_H
-#define RANDOM_MT_H
+#ifndef CHIP8_RANDOM_H
+#define CHIP8_RANDOM_H
 
+#include <array>
+#include <atomic>
 #include <chrono>
-#include <random>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 
-namespace Random {
+// Random number generators for CXNN, one per emulator, picked by BasicChip8's
+// Rng parameter. A generator is a UniformRandomBitGenerator with 32-bit
+// results. seed() derives its whole state from a 64-bit seed. The state is a
+// public std::array of unsigned integers named state, so that the generator
+// is trivially copyable and is saved with the machine state.
 
-inline std::mt19937 generate() {
-    std::random_device rd{};
+// SplitMix64 (Steele, Lea and Flood), used to spread a seed over a larger
+// state; consecutive seeds give unrelated states
+constexpr std::uint64_t splitMix64(std::uint64_t& x) {
+    std::uint64_t z = (x += 0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    return z ^ (z >> 31);
+}
 
-    std::seed_seq ss{static_cast<std::seed_seq::result_type>(
-                         std::chrono::steady_clock::now().time_since_epoch().count()),
-                     rd(),
-                     rd(),
-                     rd(),
-                     rd(),
-                     rd(),
-                     rd(),
-                     rd()};
+// xoshiro128++ (Blackman and Vigna): 16 bytes of state, a few adds, shifts
+// and rotates per number
+struct Xoshiro128PlusPlus {
+    using result_type = std::uint32_t;
 
-    return std::mt19937{ss};
-}
+    std::array<std::uint32_t, 4> state;
 
-inline std::mt19937 mt{generate()};
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
 
-inline int get(int min, int max) { return std::uniform_int_distribution<int>{min, max}(mt); }
+    constexpr void seed(std::uint64_t value) {
+        for (std::size_t i = 0; i < state.size(); i += 2) {
+            const std::uint64_t bits = splitMix64(value);
+            state[i] = static_cast<std::uint32_t>(bits);
+            state[i + 1] = static_cast<std::uint32_t>(bits >> 32);
+        }
+    }
 
-template <typename T>
-T get(T min, T max) {
-    return std::uniform_int_distribution<T>{min, max}(mt);
-}
+    constexpr result_type operator()() {
+        const std::uint32_t result = rotl(state[0] + state[3], 7) + state[0];
+        const std::uint32_t t = state[1] << 9;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 11);
+        return result;
+    }
 
-template <typename R, typename S, typename T>
-R get(S min, T max) {
-    return get<R>(static_cast<R>(min), static_cast<R>(max));
-}
+  private:
+    static constexpr std::uint32_t rotl(std::uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+};
+
+// PCG32, XSH RR variant (O'Neill): a 64-bit LCG state and stream, output
+// through a xorshift and a data-dependent rotation
+struct Pcg32 {
+    using result_type = std::uint32_t;
 
-}  // namespace Random
+    std::array<std::uint64_t, 2> state;  // The LCG state and the increment, which is odd
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    constexpr void seed(std::uint64_t value) {
+        state[0] = splitMix64(value);
+        state[1] = splitMix64(value) | 1;
+    }
+
+    constexpr result_type operator()() {
+        const std::uint64_t old = state[0];
+        state[0] = old * 6364136223846793005 + state[1];
+        const auto xorShifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+        const auto rotation = static_cast<std::uint32_t>(old >> 59);
+        return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+    }
+};
+
+// A seed for an emulator that was not given one. Each call returns a
+// different value, even for emulators created in the same clock tick.
+inline std::uint64_t freshSeed() {
+    static std::atomic<std::uint64_t> counter{0};
+    std::uint64_t seed = static_cast<std::uint64_t>(
+                             std::chrono::steady_clock::now().time_since_epoch().count()) ^
+                         counter.fetch_add(1, std::memory_order_relaxed) << 32;
+    return splitMix64(seed);
+}
 
 #endif
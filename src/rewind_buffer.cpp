@@ -0,0 +1,210 @@
+#include "rewind_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// A delta is a series of runs, each an unchanged length, a changed length and
+// the changed bytes XORed with the keyframe. Lengths are LEB128 varints.
+// Changed runs extend over equal stretches shorter than MIN_EQUAL_RUN, which
+// are cheaper as XORed zeros than as the start of a new run.
+constexpr std::size_t MIN_EQUAL_RUN = 8;
+// The index holds one entry per this many bytes of budget
+constexpr std::size_t BUDGET_PER_ENTRY = 256;
+
+void putLength(std::vector<std::uint8_t>& out, std::size_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+std::size_t getLength(const std::uint8_t*& in) {
+    std::size_t value = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        const std::uint8_t byte = *in++;
+        value |= std::size_t{byte & 0x7Fu} << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+}
+
+std::uint64_t loadWord(const std::uint8_t* bytes) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+}  // namespace
+
+SnapshotRing::SnapshotRing(std::size_t stateSize, std::size_t budget,
+                           std::uint32_t keyframeInterval)
+    : stateSize_(stateSize),
+      budget_(budget),
+      keyframeInterval_(std::max<std::uint32_t>(keyframeInterval, 1)),
+      entries_(std::max<std::size_t>(budget / BUDGET_PER_ENTRY, 1)),
+      storage_(budget - std::min(budget, entries_.size() * sizeof(Entry))),
+      keyframe_(stateSize) {
+    scratch_.reserve(stateSize + 2 * sizeof(std::size_t));
+}
+
+bool SnapshotRing::push(const std::uint8_t* state) {
+    if (stateSize_ > storage_.size()) {
+        return false;
+    }
+
+    bool keyframe = count_ == 0 || sinceKeyframe_ + 1 >= keyframeInterval_;
+    if (!keyframe) {
+        encodeDelta(state);
+        keyframe = scratch_.size() >= stateSize_;
+    }
+    std::size_t offset = 0;
+    if (!keyframe) {
+        offset = makeRoom(scratch_.size());
+        // Making room dropped the delta's own keyframe
+        keyframe = count_ == 0;
+    }
+
+    if (keyframe) {
+        offset = makeRoom(stateSize_);
+        std::memcpy(keyframe_.data(), state, stateSize_);
+        append(offset, state, stateSize_, true);
+        sinceKeyframe_ = 0;
+    } else {
+        append(offset, scratch_.data(), scratch_.size(), false);
+        ++sinceKeyframe_;
+    }
+    return true;
+}
+
+bool SnapshotRing::stepBack(std::uint8_t* state) {
+    if (count_ < 2) {
+        return false;
+    }
+
+    const Entry dropped = entry(count_ - 1);
+    --count_;
+    storedBytes_ -= dropped.size;
+    const Entry& newest = entry(count_ - 1);
+    head_ = newest.offset + newest.size;
+
+    if (dropped.keyframe) {
+        // Back into the previous keyframe's deltas. The oldest snapshot is
+        // always a keyframe, so the search ends.
+        std::size_t key = count_ - 1;
+        while (!entry(key).keyframe) {
+            --key;
+        }
+        std::memcpy(keyframe_.data(), storage_.data() + entry(key).offset, stateSize_);
+        sinceKeyframe_ = count_ - 1 - key;
+    } else {
+        --sinceKeyframe_;
+    }
+
+    if (newest.keyframe) {
+        std::memcpy(state, keyframe_.data(), stateSize_);
+    } else {
+        decodeDelta(newest, state);
+    }
+    return true;
+}
+
+void SnapshotRing::clear() {
+    first_ = 0;
+    count_ = 0;
+    head_ = 0;
+    storedBytes_ = 0;
+    sinceKeyframe_ = 0;
+}
+
+void SnapshotRing::dropOldestGroup() {
+    do {
+        storedBytes_ -= entry(0).size;
+        first_ = (first_ + 1) % entries_.size();
+        --count_;
+    } while (count_ > 0 && !entry(0).keyframe);
+}
+
+std::size_t SnapshotRing::makeRoom(std::size_t size) {
+    if (count_ == entries_.size()) {
+        dropOldestGroup();
+    }
+
+    // Snapshots at or past head_ are left from the previous lap around the
+    // storage, and are the oldest. A snapshot that does not fit before the
+    // end starts the next lap, and the rest of the previous one is dropped.
+    std::size_t offset = head_;
+    if (offset + size > storage_.size()) {
+        while (count_ > 0 && entry(0).offset >= head_) {
+            dropOldestGroup();
+        }
+        offset = 0;
+    }
+    while (count_ > 0 && entry(0).offset >= offset && entry(0).offset < offset + size) {
+        dropOldestGroup();
+    }
+    return offset;
+}
+
+void SnapshotRing::append(std::size_t offset, const std::uint8_t* data, std::size_t size,
+                          bool keyframe) {
+    std::copy(data, data + size, storage_.begin() + static_cast<std::ptrdiff_t>(offset));
+    entry(count_) = Entry{offset, size, keyframe};
+    ++count_;
+    head_ = offset + size;
+    storedBytes_ += size;
+}
+
+void SnapshotRing::encodeDelta(const std::uint8_t* state) {
+    const std::uint8_t* keyframe = keyframe_.data();
+    scratch_.clear();
+    std::size_t written = 0;  // End of the last run
+    std::size_t i = 0;
+    while (scratch_.size() < stateSize_) {
+        // Unchanged bytes, a word at a time while whole words match
+        while (i + sizeof(std::uint64_t) <= stateSize_ &&
+               loadWord(state + i) == loadWord(keyframe + i)) {
+            i += sizeof(std::uint64_t);
+        }
+        while (i < stateSize_ && state[i] == keyframe[i]) {
+            ++i;
+        }
+        if (i == stateSize_) {
+            break;
+        }
+
+        const std::size_t changed = i;
+        std::size_t equal = 0;
+        while (i < stateSize_ && equal < MIN_EQUAL_RUN) {
+            equal = state[i] == keyframe[i] ? equal + 1 : 0;
+            ++i;
+        }
+        i -= equal;
+
+        putLength(scratch_, changed - written);
+        putLength(scratch_, i - changed);
+        for (std::size_t j = changed; j < i; ++j) {
+            scratch_.push_back(static_cast<std::uint8_t>(state[j] ^ keyframe[j]));
+        }
+        written = i;
+    }
+}
+
+void SnapshotRing::decodeDelta(const Entry& delta, std::uint8_t* state) const {
+    std::memcpy(state, keyframe_.data(), stateSize_);
+    const std::uint8_t* in = storage_.data() + delta.offset;
+    const std::uint8_t* const end = in + delta.size;
+    std::size_t position = 0;
+    while (in < end) {
+        position += getLength(in);
+        const std::size_t length = getLength(in);
+        for (std::size_t j = 0; j < length; ++j) {
+            state[position + j] ^= in[j];
+        }
+        in += length;
+        position += length;
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef CHIP8_REWIND_BUFFER_H
+#define CHIP8_REWIND_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "chip8.h"
+
+// A bounded history of fixed-size states, newest last, for stepping an
+// emulator backwards. Every keyframeInterval-th snapshot is a keyframe and is
+// stored whole. The others are stored as the XOR of the state with the latest
+// keyframe, run-length coded, so bytes that match the keyframe cost nothing
+// and any snapshot decodes from its keyframe alone.
+//
+// Snapshots are packed into one ring of storage and found through a
+// fixed-size index, and the two together stay within the budget. When a new
+// snapshot does not fit, the oldest keyframe is dropped with its deltas.
+class SnapshotRing {
+  public:
+    static constexpr std::size_t DEFAULT_BUDGET = 16 * 1024 * 1024;
+    // One keyframe per second when a snapshot is taken every refresh
+    static constexpr std::uint32_t DEFAULT_KEYFRAME_INTERVAL = 60;
+
+    // The whole budget is allocated here. An interval of 0 or 1 makes every
+    // snapshot a keyframe.
+    SnapshotRing(std::size_t stateSize, std::size_t budget, std::uint32_t keyframeInterval);
+
+    // Appends a snapshot of stateSize bytes, dropping the oldest ones to make
+    // room. Fails, changing nothing, when one keyframe exceeds the budget.
+    bool push(const std::uint8_t* state);
+    // Drops the newest snapshot and decodes the one before it, now the
+    // newest, into state. Fails, changing nothing, with fewer than two.
+    bool stepBack(std::uint8_t* state);
+    void clear();
+
+    std::size_t size() const { return count_; }
+    std::size_t getStateSize() const { return stateSize_; }
+    std::size_t getBudget() const { return budget_; }
+    // Encoded bytes of the snapshots held, excluding the index
+    std::size_t getStoredBytes() const { return storedBytes_; }
+
+  private:
+    struct Entry {
+        std::size_t offset;
+        std::size_t size;
+        bool keyframe;
+    };
+
+    // The i-th oldest snapshot
+    Entry& entry(std::size_t i) { return entries_[(first_ + i) % entries_.size()]; }
+    // Drops snapshots from the oldest up to the next keyframe
+    void dropOldestGroup();
+    // Frees size contiguous bytes and returns their offset
+    std::size_t makeRoom(std::size_t size);
+    void append(std::size_t offset, const std::uint8_t* data, std::size_t size, bool keyframe);
+    // Leaves the delta of state against keyframe_ in scratch_, stopping early
+    // once it is as large as the state
+    void encodeDelta(const std::uint8_t* state);
+    void decodeDelta(const Entry& delta, std::uint8_t* state) const;
+
+    std::size_t stateSize_;
+    std::size_t budget_;
+    std::uint32_t keyframeInterval_;
+    std::vector<Entry> entries_;       // Circular, from first_
+    std::vector<std::uint8_t> storage_;
+    std::vector<std::uint8_t> keyframe_;  // The newest snapshot's keyframe, decoded
+    std::vector<std::uint8_t> scratch_;
+    std::size_t first_ = 0;
+    std::size_t count_ = 0;
+    std::size_t head_ = 0;  // Where the next snapshot goes, unless it must wrap
+    std::size_t storedBytes_ = 0;
+    std::size_t sinceKeyframe_ = 0;  // Deltas after the newest keyframe
+};
+
+// Rewind for one emulator: capture() after each frame, rewind() to go back a
+// frame. Works with any BasicChip8 instantiation, through its MachineState.
+template <typename Emulator = Chip8>
+class BasicRewindBuffer {
+  public:
+    using State = typename Emulator::MachineState;
+
+    explicit BasicRewindBuffer(
+        std::size_t budget = SnapshotRing::DEFAULT_BUDGET,
+        std::uint32_t keyframeInterval = SnapshotRing::DEFAULT_KEYFRAME_INTERVAL)
+        : snapshots_(sizeof(State), budget, keyframeInterval), state_(std::make_unique<State>()) {}
+
+    // Returns false when the budget cannot hold even one snapshot
+    bool capture(const Emulator& emulator) {
+        emulator.saveState(*state_);
+        return snapshots_.push(reinterpret_cast<const std::uint8_t*>(state_.get()));
+    }
+
+    // Restores the snapshot before the newest and drops the newest. With a
+    // capture after every frame, the newest is the frame on screen, so this
+    // steps back one frame. Returns false, leaving the emulator alone, at the
+    // oldest snapshot held.
+    bool rewind(Emulator& emulator) {
+        if (!snapshots_.stepBack(reinterpret_cast<std::uint8_t*>(state_.get()))) {
+            return false;
+        }
+        emulator.loadState(*state_);
+        return true;
+    }
+
+    void clear() { snapshots_.clear(); }
+    std::size_t size() const { return snapshots_.size(); }
+    std::size_t getBudget() const { return snapshots_.getBudget(); }
+    std::size_t getStoredBytes() const { return snapshots_.getStoredBytes(); }
+
+  private:
+    SnapshotRing snapshots_;
+    std::unique_ptr<State> state_;  // Scratch; 64 KB and up under XO-CHIP
+};
+
+using RewindBuffer = BasicRewindBuffer<>;
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef CHIP8_SCHEDULER_H
+#define CHIP8_SCHEDULER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "chip8.h"
+
+// Turns elapsed host time into emulated CPU cycles for a frontend loop that
+// presents once per display refresh. Fractions of a cycle carry over, so the
+// long-run rate is exact. After a late frame the missed cycles are returned as
+// one batch, but never more than MAX_CATCH_UP_FRAMES refreshes' worth: after a
+// long stall the game loses that time instead of fast-forwarding through it.
+class CycleScheduler {
+  public:
+    static constexpr std::uint32_t REFRESH_RATE = 60;
+    static constexpr std::uint32_t MAX_CATCH_UP_FRAMES = 4;
+    static constexpr std::chrono::nanoseconds REFRESH_PERIOD{1000000000 / REFRESH_RATE};
+    // Unthrottled refreshes run batches of this many cycles until the slice of
+    // the refresh reserved for emulation is used up
+    static constexpr std::uint32_t UNTHROTTLED_BATCH = 10000;
+    static constexpr std::chrono::nanoseconds UNTHROTTLED_SLICE = REFRESH_PERIOD * 3 / 4;
+
+    // cpuFrequency 0 means unthrottled; cycles() then always returns 0 and the
+    // frontend runs as much as fits in each refresh instead
+    explicit CycleScheduler(std::uint32_t cpuFrequency) : cpuFrequency_(cpuFrequency) {}
+
+    std::uint32_t cycles(std::chrono::nanoseconds elapsed) {
+        const std::chrono::nanoseconds limit = REFRESH_PERIOD * MAX_CATCH_UP_FRAMES;
+        if (elapsed > limit) {
+            elapsed = limit;
+            remainder_ = 0;
+        }
+        const std::uint64_t total =
+            remainder_ + static_cast<std::uint64_t>(std::max<std::int64_t>(elapsed.count(), 0)) *
+                             cpuFrequency_;
+        remainder_ = total % NANOSECONDS_PER_SECOND;
+        return static_cast<std::uint32_t>(total / NANOSECONDS_PER_SECOND);
+    }
+
+    std::uint32_t getCpuFrequency() const { return cpuFrequency_; }
+
+  private:
+    static constexpr std::uint64_t NANOSECONDS_PER_SECOND = 1000000000;
+
+    std::uint32_t cpuFrequency_;
+    std::uint64_t remainder_ = 0;  // Leftover cycle fraction, times NANOSECONDS_PER_SECOND
+};
+
+struct RefreshResult {
+    std::uint64_t cycles;
+    Chip8Base::StopReason reason;  // Why the last batch of the refresh stopped
+};
+
+// Runs the cycles owed since `previous`; after a late frame this is a larger
+// batch that catches up. The timers follow the emulated clock, except when
+// unthrottled, where they tick once per refresh. A ROM waiting for a key uses
+// up a throttled refresh's cycles in one call and ends an unthrottled refresh
+// early, since no key changes before the next one.
+template <typename Emulator, typename Clock = std::chrono::steady_clock>
+RefreshResult emulateRefresh(Emulator& emulator, CycleScheduler& scheduler,
+                             typename Clock::time_point& previous) {
+    const typename Clock::time_point now = Clock::now();
+    RefreshResult result{0, Chip8Base::StopReason::CycleLimit};
+    if (scheduler.getCpuFrequency() == 0) {
+        const typename Clock::time_point deadline = now + CycleScheduler::UNTHROTTLED_SLICE;
+        do {
+            const Chip8Base::RunResult run =
+                emulator.runCyclesThroughKeyWaits(CycleScheduler::UNTHROTTLED_BATCH);
+            result.cycles += run.cycles;
+            result.reason = run.reason;
+        } while (result.reason == Chip8Base::StopReason::CycleLimit && Clock::now() < deadline);
+        emulator.tickTimers();
+    } else {
+        const Chip8Base::RunResult run =
+            emulator.runCyclesThroughKeyWaits(scheduler.cycles(now - previous));
+        result = RefreshResult{run.cycles, run.reason};
+    }
+    previous = now;
+    return result;
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef CHIP8_STATE_IO_H
+#define CHIP8_STATE_IO_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Little-endian encoding for the saved state and input recording formats
+
+class StateWriter {
+  public:
+    explicit StateWriter(std::vector<std::uint8_t>& out) : out_(out) {}
+
+    template <typename T>
+    void put(T value) {
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            out_.push_back(static_cast<std::uint8_t>(static_cast<std::uint64_t>(value) >> (8 * i)));
+        }
+    }
+    template <typename T, std::size_t N>
+    void put(const std::array<T, N>& values) {
+        for (const T& value : values) {
+            put(value);
+        }
+    }
+
+  private:
+    std::vector<std::uint8_t>& out_;
+};
+
+// Reads what StateWriter wrote. Reading past the end zero-fills and makes
+// finished() false, so fields can be read unchecked and validated once.
+class StateReader {
+  public:
+    explicit StateReader(const std::vector<std::uint8_t>& in) : in_(in) {}
+
+    template <typename T>
+    void get(T& value) {
+        std::uint64_t bits = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            bits |= std::uint64_t{next()} << (8 * i);
+        }
+        value = static_cast<T>(bits);
+    }
+    template <typename T, std::size_t N>
+    void get(std::array<T, N>& values) {
+        for (T& value : values) {
+            get(value);
+        }
+    }
+    // Flags are stored as 0 or 1; anything else marks the data invalid
+    void get(bool& value) {
+        const std::uint8_t byte = next();
+        valid_ = valid_ && byte <= 1;
+        value = byte != 0;
+    }
+
+    bool finished() const { return valid_ && offset_ == in_.size(); }
+
+  private:
+    std::uint8_t next() {
+        if (offset_ >= in_.size()) {
+            valid_ = false;
+            return 0;
+        }
+        return in_[offset_++];
+    }
+
+    const std::vector<std::uint8_t>& in_;
+    std::size_t offset_ = 0;
+    bool valid_ = true;
+};
+
+#endif
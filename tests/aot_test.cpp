@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../src/chip8.h"
+#include "test_helpers.h"
+
+// Generated by chip8-aot from roms/ at build time
+extern const Chip8::CompiledRom airplane_compiled;
+extern const Chip8::CompiledRom connect4_compiled;
+extern const Chip8::CompiledRom maze_compiled;
+
+namespace {
+
+struct CompiledRomCase {
+    const char* rom;
+    const Chip8::CompiledRom* compiled;
+};
+
+std::string romPath(const char* rom) { return std::string(CHIP8_ROM_DIR) + "/" + rom + ".ch8"; }
+
+// Presses a different key every few chunks so input-driven paths run too
+void applyInput(Chip8& emulator, std::uint32_t chunk) {
+    for (std::uint8_t key = 0; key < Chip8::KEYBOARD_SIZE; ++key) {
+        emulator.setKeyState(key, (chunk / 3) % 20 == key);
+    }
+}
+
+class AotTest : public ::testing::TestWithParam<CompiledRomCase> {};
+
+TEST_P(AotTest, MatchesInterpreter) {
+    const CompiledRomCase& param = GetParam();
+    const std::vector<std::uint32_t> chunks = {1, 2, 3, 5, 64, 100, 997, 4096, 20000, 70000};
+
+    // Run the compiled code first and keep a snapshot after every chunk; both
+    // passes draw the same CXNN values from generators given the same seed
+    Chip8 compiled;
+    ASSERT_TRUE(compiled.loadRom(romPath(param.rom)));
+    ASSERT_TRUE(compiled.attachCompiledRom(*param.compiled));
+
+    compiled.setRandomSeed(1234);
+    std::vector<Chip8> snapshots;
+    std::vector<std::uint32_t> executed;
+    for (std::uint32_t chunk = 0; chunk < 60; ++chunk) {
+        applyInput(compiled, chunk);
+        // Every other round runs through key waits, so compiled FX0A skips too
+        const std::uint32_t cycles = chunks[chunk % chunks.size()];
+        const Chip8::RunResult result = (chunk / chunks.size()) % 2 == 0
+                                            ? compiled.runCycles(cycles)
+                                            : compiled.runCyclesThroughKeyWaits(cycles);
+        ASSERT_NE(result.reason, Chip8::StopReason::Error) << compiled.getLastErrorMessage();
+        executed.push_back(result.cycles);
+        snapshots.push_back(compiled);
+    }
+
+    Chip8 reference;
+    ASSERT_TRUE(reference.loadRom(romPath(param.rom)));
+
+    reference.setRandomSeed(1234);
+    for (std::uint32_t chunk = 0; chunk < snapshots.size(); ++chunk) {
+        applyInput(reference, chunk);
+        for (std::uint32_t i = 0; i < executed[chunk]; ++i) {
+            reference.emulateCycle();
+        }
+
+        SCOPED_TRACE(chunk);
+        expectSameState(reference, snapshots[chunk]);
+    }
+}
+
+TEST_P(AotTest, ModifiedCodeFallsBackToInterpreter) {
+    const CompiledRomCase& param = GetParam();
+
+    Chip8 compiled;
+    Chip8 reference;
+    ASSERT_TRUE(compiled.loadRom(romPath(param.rom)));
+    ASSERT_TRUE(reference.loadRom(romPath(param.rom)));
+    ASSERT_TRUE(compiled.attachCompiledRom(*param.compiled));
+
+    // Turn the first instruction into V0 = 0x42 followed by whatever came next
+    for (Chip8* emulator : {&compiled, &reference}) {
+        emulator->setMemory(Chip8::ROM_START_ADDRESS, 0x60);
+        emulator->setMemory(Chip8::ROM_START_ADDRESS + 1, 0x42);
+    }
+
+    compiled.setRandomSeed(99);
+    reference.setRandomSeed(99);
+    const Chip8::RunResult result = compiled.runCycles(5000);
+    for (std::uint32_t i = 0; i < result.cycles; ++i) {
+        reference.emulateCycle();
+    }
+    // A run that stops at the program counter check has not counted it as a
+    // cycle; single-stepping reports the same error on the next call
+    if (result.reason == Chip8::StopReason::Error &&
+        reference.getLastError() == Chip8::ErrorCode::None) {
+        reference.emulateCycle();
+    }
+
+    EXPECT_TRUE(compiled.hasCompiledRom());
+    expectSameState(reference, compiled);
+}
+
+INSTANTIATE_TEST_SUITE_P(BundledRoms, AotTest,
+                         ::testing::Values(CompiledRomCase{"airplane", &airplane_compiled},
+                                           CompiledRomCase{"connect4", &connect4_compiled},
+                                           CompiledRomCase{"maze", &maze_compiled}),
+                         [](const ::testing::TestParamInfo<CompiledRomCase>& info) {
+                             return std::string(info.param.rom);
+                         });
+
+TEST(AotAttachTest, RejectsDifferentImageAndDetachesOnLoad) {
+    Chip8 emulator;
+    ASSERT_TRUE(emulator.loadRom(romPath("airplane")));
+
+    EXPECT_FALSE(emulator.attachCompiledRom(maze_compiled));
+    EXPECT_FALSE(emulator.hasCompiledRom());
+    EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::InvalidMemoryAccess);
+
+    EXPECT_TRUE(emulator.attachCompiledRom(airplane_compiled));
+    EXPECT_TRUE(emulator.hasCompiledRom());
+
+    ASSERT_TRUE(emulator.loadRom(romPath("maze")));
+    EXPECT_FALSE(emulator.hasCompiledRom());
+}
+
+}  // namespace
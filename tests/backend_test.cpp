@@ -0,0 +1,424 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../src/chip8.h"
+#include "test_helpers.h"
+
+namespace {
+
+// Nested loops with a subroutine call, skips, sprite drawing and BCD stores
+const std::vector<std::uint8_t> LOOP_PROGRAM = {
+    0x00, 0xE0,  // 0x200: Clear screen
+    0x60, 0x00,  // 0x202: V0 = 0
+    0x61, 0x00,  // 0x204: V1 = 0
+    0x63, 0x05,  // 0x206: V3 = 5 (delay)
+    0xF3, 0x15,  // 0x208: DT = V3
+    0x22, 0x20,  // 0x20A: Call 0x220
+    0x70, 0x01,  // 0x20C: V0 += 1
+    0x30, 0x10,  // 0x20E: Skip if V0 == 16
+    0x12, 0x0A,  // 0x210: Jump to 0x20A
+    0x71, 0x01,  // 0x212: V1 += 1
+    0x60, 0x00,  // 0x214: V0 = 0
+    0x12, 0x0A,  // 0x216: Jump to 0x20A
+    0x00, 0x00,  // 0x218: padding
+    0x00, 0x00,  // 0x21A: padding
+    0x00, 0x00,  // 0x21C: padding
+    0x00, 0x00,  // 0x21E: padding
+    0xA2, 0x40,  // 0x220: I = 0x240
+    0xD0, 0x15,  // 0x222: Draw sprite at (V0, V1)
+    0x82, 0x04,  // 0x224: V2 += V0
+    0x82, 0x14,  // 0x226: V2 += V1
+    0xA3, 0x00,  // 0x228: I = 0x300
+    0xF2, 0x33,  // 0x22A: BCD of V2
+    0xF4, 0x07,  // 0x22C: V4 = DT
+    0x00, 0xEE,  // 0x22E: Return
+    0x00, 0x00,  // 0x230..0x23F: padding
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xF0, 0x90, 0x90, 0x90, 0xF0  // 0x240: Sprite data
+};
+
+// Every superinstruction sequence: delay wait, register pair, draw and counted loops
+const std::vector<std::uint8_t> FUSION_PROGRAM = {
+    0x63, 0x08,  // 0x200: V3 = 8
+    0xF3, 0x15,  // 0x202: DT = V3
+    0xF4, 0x07,  // 0x204: V4 = DT
+    0x34, 0x00,  // 0x206: Skip if V4 == 0
+    0x12, 0x04,  // 0x208: Jump to 0x204
+    0x60, 0x05,  // 0x20A: V0 = 5
+    0x61, 0x03,  // 0x20C: V1 = 3
+    0xA2, 0x40,  // 0x20E: I = 0x240
+    0xD0, 0x15,  // 0x210: Draw sprite at (V0, V1)
+    0x72, 0x01,  // 0x212: V2 += 1
+    0x32, 0x04,  // 0x214: Skip if V2 == 4
+    0x12, 0x0E,  // 0x216: Jump to 0x20E
+    0x75, 0x01,  // 0x218: V5 += 1
+    0x45, 0x03,  // 0x21A: Skip if V5 != 3
+    0x12, 0x1C,  // 0x21C: Jump to self
+    0x12, 0x00,  // 0x21E: Jump to 0x200
+    0x00, 0x00,  // 0x220..0x23F: padding
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00,
+    0xF0, 0x90, 0x90, 0x90, 0xF0  // 0x240: Sprite data
+};
+
+class BackendTest : public ::testing::TestWithParam<Chip8::Backend> {};
+
+TEST_P(BackendTest, MatchesSingleStepping) {
+    for (std::uint32_t cycles : {1u, 7u, 63u, 64u, 65u, 1000u, 12345u}) {
+        Chip8 reference;
+        Chip8 emulator(GetParam());
+        loadProgram(reference, LOOP_PROGRAM);
+        loadProgram(emulator, LOOP_PROGRAM);
+
+        for (std::uint32_t i = 0; i < cycles; ++i) {
+            reference.emulateCycle();
+        }
+        const Chip8::RunResult result = emulator.runCycles(cycles);
+        EXPECT_EQ(result.cycles, cycles);
+        EXPECT_EQ(result.reason, Chip8::StopReason::CycleLimit);
+
+        SCOPED_TRACE(cycles);
+        expectSameState(reference, emulator);
+    }
+}
+
+TEST_P(BackendTest, ResumesAcrossCalls) {
+    Chip8 reference;
+    Chip8 emulator(GetParam());
+    loadProgram(reference, LOOP_PROGRAM);
+    loadProgram(emulator, LOOP_PROGRAM);
+
+    for (std::uint32_t chunk = 1; chunk < 40; ++chunk) {
+        for (std::uint32_t i = 0; i < chunk; ++i) {
+            reference.emulateCycle();
+        }
+        emulator.runCycles(chunk);
+    }
+
+    expectSameState(reference, emulator);
+}
+
+TEST_P(BackendTest, StopsOnError) {
+    Chip8 emulator(GetParam());
+    loadProgram(emulator, {
+                              0x60, 0x01,  // V0 = 1
+                              0x61, 0x02,  // V1 = 2
+                              0x00, 0xEE,  // Return with an empty stack
+                              0x62, 0x03,  // V2 = 3 (never reached)
+                          });
+
+    const Chip8::RunResult result = emulator.runCycles(100);
+    EXPECT_EQ(result.cycles, 3u);
+    EXPECT_EQ(result.reason, Chip8::StopReason::Error);
+    EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::StackUnderflow);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x204);
+    EXPECT_EQ(emulator.getRegisterAt(2), 0);
+}
+
+TEST_P(BackendTest, SelfModifyingCodeInvalidatesTranslation) {
+    Chip8 emulator(GetParam());
+    loadProgram(emulator, {
+                              0x60, 0x01,  // 0x200: V0 = 1 (rewritten to V0 += 5)
+                              0x71, 0x01,  // 0x202: V1 += 1
+                              0x30, 0x01,  // 0x204: Skip if V0 == 1
+                              0x12, 0x14,  // 0x206: Jump to 0x214
+                              0x60, 0x70,  // 0x208: V0 = 0x70
+                              0x61, 0x05,  // 0x20A: V1 = 0x05
+                              0xA2, 0x00,  // 0x20C: I = 0x200
+                              0xF1, 0x55,  // 0x20E: Store V0-V1 at 0x200
+                              0x12, 0x00,  // 0x210: Jump to 0x200
+                              0x00, 0x00,  // 0x212: padding
+                              0x12, 0x14,  // 0x214: Jump to self
+                          });
+
+    // First pass: 0x200, 0x202, 0x204 (skip), 0x208..0x210; second pass runs V0 += 5
+    emulator.runCycles(8);
+    EXPECT_EQ(emulator.getMemoryAt(0x200), 0x70);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x200);
+
+    emulator.runCycles(1);
+    EXPECT_EQ(emulator.getRegisterAt(0), 0x75);
+}
+
+TEST_P(BackendTest, SetMemoryInvalidatesTranslation) {
+    Chip8 emulator(GetParam());
+    loadProgram(emulator, {
+                              0x65, 0x11,  // V5 = 0x11
+                              0x12, 0x00,  // Jump to 0x200
+                          });
+
+    emulator.runCycles(10);
+    EXPECT_EQ(emulator.getRegisterAt(5), 0x11);
+
+    emulator.setMemory(0x201, 0x22);
+    emulator.runCycles(2);
+    EXPECT_EQ(emulator.getRegisterAt(5), 0x22);
+}
+
+TEST_P(BackendTest, RunUntilDrawStopsAfterDraw) {
+    Chip8 emulator(GetParam());
+    loadProgram(emulator, LOOP_PROGRAM);
+
+    // Clear screen is the first instruction
+    Chip8::RunResult result = emulator.runUntilDraw(1000);
+    EXPECT_EQ(result.reason, Chip8::StopReason::Draw);
+    EXPECT_EQ(result.cycles, 1u);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x202);
+
+    // Four setup instructions, call, I = 0x240, draw
+    result = emulator.runUntilDraw(1000);
+    EXPECT_EQ(result.reason, Chip8::StopReason::Draw);
+    EXPECT_EQ(result.cycles, 7u);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x224);
+    EXPECT_TRUE(emulator.getDrawFlag());
+
+    // A draw does not stop plain cycle runs
+    result = emulator.runCycles(100);
+    EXPECT_EQ(result.reason, Chip8::StopReason::CycleLimit);
+    EXPECT_EQ(result.cycles, 100u);
+}
+
+TEST_P(BackendTest, RunFrameUsesCyclesPerFrame) {
+    Chip8 emulator(GetParam());
+    loadProgram(emulator, {
+                              0x70, 0x01,  // V0 += 1
+                              0x12, 0x00,  // Jump to 0x200
+                          });
+
+    EXPECT_EQ(emulator.getCyclesPerFrame(), Chip8::DEFAULT_CYCLES_PER_FRAME);
+    emulator.setCyclesPerFrame(20);
+
+    const Chip8::RunResult result = emulator.runFrame();
+    EXPECT_EQ(result.reason, Chip8::StopReason::CycleLimit);
+    EXPECT_EQ(result.cycles, 20u);
+    EXPECT_EQ(emulator.getRegisterAt(0), 10);
+}
+
+TEST_P(BackendTest, StopsOnKeyWait) {
+    Chip8 emulator(GetParam());
+    loadProgram(emulator, {
+                              0x60, 0x01,  // V0 = 1
+                              0xF1, 0x0A,  // V1 = key (wait)
+                              0x62, 0x03,  // V2 = 3
+                              0x12, 0x06,  // Jump to self
+                          });
+
+    emulator.setDelayTimer(150);
+
+    // The run stops right after the first FX0A; 2 cycles at 600 Hz are less
+    // than a timer tick
+    Chip8::RunResult result = emulator.runCycles(100);
+    EXPECT_EQ(result.reason, Chip8::StopReason::KeyWait);
+    EXPECT_EQ(result.cycles, 2u);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x202);
+    EXPECT_EQ(emulator.getDelayTimer(), 150);
+
+    emulator.setKeyState(0x7, true);
+    result = emulator.runCycles(2);
+    EXPECT_EQ(result.reason, Chip8::StopReason::CycleLimit);
+    EXPECT_EQ(emulator.getRegisterAt(1), 0x7);
+    EXPECT_EQ(emulator.getRegisterAt(2), 3);
+}
+
+TEST_P(BackendTest, KeyWaitStopsTheSameWithAndWithoutFusion) {
+    const std::vector<std::uint8_t> program = {
+        0x60, 0x01,  // V0 = 1
+        0xF1, 0x0A,  // V1 = key (wait)
+        0x62, 0x03,  // V2 = 3
+        0x12, 0x06,  // Jump to self
+    };
+
+    for (std::uint32_t cycles : {1u, 2u, 3u, 4u, 100u, 20000u}) {
+        Chip8 fused(GetParam());
+        Chip8 unfused(GetParam());
+        unfused.setFusionEnabled(false);
+        loadProgram(fused, program);
+        loadProgram(unfused, program);
+        fused.setDelayTimer(150);
+        unfused.setDelayTimer(150);
+
+        SCOPED_TRACE(cycles);
+        // Once at the wait, and again while still waiting
+        for (int run = 0; run < 2; ++run) {
+            const Chip8::RunResult expected = unfused.runCycles(cycles);
+            const Chip8::RunResult actual = fused.runCycles(cycles);
+            EXPECT_EQ(actual.reason, expected.reason);
+            EXPECT_EQ(actual.cycles, expected.cycles);
+            expectSameState(unfused, fused);
+        }
+    }
+}
+
+TEST_P(BackendTest, RunsThroughKeyWaitsToEndOfBudget) {
+    const std::vector<std::uint8_t> program = {
+        0x60, 0x01,  // V0 = 1
+        0xF1, 0x0A,  // V1 = key (wait)
+        0x62, 0x03,  // V2 = 3
+        0x12, 0x06,  // Jump to self
+    };
+
+    for (bool fusion : {true, false}) {
+        Chip8 emulator(GetParam());
+        emulator.setFusionEnabled(fusion);
+        loadProgram(emulator, program);
+        emulator.setDelayTimer(150);
+
+        // FX0A repeats for the rest of the budget; 100 cycles at 600 Hz are 10 timer ticks
+        SCOPED_TRACE(fusion);
+        Chip8::RunResult result = emulator.runCyclesThroughKeyWaits(100);
+        EXPECT_EQ(result.reason, Chip8::StopReason::KeyWait);
+        EXPECT_EQ(result.cycles, 100u);
+        EXPECT_EQ(emulator.getProgramCounter(), 0x202);
+        EXPECT_EQ(emulator.getDelayTimer(), 140);
+
+        emulator.setKeyState(0x7, true);
+        result = emulator.runCyclesThroughKeyWaits(3);
+        EXPECT_EQ(result.reason, Chip8::StopReason::CycleLimit);
+        EXPECT_EQ(emulator.getRegisterAt(1), 0x7);
+        EXPECT_EQ(emulator.getRegisterAt(2), 3);
+    }
+
+    // With fusion the wait is skipped in O(1), however long the budget
+    Chip8 emulator(GetParam());
+    loadProgram(emulator, program);
+    const Chip8::RunResult result = emulator.runCyclesThroughKeyWaits(2000000000u);
+    EXPECT_EQ(result.reason, Chip8::StopReason::KeyWait);
+    EXPECT_EQ(result.cycles, 2000000000u);
+}
+
+TEST_P(BackendTest, SkipsIdleLoopToEndOfBudget) {
+    Chip8 emulator(GetParam());
+    loadProgram(emulator, {
+                              0x60, 0xC8,  // V0 = 200
+                              0xF0, 0x15,  // DT = V0
+                              0xF0, 0x18,  // ST = V0
+                              0x12, 0x06,  // Jump to self
+                          });
+
+    // Executing a billion jumps one by one would take seconds
+    const Chip8::RunResult result = emulator.runCycles(1000000000u);
+    EXPECT_EQ(result.reason, Chip8::StopReason::CycleLimit);
+    EXPECT_EQ(result.cycles, 1000000000u);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x206);
+    EXPECT_EQ(emulator.getDelayTimer(), 0);
+    EXPECT_EQ(emulator.getSoundTimer(), 0);
+}
+
+TEST_P(BackendTest, StopsAtBreakpointAndResumes) {
+    Chip8 emulator(GetParam());
+    loadProgram(emulator, {
+                              0x70, 0x01,  // 0x200: V0 += 1
+                              0x71, 0x01,  // 0x202: V1 += 1
+                              0x72, 0x01,  // 0x204: V2 += 1
+                              0x12, 0x00,  // 0x206: Jump to 0x200
+                          });
+    emulator.addBreakpoint(0x204);
+
+    Chip8::RunResult result = emulator.runCycles(100);
+    EXPECT_EQ(result.reason, Chip8::StopReason::Breakpoint);
+    EXPECT_EQ(result.cycles, 2u);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x204);
+
+    // Resuming executes the instruction at the breakpoint and stops on the next hit
+    result = emulator.runCycles(100);
+    EXPECT_EQ(result.reason, Chip8::StopReason::Breakpoint);
+    EXPECT_EQ(result.cycles, 4u);
+    EXPECT_EQ(emulator.getRegisterAt(0), 2);
+    EXPECT_EQ(emulator.getRegisterAt(2), 1);
+
+    emulator.removeBreakpoint(0x204);
+    result = emulator.runCycles(100);
+    EXPECT_EQ(result.reason, Chip8::StopReason::CycleLimit);
+    EXPECT_EQ(result.cycles, 100u);
+}
+
+TEST_P(BackendTest, SuperinstructionsMatchSingleStepping) {
+    std::vector<std::uint32_t> cycleCounts;
+    for (std::uint32_t cycles = 1; cycles <= 150; ++cycles) {
+        cycleCounts.push_back(cycles);
+    }
+    // Long enough to reach the jump to self at 0x21C
+    cycleCounts.insert(cycleCounts.end(), {1000u, 5000u, 20000u});
+
+    for (bool fusion : {true, false}) {
+        for (std::uint32_t cycles : cycleCounts) {
+            Chip8 reference;
+            Chip8 emulator(GetParam());
+            emulator.setFusionEnabled(fusion);
+            loadProgram(reference, FUSION_PROGRAM);
+            loadProgram(emulator, FUSION_PROGRAM);
+
+            for (std::uint32_t i = 0; i < cycles; ++i) {
+                reference.emulateCycle();
+            }
+            const Chip8::RunResult result = emulator.runCycles(cycles);
+            EXPECT_EQ(result.cycles, cycles);
+
+            SCOPED_TRACE(cycles);
+            expectSameState(reference, emulator);
+        }
+    }
+}
+
+TEST_P(BackendTest, TimerClockMatchesSingleSteppingAtAnyFrequency) {
+    // 0 leaves the delay wait polling forever, so the idle skip takes the whole budget
+    for (std::uint32_t frequency : {0u, 60u, 500u, 1234u, 2000u}) {
+        for (std::uint32_t cycles : {1u, 2u, 3u, 99u, 100u, 101u, 1000u, 20000u}) {
+            Chip8 reference;
+            Chip8 emulator(GetParam());
+            reference.setCpuFrequency(frequency);
+            emulator.setCpuFrequency(frequency);
+            loadProgram(reference, FUSION_PROGRAM);
+            loadProgram(emulator, FUSION_PROGRAM);
+
+            for (std::uint32_t i = 0; i < cycles; ++i) {
+                reference.emulateCycle();
+            }
+            const Chip8::RunResult result = emulator.runCycles(cycles);
+            EXPECT_EQ(result.cycles, cycles);
+
+            SCOPED_TRACE(testing::Message() << frequency << " Hz, " << cycles << " cycles");
+            expectSameState(reference, emulator);
+        }
+    }
+}
+
+TEST_P(BackendTest, SuperinstructionStopsOnErrorInLaterPart) {
+    Chip8 emulator(GetParam());
+    loadProgram(emulator, {
+                              0xAF, 0xFE,  // I = 0xFFE
+                              0xD0, 0x15,  // Draw 5 rows, running off the end of memory
+                          });
+
+    const Chip8::RunResult result = emulator.runCycles(100);
+    EXPECT_EQ(result.reason, Chip8::StopReason::Error);
+    EXPECT_EQ(result.cycles, 2u);
+    EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::InvalidMemoryAccess);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x202);
+}
+
+TEST_P(BackendTest, SetMemoryInvalidatesSuperinstruction) {
+    Chip8 emulator(GetParam());
+    loadProgram(emulator, {
+                              0x60, 0x01,  // 0x200: V0 = 1
+                              0x61, 0x02,  // 0x202: V1 = 2 (rewritten to V1 += 2)
+                              0x12, 0x00,  // 0x204: Jump to 0x200
+                          });
+
+    emulator.runCycles(30);
+    EXPECT_EQ(emulator.getRegisterAt(1), 2);
+
+    emulator.setMemory(0x202, 0x71);
+    emulator.runCycles(30);
+    EXPECT_EQ(emulator.getRegisterAt(1), 22);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllBackends, BackendTest,
+                         ::testing::Values(Chip8::Backend::Switch, Chip8::Backend::Threaded,
+                                           Chip8::Backend::TailCall,
+                                           Chip8::Backend::BlockTranslator));
+
+}  // namespace
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../src/batch_runner.h"
+
+namespace {
+
+// Counts passes in V0 and passes with key 0 held in V2
+const auto COUNTER_ROM =
+    std::make_shared<const std::vector<std::uint8_t>>(std::vector<std::uint8_t>{
+        0x70, 0x01,  // 0x200: V0 += 1
+        0xE1, 0xA1,  // 0x202: Skip if key V1 is not pressed
+        0x72, 0x01,  // 0x204: V2 += 1
+        0x12, 0x00,  // 0x206: Jump to 0x200
+    });
+
+BatchJob counterJob(std::uint64_t cycles, std::uint64_t pressAt) {
+    BatchJob job;
+    job.rom = COUNTER_ROM;
+    job.cycles = cycles;
+    job.input = {{pressAt, 0, true}, {pressAt + 400, 0, false}};
+    return job;
+}
+
+TEST(BatchRunnerTest, ResultsMatchSingleJobRunsInJobOrder) {
+    std::vector<BatchJob> jobs;
+    for (std::uint64_t i = 0; i < 64; ++i) {
+        jobs.push_back(counterJob(1000 + i * 37, i * 11));
+        jobs.back().profile = static_cast<QuirkProfile>(i % 4);
+        jobs.back().backend = static_cast<Chip8Base::Backend>(i % 4);
+    }
+
+    BatchRunner runner(4);
+    EXPECT_EQ(runner.getThreadCount(), 4u);
+    std::atomic<std::size_t> reported{0};
+    const std::vector<BatchResult> results =
+        runner.run(jobs, [&](std::size_t, const BatchResult&) { ++reported; });
+
+    ASSERT_EQ(results.size(), jobs.size());
+    EXPECT_EQ(reported.load(), jobs.size());
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        const BatchResult expected = runBatchJob(jobs[i]);
+        EXPECT_EQ(results[i].status, BatchStatus::Completed) << i;
+        EXPECT_EQ(results[i].cycles, jobs[i].cycles) << i;
+        EXPECT_EQ(results[i].stateHash, expected.stateHash) << i;
+    }
+    // Different budgets end in different states
+    EXPECT_NE(results[0].stateHash, results[1].stateHash);
+}
+
+TEST(BatchRunnerTest, ReportsFailures) {
+    std::vector<BatchJob> jobs(3);
+    jobs[0].rom = std::make_shared<const std::vector<std::uint8_t>>();
+    jobs[0].cycles = 10;
+    jobs[1].rom = std::make_shared<const std::vector<std::uint8_t>>(
+        std::vector<std::uint8_t>{0x00, 0xEE});  // Return with an empty stack
+    jobs[1].cycles = 10;
+    jobs[2] = counterJob(10, 0);
+
+    const std::vector<BatchResult> results = BatchRunner(2).run(jobs);
+    EXPECT_EQ(results[0].status, BatchStatus::Failed);
+    EXPECT_EQ(results[0].error.site, Chip8Base::ErrorSite::RomSize);
+    EXPECT_EQ(results[1].status, BatchStatus::Failed);
+    EXPECT_EQ(results[1].error.code, Chip8Base::ErrorCode::StackUnderflow);
+    EXPECT_EQ(results[1].cycles, 1u);
+    EXPECT_EQ(results[2].status, BatchStatus::Completed);
+}
+
+TEST(BatchRunnerTest, KeyWaitsResumeAtTheNextKeyEvent) {
+    BatchJob job;
+    job.rom = std::make_shared<const std::vector<std::uint8_t>>(std::vector<std::uint8_t>{
+        0xF3, 0x0A,  // V3 = next key
+        0x12, 0x02,  // Spin
+    });
+    job.cycles = 1000;
+    job.input = {{500, 0xB, true}};
+    for (Chip8Base::Backend backend :
+         {Chip8Base::Backend::Switch, Chip8Base::Backend::Threaded,
+          Chip8Base::Backend::TailCall, Chip8Base::Backend::BlockTranslator}) {
+        job.backend = backend;
+        const BatchResult result = runBatchJob(job);
+        EXPECT_EQ(result.status, BatchStatus::Completed);
+        EXPECT_EQ(result.cycles, 1000u);
+    }
+}
+
+TEST(BatchRunnerTest, KeyWaitWithoutFurtherEventsStalls) {
+    BatchJob job;
+    job.rom = std::make_shared<const std::vector<std::uint8_t>>(std::vector<std::uint8_t>{
+        0x70, 0x01,  // 0x200: V0 += 1
+        0x30, 0x40,  // 0x202: Skip if V0 == 64
+        0x12, 0x00,  // 0x204: Jump to 0x200
+        0xF3, 0x0A,  // 0x206: V3 = next key
+    });
+    job.cycles = 1000;
+    // Pressed and released before the wait starts, so nothing ends it
+    job.input = {{10, 0xB, true}, {20, 0xB, false}};
+
+    for (Chip8Base::Backend backend :
+         {Chip8Base::Backend::Switch, Chip8Base::Backend::Threaded,
+          Chip8Base::Backend::TailCall, Chip8Base::Backend::BlockTranslator}) {
+        job.backend = backend;
+        const BatchResult result = runBatchJob(job);
+        EXPECT_EQ(result.status, BatchStatus::Stalled);
+        // 63 passes of three instructions, the skip's pass and the wait itself
+        EXPECT_EQ(result.cycles, 63u * 3u + 2u + 1u);
+    }
+}
+
+TEST(BatchRunnerTest, CancelsQueuedAndRunningJobs) {
+    // Budgets far longer than the test, so only cancellation ends them
+    std::vector<BatchJob> jobs;
+    for (int i = 0; i < 8; ++i) {
+        jobs.push_back(counterJob(std::uint64_t{1} << 50, 0));
+    }
+    jobs.push_back(counterJob(100, 0));
+
+    // Cancels before run() starts are ignored, so keep cancelling until it returns
+    BatchRunner runner(2);
+    std::atomic<bool> finished{false};
+    std::thread canceller([&] {
+        while (!finished.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            runner.cancel(0);
+            runner.cancelAll();
+        }
+    });
+    const std::vector<BatchResult> results = runner.run(jobs);
+    finished.store(true);
+    canceller.join();
+
+    for (std::size_t i = 0; i < 8; ++i) {
+        EXPECT_EQ(results[i].status, BatchStatus::Cancelled) << i;
+    }
+    // Cancelled after it finished, or before it started
+    EXPECT_NE(results[8].status, BatchStatus::Failed);
+
+    // Cancellation doesn't carry over to the next batch
+    EXPECT_EQ(runner.run({counterJob(100, 0)})[0].status, BatchStatus::Completed);
+}
+
+}  // namespace
@@ -173,6 +173,38 @@ TEST_F(Chip8InstructionTest, ClearScreen) {
     EXPECT_EQ(emulator.getProgramCounter(), Chip8::ROM_START_ADDRESS + 2);
 }
 
+TEST_F(Chip8InstructionTest, DrawMarksDirtyRows) {
+    // init() clears the whole display
+    EXPECT_EQ(emulator.getDirtyRows(), 0xFFFFFFFFu);
+    emulator.acknowledgeDirtyRows();
+    EXPECT_EQ(emulator.getDirtyRowRanges().size, 0u);
+
+    // Digit 0 at row 30 wraps: rows 30-31 and 0-2
+    emulator.setRegisterAt(1, 30);
+    emulator.setIndexRegister(0);
+    loadInstruction(0xD015);
+    emulator.emulateCycle();
+
+    EXPECT_EQ(emulator.getDirtyRows(), 0xC0000007u);
+    const Chip8::RowRanges ranges = emulator.getDirtyRowRanges();
+    ASSERT_EQ(ranges.size, 2u);
+    EXPECT_EQ(ranges.ranges[0].first, 0);
+    EXPECT_EQ(ranges.ranges[0].count, 3);
+    EXPECT_EQ(ranges.ranges[1].first, 30);
+    EXPECT_EQ(ranges.ranges[1].count, 2);
+
+    // Acknowledging is separate from the draw flag
+    emulator.acknowledgeDirtyRows();
+    EXPECT_TRUE(emulator.getDrawFlag());
+    emulator.setPixel(4, 9, 1);
+    EXPECT_EQ(emulator.getDirtyRows(), 1u << 9);
+
+    emulator.setProgramCounter(Chip8::ROM_START_ADDRESS);
+    loadInstruction(0x00E0);
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getDirtyRows(), 0xFFFFFFFFu);
+}
+
 TEST_F(Chip8InstructionTest, Jump) {
     // Load jump instruction (0x1NNN)
     loadInstruction(0x1234);
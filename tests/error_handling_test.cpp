@@ -3,6 +3,7 @@
 
 #include <filesystem>
 #include <fstream>
+#include <type_traits>
 
 #include "../src/chip8.h"
 
@@ -119,6 +120,33 @@ TEST_F(ErrorHandlingTest, RomLoadingErrors) {
     EXPECT_THAT(emulator.getLastErrorMessage(), ::testing::HasSubstr("bytes"));
 }
 
+TEST_F(ErrorHandlingTest, RomLoadsFromMemoryAndMappedFiles) {
+    const std::vector<std::uint8_t> rom = {0x60, 0x2A, 0x12, 0x02};
+    createTestFile("mapped.ch8", rom);
+    ASSERT_TRUE(emulator.loadRom("mapped.ch8"));
+    for (std::size_t i = 0; i < rom.size(); ++i) {
+        EXPECT_EQ(emulator.getMemoryAt(static_cast<std::uint16_t>(Chip8::ROM_START_ADDRESS + i)),
+                  rom[i]);
+    }
+
+    // A bare pointer and size, as from an embedded image, loads the same way
+    const std::uint8_t embedded[] = {0x61, 0x07, 0x12, 0x02};
+    ASSERT_TRUE(emulator.loadRom(embedded, sizeof(embedded)));
+    EXPECT_EQ(emulator.getMemoryAt(Chip8::ROM_START_ADDRESS), 0x61);
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getRegisterAt(1), 0x07);
+
+    EXPECT_FALSE(emulator.loadRom(nullptr, 4));
+    EXPECT_EQ(emulator.getLastErrorRecord().site, Chip8::ErrorSite::RomSize);
+    EXPECT_FALSE(emulator.loadRom(embedded, 0));
+    EXPECT_FALSE(emulator.loadRom(embedded, Chip8::MEMORY_SIZE));
+    EXPECT_EQ(emulator.getLastErrorRecord().site, Chip8::ErrorSite::RomSize);
+
+    // Directories are not ROMs
+    EXPECT_FALSE(emulator.loadRom(std::filesystem::temp_directory_path().string()));
+    EXPECT_EQ(emulator.getLastErrorRecord().site, Chip8::ErrorSite::RomOpen);
+}
+
 TEST_F(ErrorHandlingTest, ErrorMessageQuality) {
     // Test that error messages contain useful information
     emulator.setMemory(0x1000, 0xFF);
@@ -200,4 +228,41 @@ TEST_F(ErrorHandlingTest, ErrorStateManagement) {
     // Invalid operation should set error
     emulator.setRegisterAt(20, 42);
     EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::InvalidRegisterAccess);
-}
\ No newline at end of file
+}
+TEST_F(ErrorHandlingTest, ErrorRecordCapturesFaultingInstruction) {
+    static_assert(std::is_trivially_copyable<Chip8::ErrorRecord>::value,
+                  "Error records must stay plain data");
+
+    emulator.setMemory(0x200, 0x60);  // 0x200: V0 = 0x12
+    emulator.setMemory(0x201, 0x12);
+    emulator.setMemory(0x202, 0xAF);  // 0x202: I = 0xFFE
+    emulator.setMemory(0x203, 0xFE);
+    emulator.setMemory(0x204, 0xF3);  // 0x204: Store V0-V3 past the end of memory
+    emulator.setMemory(0x205, 0x55);
+
+    EXPECT_EQ(emulator.runCycles(10).reason, Chip8::StopReason::Error);
+
+    const Chip8::ErrorRecord& error = emulator.getLastErrorRecord();
+    EXPECT_EQ(error.code, Chip8::ErrorCode::InvalidMemoryAccess);
+    EXPECT_EQ(error.site, Chip8::ErrorSite::RegisterDump);
+    EXPECT_EQ(error.programCounter, 0x204);
+    EXPECT_EQ(error.opcode, 0xF355);
+    EXPECT_EQ(error.operands[0], 0xFFEu);
+    EXPECT_EQ(emulator.getLastErrorMessage(), "Register dump out of memory bounds: 0xFFE");
+
+    // Clearing resets the whole record and the formatted message
+    emulator.setRegisterAt(0, 0);
+    EXPECT_EQ(emulator.getLastErrorRecord().site, Chip8::ErrorSite::None);
+    EXPECT_TRUE(emulator.getLastErrorMessage().empty());
+}
+
+TEST_F(ErrorHandlingTest, UnknownOpcodeMessageIsFormattedOnDemand) {
+    emulator.setMemory(0x200, 0xF1);  // 0x200: FX99 is not an instruction
+    emulator.setMemory(0x201, 0x99);
+
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::UnknownOpcode);
+    EXPECT_EQ(emulator.getLastErrorRecord().operands[0], 0xF199u);
+    EXPECT_EQ(emulator.getLastErrorMessage(), "Unknown opcode: 0xF199");
+    EXPECT_EQ(emulator.getLastErrorMessage(), "Unknown opcode: 0xF199");
+}
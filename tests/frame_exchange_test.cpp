@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <thread>
+
+#include "../src/chip8.h"
+#include "../src/frame_exchange.h"
+
+namespace {
+
+TEST(TripleBufferTest, ConsumerSeesNewestPublishedValue) {
+    TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.update());
+
+    buffer.writeBuffer() = 1;
+    buffer.publish();
+    buffer.writeBuffer() = 2;
+    buffer.publish();
+
+    // The first value was overwritten before it was read
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.readBuffer(), 2);
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(buffer.readBuffer(), 2);
+
+    buffer.writeBuffer() = 3;
+    buffer.publish();
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.readBuffer(), 3);
+}
+
+TEST(TripleBufferTest, FramesArriveWholeAndInOrder) {
+    // Every word of a frame carries its sequence number, so a torn read
+    // would show two different values
+    struct Frame {
+        std::array<std::uint64_t, 64> words;
+    };
+    constexpr std::uint64_t FRAME_COUNT = 20000;
+    TripleBuffer<Frame> buffer;
+
+    std::thread producer([&] {
+        for (std::uint64_t sequence = 1; sequence <= FRAME_COUNT; ++sequence) {
+            buffer.writeBuffer().words.fill(sequence);
+            buffer.publish();
+        }
+    });
+
+    std::uint64_t last = 0;
+    while (last < FRAME_COUNT) {
+        if (!buffer.update()) {
+            std::this_thread::yield();
+            continue;
+        }
+        const Frame& frame = buffer.readBuffer();
+        const std::uint64_t sequence = frame.words[0];
+        for (std::uint64_t word : frame.words) {
+            ASSERT_EQ(word, sequence);
+        }
+        ASSERT_GT(sequence, last);
+        last = sequence;
+    }
+    producer.join();
+}
+
+TEST(AtomicKeypadTest, AppliesWholePadToEmulator) {
+    AtomicKeypad keypad;
+    keypad.setKeyState(0x3, true);
+    keypad.setKeyState(0xF, true);
+    keypad.setKeyState(0x3, false);
+    keypad.setKeyState(0x10, true);  // Ignored
+    EXPECT_EQ(keypad.getKeys(), 0x8000);
+    EXPECT_TRUE(keypad.isKeyPressed(0xF));
+    EXPECT_FALSE(keypad.isKeyPressed(0x10));
+
+    NullLogger logger;
+    Chip8 emulator(Chip8::Backend::Switch, logger);
+    emulator.setKeyState(0x3, true);
+    keypad.applyTo(emulator);
+    EXPECT_FALSE(emulator.isKeyPressed(0x3));
+    EXPECT_TRUE(emulator.isKeyPressed(0xF));
+    EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::None);
+}
+
+}  // namespace
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../src/chip8.h"
+#include "../src/frame_exchange.h"
+#include "../src/input_recording.h"
+
+namespace {
+
+// Waits for a key, draws its digit offset by a random number, sleeps on the
+// delay timer and moves down a row while key 0 is held
+const std::vector<std::uint8_t> KEY_ROM = {
+    0xF0, 0x0A,  // 0x200: V0 = next key (waits)
+    0xC1, 0xFF,  // 0x202: V1 = random
+    0x80, 0x14,  // 0x204: V0 += V1
+    0xF0, 0x15,  // 0x206: Delay timer = V0
+    0x64, 0x0F,  // 0x208: V4 = 0x0F
+    0x84, 0x02,  // 0x20A: V4 &= V0
+    0xF4, 0x29,  // 0x20C: I = digit sprite for V4
+    0xD2, 0x35,  // 0x20E: Draw 5 rows at (V2, V3)
+    0x72, 0x03,  // 0x210: V2 += 3
+    0xF1, 0x07,  // 0x212: V1 = delay timer
+    0x31, 0x00,  // 0x214: Skip if V1 == 0
+    0x12, 0x12,  // 0x216: Jump to 0x212
+    0xE5, 0x9E,  // 0x218: Skip if key V5 (key 0) is pressed
+    0x12, 0x00,  // 0x21A: Jump to 0x200
+    0x73, 0x01,  // 0x21C: V3 += 1
+    0x12, 0x00,  // 0x21E: Jump to 0x200
+};
+
+// Plays KEY_ROM the way the frontend does: a changing key state applied at
+// the start of each refresh, then a run of an uneven number of cycles
+template <typename Emulator>
+InputRecording playSession(Emulator& emulator, std::uint32_t refreshes) {
+    InputRecorder recorder(QuirkProfile::Default, 900, 0x5EED);
+    prepareForRecording(emulator, recorder.getRecording());
+    AtomicKeypad keypad;
+    for (std::uint32_t refresh = 0; refresh < refreshes; ++refresh) {
+        keypad.setKeyState(static_cast<std::uint8_t>(refresh / 3 % 16), refresh % 5 != 0);
+        keypad.setKeyState(0, refresh % 4 == 0);
+        keypad.applyTo(emulator, recorder);
+        recorder.advance(emulator.runCycles(7 + refresh * 13 % 29).cycles);
+    }
+    return recorder.getRecording();
+}
+
+TEST(InputRecordingTest, ReplaysASessionBitForBit) {
+    NullLogger logger;
+    Chip8 played(Chip8::Backend::Switch, logger);
+    ASSERT_TRUE(played.loadRom(KEY_ROM));
+    const InputRecording recording = playSession(played, 2000);
+    ASSERT_GT(recording.events.size(), 100u);
+    const std::vector<std::uint8_t> expected = played.serializeState();
+
+    // Replays in any slicing, on any backend, match the session
+    const Chip8::Backend backends[] = {Chip8::Backend::Switch, Chip8::Backend::Threaded,
+                                       Chip8::Backend::TailCall,
+                                       Chip8::Backend::BlockTranslator};
+    for (Chip8::Backend backend : backends) {
+        for (std::uint64_t slice : {std::uint64_t{1}, std::uint64_t{97}, recording.cycles}) {
+            Chip8 replayed(backend, logger);
+            ASSERT_TRUE(replayed.loadRom(KEY_ROM));
+            InputReplayer replayer(recording);
+            replayer.start(replayed);
+            while (!replayer.isFinished()) {
+                ASSERT_EQ(replayer.run(replayed, slice), Chip8::StopReason::CycleLimit);
+            }
+            EXPECT_EQ(replayer.getCycle(), recording.cycles);
+            EXPECT_EQ(replayed.serializeState(), expected)
+                << static_cast<int>(backend) << " " << slice;
+        }
+    }
+
+    // Another seed draws other numbers
+    InputRecording reseeded = recording;
+    reseeded.seed += 1;
+    Chip8 other(Chip8::Backend::Switch, logger);
+    ASSERT_TRUE(other.loadRom(KEY_ROM));
+    InputReplayer replayer(reseeded);
+    replayer.start(other);
+    replayer.runToEnd(other);
+    EXPECT_NE(other.serializeState(), expected);
+}
+
+// Counts the runs a replay makes
+class CountingChip8 : public Chip8 {
+public:
+    RunResult runCycles(std::uint32_t count) {
+        ++calls;
+        return Chip8::runCycles(count);
+    }
+
+    RunResult runCyclesThroughKeyWaits(std::uint32_t count) {
+        ++calls;
+        return Chip8::runCyclesThroughKeyWaits(count);
+    }
+
+    int calls = 0;
+};
+
+TEST(InputRecordingTest, SkipsKeyWaitsUntilTheNextEvent) {
+    CountingChip8 emulator;
+    ASSERT_TRUE(emulator.loadRom(KEY_ROM));
+    const std::vector<KeyEvent> events = {{100000, 3, true}, {100010, 3, false}};
+    std::size_t next = 0;
+    std::uint64_t cycle = 0;
+
+    // Waits at 0x200 until the key press, then stalls at the next wait
+    EXPECT_EQ(runWithInput(emulator, events, next, cycle, 100000),
+              Chip8::StopReason::CycleLimit);
+    EXPECT_EQ(emulator.calls, 1);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x200);
+    EXPECT_EQ(runWithInput(emulator, events, next, cycle, 200000), Chip8::StopReason::KeyWait);
+    EXPECT_LT(emulator.calls, 10);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x200);
+    EXPECT_LT(cycle, 200000u);
+}
+
+TEST(InputRecordingTest, RecorderKeepsOnlyChanges) {
+    InputRecorder recorder(QuirkProfile::XoChip, 1000, 42);
+    recorder.setKeyState(3, false);  // Already released
+    recorder.setKeyState(3, true);
+    recorder.setKeyState(3, true);
+    recorder.advance(10);
+    recorder.setKeyState(16, true);  // Not a key
+    recorder.setKeyState(3, false);
+    recorder.setKeyState(15, true);
+    recorder.advance(5);
+
+    const InputRecording& recording = recorder.getRecording();
+    EXPECT_EQ(recording.profile, QuirkProfile::XoChip);
+    EXPECT_EQ(recording.cpuFrequency, 1000u);
+    EXPECT_EQ(recording.seed, 42u);
+    EXPECT_EQ(recording.cycles, 15u);
+    ASSERT_EQ(recording.events.size(), 3u);
+    EXPECT_EQ(recording.events[0].cycle, 0u);
+    EXPECT_TRUE(recording.events[0].pressed);
+    EXPECT_EQ(recording.events[1].cycle, 10u);
+    EXPECT_EQ(recording.events[1].key, 3);
+    EXPECT_FALSE(recording.events[1].pressed);
+    EXPECT_EQ(recording.events[2].key, 15);
+}
+
+TEST(InputRecordingTest, SerializesAndRejectsBadData) {
+    InputRecording recording;
+    recording.profile = QuirkProfile::SuperChip;
+    recording.cpuFrequency = 1234;
+    recording.seed = 0x0123456789ABCDEF;
+    recording.cycles = 5000;
+    recording.events = {{0, 1, true}, {40, 1, false}, {40, 15, true}, {5000, 15, false}};
+
+    const std::vector<std::uint8_t> data = serializeRecording(recording);
+    InputRecording read;
+    ASSERT_TRUE(deserializeRecording(data, read));
+    EXPECT_EQ(read.profile, recording.profile);
+    EXPECT_EQ(read.cpuFrequency, recording.cpuFrequency);
+    EXPECT_EQ(read.seed, recording.seed);
+    EXPECT_EQ(read.cycles, recording.cycles);
+    ASSERT_EQ(read.events.size(), recording.events.size());
+    for (std::size_t i = 0; i < read.events.size(); ++i) {
+        EXPECT_EQ(read.events[i].cycle, recording.events[i].cycle);
+        EXPECT_EQ(read.events[i].key, recording.events[i].key);
+        EXPECT_EQ(read.events[i].pressed, recording.events[i].pressed);
+    }
+
+    const std::string path = ::testing::TempDir() + "input_recording_test.c8in";
+    ASSERT_TRUE(saveRecording(path, recording));
+    InputRecording loaded;
+    ASSERT_TRUE(loadRecording(path, loaded));
+    EXPECT_EQ(serializeRecording(loaded), data);
+    std::remove(path.c_str());
+    EXPECT_FALSE(loadRecording(path, loaded));
+
+    // Bad data fails and leaves the recording alone
+    const auto rejects = [&](std::vector<std::uint8_t> bad) {
+        InputRecording untouched;
+        untouched.seed = 7;
+        return !deserializeRecording(bad, untouched) && untouched.seed == 7 &&
+               untouched.events.empty();
+    };
+    const std::size_t header = data.size() - recording.events.size() * 10;
+    std::vector<std::uint8_t> bad = data;
+    bad.pop_back();
+    EXPECT_TRUE(rejects(bad));
+    bad = data;
+    bad.push_back(0);
+    EXPECT_TRUE(rejects(bad));
+    bad = data;
+    bad[0] ^= 1;  // Tag
+    EXPECT_TRUE(rejects(bad));
+    bad = data;
+    bad[6] = 4;  // Profile
+    EXPECT_TRUE(rejects(bad));
+    bad = data;
+    bad[header + 10 + 8] = 16;  // Key
+    EXPECT_TRUE(rejects(bad));
+    bad = data;
+    bad[header + 10 + 9] = 2;  // Flag
+    EXPECT_TRUE(rejects(bad));
+    bad = data;
+    bad[header + 10] = 41;  // Out of order
+    EXPECT_TRUE(rejects(bad));
+    bad = data;
+    bad[header + 30] = 0x89;  // Past the end of the session (5001)
+    EXPECT_TRUE(rejects(bad));
+    bad = data;
+    bad[header - 1] = 0xFF;  // Event count
+    EXPECT_TRUE(rejects(bad));
+}
+
+}  // namespace
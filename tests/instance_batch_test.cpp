@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../src/chip8.h"
+#include "../src/instance_batch.h"
+
+namespace {
+
+// Branches on every key in turn, and runs arithmetic, BCD, loads, draws,
+// timers and clears on the pressed path
+const std::vector<std::uint8_t> MIXED_ROM = {
+    0x60, 0x07,  // 0x200: V0 = 7
+    0x61, 0x03,  // 0x202: V1 = 3
+    0x8D, 0x00,  // 0x204: VD = V0
+    0xEE, 0x9E,  // 0x206: Skip if key VE is pressed
+    0x12, 0x0E,  // 0x208: Jump to 0x20E
+    0x22, 0x40,  // 0x20A: Call 0x240
+    0x7C, 0x01,  // 0x20C: VC += 1
+    0x7E, 0x01,  // 0x20E: VE += 1
+    0x4E, 0x10,  // 0x210: Skip if VE != 16
+    0x6E, 0x00,  // 0x212: VE = 0
+    0x3C, 0x20,  // 0x214: Skip if VC == 32
+    0x12, 0x06,  // 0x216: Jump to 0x206
+    0x00, 0xE0,  // 0x218: Clear the screen
+    0x6C, 0x00,  // 0x21A: VC = 0
+    0x12, 0x06,  // 0x21C: Jump to 0x206
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x80, 0x14,  // 0x240: V0 += V1
+    0x82, 0x05,  // 0x242: V2 -= V0
+    0x83, 0x26,  // 0x244: V3 = V2 >> 1 (or V3 >> 1, by quirk)
+    0x84, 0x0E,  // 0x246: V4 = V0 << 1 (or V4 << 1, by quirk)
+    0x85, 0x27,  // 0x248: V5 = V2 - V5
+    0x86, 0x13,  // 0x24A: V6 ^= V1
+    0xA3, 0x00,  // 0x24C: I = 0x300
+    0xF0, 0x33,  // 0x24E: BCD of V0 at I
+    0xF2, 0x65,  // 0x250: Load V0-V2 from I
+    0xD5, 0x63,  // 0x252: Draw 3 rows at (V5, V6)
+    0xF5, 0x15,  // 0x254: Delay timer = V5
+    0xF8, 0x07,  // 0x256: V8 = delay timer
+    0x00, 0xEE,  // 0x258: Return
+};
+
+// MIXED_ROM with a DXY0 before the return on the profiles where it draws no
+// rows; the batch doesn't run SUPER-CHIP's 16x16 sprites
+template <typename Quirks>
+std::vector<std::uint8_t> mixedRom() {
+    std::vector<std::uint8_t> rom = MIXED_ROM;
+    if constexpr (!Quirks::SUPER_CHIP) {
+        rom.insert(rom.end() - 2, {0xD5, 0x60});
+    }
+    return rom;
+}
+
+template <typename Quirks>
+void expectLanesMatchEmulator() {
+    constexpr std::size_t LANES = 8;
+    const std::vector<std::uint8_t> rom = mixedRom<Quirks>();
+    BasicInstanceBatch<Quirks> batch(LANES);
+    ASSERT_TRUE(batch.loadRom(rom));
+
+    NullLogger logger;
+    std::vector<BasicChip8<CheckedPolicy, Quirks>> emulators;
+    emulators.reserve(LANES);
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+        emulators.emplace_back(Chip8Base::Backend::Switch, logger);
+        ASSERT_TRUE(emulators[lane].loadRom(rom));
+    }
+
+    std::size_t mostGroups = 0;
+    for (int step = 0; step < 2000; ++step) {
+        // Different keys per lane, changing partway through
+        if (step % 500 == 0) {
+            for (std::size_t lane = 0; lane < LANES; ++lane) {
+                const auto keys = static_cast<std::uint16_t>(lane * (0x1357 + step));
+                batch.setKeys(lane, keys);
+                for (std::uint8_t key = 0; key < 16; ++key) {
+                    emulators[lane].setKeyState(key, (keys >> key & 1) != 0);
+                }
+            }
+        }
+
+        mostGroups = std::max(mostGroups, batch.step());
+        for (std::size_t lane = 0; lane < LANES; ++lane) {
+            auto& emulator = emulators[lane];
+            emulator.emulateCycle();
+            ASSERT_TRUE(batch.isRunning(lane)) << lane;
+            ASSERT_EQ(batch.getProgramCounter(lane), emulator.getProgramCounter()) << lane;
+            ASSERT_EQ(batch.getIndexRegister(lane), emulator.getIndexRegister()) << lane;
+            ASSERT_EQ(batch.getStackPointer(lane), emulator.getStackPointer()) << lane;
+            ASSERT_EQ(batch.getDelayTimer(lane), emulator.getDelayTimer()) << lane;
+            for (std::uint8_t reg = 0; reg < Chip8Base::REGISTER_COUNT; ++reg) {
+                ASSERT_EQ(batch.getRegisterAt(lane, reg), emulator.getRegisterAt(reg)) << lane;
+            }
+            const Chip8Base::DisplayPlane& plane = emulator.getDisplayPlane(0);
+            for (std::uint16_t y = 0; y < Chip8Base::DISPLAY_HEIGHT; ++y) {
+                ASSERT_EQ(batch.getDisplay(lane)[y], plane[y * Chip8Base::DISPLAY_ROW_WORDS])
+                    << lane;
+            }
+            ASSERT_EQ(batch.getMemory(lane, 0x300), emulator.getMemoryAt(0x300)) << lane;
+        }
+    }
+
+    // Lane 0 never presses a key, so the lanes took different paths
+    EXPECT_EQ(batch.getRegisterAt(0, 0xC), 0);
+    EXPECT_GT(mostGroups, 1u);
+}
+
+TEST(InstanceBatchTest, LanesMatchTheEmulator) {
+    expectLanesMatchEmulator<DefaultQuirks>();
+    expectLanesMatchEmulator<Chip8Quirks>();
+    expectLanesMatchEmulator<SuperChipQuirks>();
+}
+
+TEST(InstanceBatchTest, DivergentLanesRunAsSeparateGroups) {
+    InstanceBatch batch(4);
+    ASSERT_TRUE(batch.loadRom({
+        0x70, 0x01,  // 0x200: V0 += 1
+        0xE1, 0xA1,  // 0x202: Skip if key V1 is not pressed
+        0x72, 0x01,  // 0x204: V2 += 1
+        0x12, 0x00,  // 0x206: Jump to 0x200
+    }));
+    batch.setKeyState(1, 0, true);
+    batch.setKeyState(3, 0, true);
+
+    EXPECT_EQ(batch.step(), 1u);
+    EXPECT_EQ(batch.step(), 1u);
+    // The lanes holding key 0 fall one instruction behind for good
+    EXPECT_EQ(batch.step(), 2u);
+    EXPECT_EQ(batch.step(), 2u);
+    batch.run(96);
+    EXPECT_EQ(batch.getRegisterAt(0, 0), 34);
+    EXPECT_EQ(batch.getRegisterAt(0, 2), 0);
+    EXPECT_EQ(batch.getRegisterAt(1, 0), 25);
+    EXPECT_EQ(batch.getRegisterAt(1, 2), 25);
+}
+
+TEST(InstanceBatchTest, LanesWithRewrittenCodeSplitAtTheSamePc) {
+    InstanceBatch batch(2);
+    ASSERT_TRUE(batch.loadRom({
+        0x60, 0x63,  // 0x200: V0 = 0x63
+        0xF1, 0x0A,  // 0x202: V1 = next key
+        0xA2, 0x08,  // 0x204: I = 0x208
+        0xF1, 0x55,  // 0x206: Store V0-V1 at 0x208, making it 63 V1
+        0x00, 0x00,  // 0x208: Rewritten
+        0x12, 0x0A,  // 0x20A: Spin
+    }));
+    batch.setKeyState(0, 0x7, true);
+    batch.setKeyState(1, 0x9, true);
+
+    batch.run(4);
+    EXPECT_EQ(batch.getProgramCounter(0), 0x208);
+    EXPECT_EQ(batch.getProgramCounter(1), 0x208);
+    EXPECT_EQ(batch.step(), 2u);
+    EXPECT_EQ(batch.getRegisterAt(0, 3), 0x07);
+    EXPECT_EQ(batch.getRegisterAt(1, 3), 0x09);
+}
+
+TEST(InstanceBatchTest, FailingLanesStopAlone) {
+    InstanceBatch batch(3);
+    ASSERT_TRUE(batch.loadRom({
+        0xE0, 0xA1,  // 0x200: Skip if key 0 is not pressed
+        0x00, 0xEE,  // 0x202: Return with an empty stack
+        0x12, 0x04,  // 0x204: Spin
+    }));
+    batch.setKeyState(1, 0, true);
+    batch.run(10);
+
+    EXPECT_TRUE(batch.isRunning(0));
+    EXPECT_FALSE(batch.isRunning(1));
+    EXPECT_EQ(batch.getLastError(1), Chip8Base::ErrorCode::StackUnderflow);
+    EXPECT_EQ(batch.getProgramCounter(1), 0x202);
+    EXPECT_EQ(batch.getProgramCounter(2), 0x204);
+    EXPECT_EQ(batch.getLastError(2), Chip8Base::ErrorCode::None);
+
+    batch.resetLane(1);
+    batch.setKeyState(1, 0, false);
+    EXPECT_TRUE(batch.isRunning(1));
+    batch.run(10);
+    EXPECT_EQ(batch.getProgramCounter(1), 0x204);
+
+    // Outside the classic instruction set
+    ASSERT_TRUE(batch.loadRom({0x00, 0xFF}));
+    batch.step();
+    EXPECT_EQ(batch.getLastError(0), Chip8Base::ErrorCode::UnknownOpcode);
+    EXPECT_FALSE(batch.loadRom(std::vector<std::uint8_t>(Chip8Base::MEMORY_SIZE)));
+}
+
+TEST(InstanceBatchTest, ResetLanesRestartTheirTimerClock) {
+    const std::vector<std::uint8_t> rom = {
+        0x60, 0x0A,  // 0x200: V0 = 10
+        0xF0, 0x15,  // 0x202: Delay timer = V0
+        0x12, 0x04,  // 0x204: Spin
+    };
+    InstanceBatch batch(2);
+    ASSERT_TRUE(batch.loadRom(rom));
+    batch.setCpuFrequency(600);
+    NullLogger logger;
+    std::vector<Chip8> emulators;
+    for (std::size_t lane = 0; lane < 2; ++lane) {
+        emulators.emplace_back(Chip8Base::Backend::Switch, logger);
+        ASSERT_TRUE(emulators[lane].loadRom(rom));
+        emulators[lane].setCpuFrequency(600);
+    }
+
+    // Lane 1 restarts 7 cycles into the 10-cycle timer period, as a reset
+    // emulator does
+    batch.run(7);
+    for (int cycle = 0; cycle < 7; ++cycle) {
+        emulators[0].emulateCycle();
+    }
+    batch.resetLane(1);
+    for (int step = 0; step < 60; ++step) {
+        batch.step();
+        for (std::size_t lane = 0; lane < 2; ++lane) {
+            emulators[lane].emulateCycle();
+            ASSERT_EQ(batch.getDelayTimer(lane), emulators[lane].getDelayTimer())
+                << lane << " " << step;
+        }
+    }
+}
+
+TEST(InstanceBatchTest, RandomNumbersFollowTheLaneSeed) {
+    const std::vector<std::uint8_t> rom = {
+        0xC0, 0xFF,  // V0 = random
+        0xC1, 0xFF,  // V1 = random
+        0xC2, 0x0F,  // V2 = random & 0x0F
+        0x12, 0x06,  // Spin
+    };
+    InstanceBatch first(3);
+    InstanceBatch second(3);
+    ASSERT_TRUE(first.loadRom(rom));
+    ASSERT_TRUE(second.loadRom(rom));
+    first.setSeed(0, 42);
+    first.setSeed(1, 42);
+    first.setSeed(2, 0);
+    second.setSeed(0, 42);
+    first.run(3);
+    second.run(3);
+
+    for (std::uint8_t reg = 0; reg < 3; ++reg) {
+        EXPECT_EQ(first.getRegisterAt(0, reg), first.getRegisterAt(1, reg));
+        EXPECT_EQ(first.getRegisterAt(0, reg), second.getRegisterAt(0, reg));
+    }
+    EXPECT_LE(first.getRegisterAt(2, 2), 0x0F);
+    EXPECT_FALSE(first.getRegisterAt(0, 0) == first.getRegisterAt(2, 0) &&
+                 first.getRegisterAt(0, 1) == first.getRegisterAt(2, 1));
+}
+
+}  // namespace
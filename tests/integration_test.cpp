@@ -103,15 +103,45 @@ TEST_F(IntegrationTest, TimerDecrement) {
     emulator.setDelayTimer(10);
     // Note: Can't directly set sound timer in public interface
 
-    // Run several cycles and verify timer decrements
+    // At the default 600 Hz the timers tick once every 10 instructions
+    const std::uint32_t cyclesPerTick = Chip8::DEFAULT_CPU_FREQUENCY / Chip8::TIMER_FREQUENCY;
     for (int i = 9; i >= 0; --i) {
         EXPECT_EQ(emulator.getDelayTimer(), i + 1);
-        emulator.emulateCycle();  // This should decrement timers
+        for (std::uint32_t cycle = 0; cycle < cyclesPerTick; ++cycle) {
+            emulator.emulateCycle();
+        }
     }
 
     EXPECT_EQ(emulator.getDelayTimer(), 0);
 }
 
+TEST_F(IntegrationTest, TimersTickAtSixtyHertzOfEmulatedTime) {
+    emulator.setCpuFrequency(700);
+    emulator.setDelayTimer(100);
+
+    // One emulated second is 700 instructions and 60 ticks at any rate
+    for (int i = 0; i < 700; ++i) {
+        emulator.emulateCycle();
+    }
+    EXPECT_EQ(emulator.getDelayTimer(), 40);
+
+    emulator.setCpuFrequency(30);
+    EXPECT_EQ(emulator.getCpuFrequency(), Chip8::TIMER_FREQUENCY);
+}
+
+TEST_F(IntegrationTest, UnthrottledCpuLeavesTimersToCaller) {
+    emulator.setCpuFrequency(0);
+    emulator.setDelayTimer(10);
+
+    for (int i = 0; i < 1000; ++i) {
+        emulator.emulateCycle();
+    }
+    EXPECT_EQ(emulator.getDelayTimer(), 10);
+
+    emulator.tickTimers();
+    EXPECT_EQ(emulator.getDelayTimer(), 9);
+}
+
 TEST_F(IntegrationTest, KeyboardInputIntegration) {
     // Create ROM that waits for key press
     std::vector<std::uint8_t> keyTestRom = {
@@ -311,4 +341,62 @@ TEST_F(IntegrationTest, LongRunningExecution) {
     // Emulator should still be in good state
     EXPECT_EQ(emulator.getProgramCounter(), Chip8::ROM_START_ADDRESS);
     EXPECT_EQ(emulator.getStackPointer(), 0);
-}
\ No newline at end of file
+}
+TEST_F(IntegrationTest, SelfModifyingCodeViaRegisterDump) {
+    // Execute an instruction once so it is cached, then overwrite it with FX55
+    std::vector<std::uint8_t> smcRom = {
+        0x60, 0x01,  // 0x200: V0 = 1 (overwritten below)
+        0x60, 0x70,  // 0x202: V0 = 0x70
+        0x61, 0x05,  // 0x204: V1 = 0x05
+        0xA2, 0x00,  // 0x206: I = 0x200
+        0xF1, 0x55,  // 0x208: Store V0-V1 at 0x200 -> 0x7005 (V0 += 5)
+        0x62, 0x2A,  // 0x20A: V2 = 42
+        0x12, 0x00   // 0x20C: Jump back to 0x200
+    };
+
+    createRom("smc_fx55.ch8", smcRom);
+    ASSERT_TRUE(emulator.loadRom("smc_fx55.ch8"));
+
+    runCycles(7);
+    EXPECT_EQ(emulator.getMemoryAt(0x200), 0x70);
+    EXPECT_EQ(emulator.getMemoryAt(0x201), 0x05);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x200);
+
+    // The rewritten instruction must run, not the cached "V0 = 1"
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getRegisterAt(0), 0x75);
+}
+
+TEST_F(IntegrationTest, SelfModifyingCodeViaBcdStore) {
+    // FX33 writes into the low byte of an already executed instruction
+    std::vector<std::uint8_t> smcRom = {
+        0x63, 0x00,  // 0x200: V3 = 0 (low byte overwritten below)
+        0x64, 0x09,  // 0x202: V4 = 9
+        0xA1, 0xFF,  // 0x204: I = 0x1FF
+        0xF4, 0x33,  // 0x206: BCD of V4 -> 0x1FF, 0x200, 0x201 = 0, 0, 9
+        0x12, 0x00   // 0x208: Jump back to 0x200
+    };
+
+    createRom("smc_fx33.ch8", smcRom);
+    ASSERT_TRUE(emulator.loadRom("smc_fx33.ch8"));
+
+    runCycles(5);
+    EXPECT_EQ(emulator.getMemoryAt(0x200), 0x00);
+    EXPECT_EQ(emulator.getMemoryAt(0x201), 0x09);
+
+    // 0x0009 is not a valid instruction, so the stale "V3 = 0" must not run
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::UnknownOpcode);
+}
+
+TEST_F(IntegrationTest, SetMemoryInvalidatesExecutedInstruction) {
+    emulator.setMemory(0x200, 0x65);  // V5 = 0x11
+    emulator.setMemory(0x201, 0x11);
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getRegisterAt(5), 0x11);
+
+    emulator.setMemory(0x201, 0x22);  // Patch only the operand byte
+    emulator.setProgramCounter(0x200);
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getRegisterAt(5), 0x22);
+}
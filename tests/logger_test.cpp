@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../src/chip8.h"
+#include "../src/logger.h"
+
+namespace {
+
+class CapturingLogger : public Logger {
+  public:
+    using Logger::Logger;
+
+    void write(LogLevel level, std::string_view message) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        messages_.emplace_back(level, std::string(message));
+    }
+
+    void flush() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++flushes_;
+    }
+
+    std::vector<std::pair<LogLevel, std::string>> messages() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_;
+    }
+
+    int flushes() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return flushes_;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::vector<std::pair<LogLevel, std::string>> messages_;
+    int flushes_ = 0;
+};
+
+// Holds the drain thread inside write() until released
+class BlockingLogger : public Logger {
+  public:
+    void write(LogLevel, std::string_view) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++received_;
+        blocked_.notify_all();
+        release_.wait(lock, [this] { return released_; });
+    }
+
+    void waitUntilBlocked() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        blocked_.wait(lock, [this] { return received_ > 0; });
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        released_ = true;
+        release_.notify_all();
+    }
+
+    int received() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return received_;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable blocked_;
+    std::condition_variable release_;
+    bool released_ = false;
+    int received_ = 0;
+};
+
+TEST(LoggerTest, EmulatorMessagesRespectLevel) {
+    CapturingLogger logger(LogLevel::Info);
+    Chip8 emulator(Chip8::Backend::Switch, logger);
+
+    auto messages = logger.messages();
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_EQ(messages[0].first, LogLevel::Info);
+    EXPECT_EQ(messages[0].second, "CHIP-8 emulator initialized");
+
+    logger.setLevel(LogLevel::Warning);
+    emulator.init();
+    EXPECT_EQ(logger.messages().size(), 1u);
+}
+
+TEST(LoggerTest, SetLoggerRedirectsMessages) {
+    CapturingLogger first;
+    CapturingLogger second;
+    Chip8 emulator(Chip8::Backend::Switch, first);
+
+    emulator.setLogger(second);
+    emulator.init();
+    EXPECT_EQ(&emulator.getLogger(), &second);
+    EXPECT_EQ(first.messages().size(), 1u);
+    EXPECT_EQ(second.messages().size(), 1u);
+}
+
+TEST(LoggerTest, NullLoggerIsNeverEnabled) {
+    NullLogger logger;
+    logger.setLevel(LogLevel::Debug);
+    logger.setLevel(LogLevel::Off);
+    for (LogLevel level : {LogLevel::Debug, LogLevel::Info, LogLevel::Warning, LogLevel::Error}) {
+        EXPECT_FALSE(logger.isEnabled(level));
+    }
+}
+
+TEST(AsyncLoggerTest, DeliversMessagesInOrderOnFlush) {
+    CapturingLogger sink(LogLevel::Debug);
+    AsyncLogger logger(sink, 64, LogLevel::Debug);
+
+    for (int i = 0; i < 500; ++i) {
+        logger.write(i % 2 == 0 ? LogLevel::Info : LogLevel::Error, std::to_string(i));
+    }
+    logger.flush();
+
+    const auto messages = sink.messages();
+    const std::size_t delivered = messages.size() + logger.getDroppedCount();
+    ASSERT_EQ(delivered, 500u);
+    int previous = -1;
+    for (const auto& [level, text] : messages) {
+        const int value = std::stoi(text);
+        EXPECT_GT(value, previous);
+        EXPECT_EQ(level, value % 2 == 0 ? LogLevel::Info : LogLevel::Error);
+        previous = value;
+    }
+}
+
+TEST(AsyncLoggerTest, AcceptsConcurrentWriters) {
+    CapturingLogger sink;
+    std::uint64_t dropped = 0;
+    {
+        AsyncLogger logger(sink, 1 << 14);
+        std::vector<std::thread> writers;
+        for (int writer = 0; writer < 4; ++writer) {
+            writers.emplace_back([&logger, writer] {
+                for (int i = 0; i < 1000; ++i) {
+                    logger.write(LogLevel::Info,
+                                 std::to_string(writer) + ":" + std::to_string(i));
+                }
+            });
+        }
+        for (std::thread& thread : writers) {
+            thread.join();
+        }
+        dropped = logger.getDroppedCount();
+    }
+
+    // Each writer's messages stay in order; the destructor drains the rest
+    EXPECT_EQ(dropped, 0u);
+    const auto messages = sink.messages();
+    ASSERT_EQ(messages.size(), 4000u);
+    std::vector<int> next(4, 0);
+    for (const auto& message : messages) {
+        const std::size_t colon = message.second.find(':');
+        const int writer = std::stoi(message.second.substr(0, colon));
+        EXPECT_EQ(std::stoi(message.second.substr(colon + 1)), next[writer]++);
+    }
+}
+
+TEST(AsyncLoggerTest, DropsMessagesWhenFull) {
+    BlockingLogger sink;
+    AsyncLogger logger(sink, 4);
+
+    logger.write(LogLevel::Info, "first");
+    sink.waitUntilBlocked();
+    for (int i = 0; i < 9; ++i) {
+        logger.write(LogLevel::Info, "queued");
+    }
+    EXPECT_EQ(logger.getDroppedCount(), 5u);
+
+    sink.release();
+    logger.flush();
+    EXPECT_EQ(sink.received(), 5);
+}
+
+TEST(AsyncLoggerTest, IdleDrainThreadSleepsWithoutFlushing) {
+    CapturingLogger sink;
+    AsyncLogger logger(sink);
+
+    for (int round = 0; round < 3; ++round) {
+        // Written without flush(), so only the drain thread's wake-up delivers it
+        logger.write(LogLevel::Info, "message");
+        for (int wait = 0; wait < 1000 && sink.messages().size() <= std::size_t(round); ++wait) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_EQ(sink.messages().size(), std::size_t(round) + 1);
+
+        // Once the message is out the thread flushes at most once, then stays asleep
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const int flushes = sink.flushes();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_EQ(sink.flushes(), flushes);
+        EXPECT_LE(flushes, round + 1);
+    }
+}
+
+TEST(AsyncLoggerTest, TruncatesLongMessages) {
+    CapturingLogger sink;
+    AsyncLogger logger(sink);
+
+    logger.write(LogLevel::Warning, std::string(AsyncLogger::MAX_MESSAGE_LENGTH + 50, 'x'));
+    logger.flush();
+
+    const auto messages = sink.messages();
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_EQ(messages[0].second, std::string(AsyncLogger::MAX_MESSAGE_LENGTH, 'x'));
+}
+
+}  // namespace
@@ -478,7 +478,7 @@ TEST(FX15, setDelayTimer) {
 
     chip8.emulateCycle();
 
-    EXPECT_EQ(chip8.getDelayTimer(), 1);
+    EXPECT_EQ(chip8.getDelayTimer(), 2);
     EXPECT_EQ(chip8.getProgramCounter(), 0x202);
 }
 TEST(FX18, setSoundTimer) {
@@ -491,7 +491,7 @@ TEST(FX18, setSoundTimer) {
 
     chip8.emulateCycle();
 
-    EXPECT_EQ(chip8.getSoundTimer(), 1);
+    EXPECT_EQ(chip8.getSoundTimer(), 2);
     EXPECT_EQ(chip8.getProgramCounter(), 0x202);
 }
 
@@ -1,10 +1,19 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "../src/batch_runner.h"
 #include "../src/chip8.h"
+#include "../src/input_recording.h"
+#include "../src/instance_batch.h"
+#include "../src/rewind_buffer.h"
 
 // Removed namespace usage - Chip8 is not in a namespace
 
@@ -325,4 +334,323 @@ TEST_F(PerformanceTest, WorstCaseInstructionPerformance) {
 
     // Even complex draws should be reasonably fast
     EXPECT_GT(drawsPerSecond, 1000.0);
-}
\ No newline at end of file
+}
+TEST_F(PerformanceTest, BackendThroughput) {
+    std::vector<std::uint8_t> testRom = {
+        0x60, 0x20,  // V0 = 32
+        0x61, 0x10,  // V1 = 16
+        0x80, 0x14,  // V0 += V1
+        0xA2, 0x30,  // I = 0x230
+        0xD0, 0x15,  // Draw sprite
+        0x12, 0x00   // Jump to start
+    };
+    createRom("backend_perf.ch8", testRom);
+
+    const std::uint32_t numCycles = 1000000;
+
+    const std::vector<std::pair<Chip8::Backend, const char*>> backends = {
+        {Chip8::Backend::Switch, "Switch"},
+        {Chip8::Backend::Threaded, "Threaded"},
+        {Chip8::Backend::TailCall, "TailCall"},
+        {Chip8::Backend::BlockTranslator, "BlockTranslator"}};
+
+    for (const auto& [backend, name] : backends) {
+        Chip8 chip8(backend);
+        ASSERT_TRUE(chip8.loadRom("backend_perf.ch8"));
+
+        std::uint32_t executed = 0;
+        auto duration =
+            measureExecutionTime([&]() { executed = chip8.runCycles(numCycles).cycles; });
+        ASSERT_EQ(executed, numCycles);
+
+        double cyclesPerSecond =
+            static_cast<double>(numCycles) / (static_cast<double>(duration.count()) / 1e9);
+        std::cout << name << ": " << cyclesPerSecond << " cycles/second" << std::endl;
+
+        EXPECT_GT(cyclesPerSecond, 100000.0);
+    }
+}
+
+TEST_F(PerformanceTest, DecodeCacheHitVersusMiss) {
+    // ALU-only loop, so decoding is a large share of each cycle
+    std::vector<std::uint8_t> testRom = {
+        0x70, 0x01,  // V0 += 1
+        0x81, 0x04,  // V1 += V0
+        0x82, 0x15,  // V2 -= V1
+        0x83, 0x22,  // V3 &= V2
+        0x84, 0x33,  // V4 ^= V3
+        0x3F, 0x00,  // Skip if VF == 0
+        0x65, 0x01,  // V5 = 1
+        0x12, 0x00   // Jump to start
+    };
+    createRom("decode_cache_perf.ch8", testRom);
+    ASSERT_TRUE(emulator.loadRom("decode_cache_perf.ch8"));
+
+    const int numCycles = 1000000;
+
+    // Both runs make one setMemory() call per cycle. Rewriting the byte at the
+    // program counter drops its cached decode, so the second run decodes every
+    // instruction again.
+    auto hitTime = measureExecutionTime([&]() {
+        for (int i = 0; i < numCycles; ++i) {
+            emulator.setMemory(0x300, 0);
+            emulator.emulateCycle();
+        }
+    });
+    auto missTime = measureExecutionTime([&]() {
+        for (int i = 0; i < numCycles; ++i) {
+            const std::uint16_t pc = emulator.getProgramCounter();
+            emulator.setMemory(pc, emulator.getMemoryAt(pc));
+            emulator.emulateCycle();
+        }
+    });
+
+    std::cout << "Cached decode: " << hitTime.count() / numCycles << " ns/cycle" << std::endl;
+    std::cout << "Decode every cycle: " << missTime.count() / numCycles << " ns/cycle"
+              << std::endl;
+
+    EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::None);
+    EXPECT_GT(static_cast<double>(numCycles) / (static_cast<double>(hitTime.count()) / 1e9),
+              100000.0);
+}
+
+TEST_F(PerformanceTest, SaveAndLoadStateSpeed) {
+    std::vector<std::uint8_t> testRom = {
+        0x70, 0x01,  // V0 += 1
+        0xA2, 0x20,  // I = 0x220
+        0xF0, 0x33,  // BCD of V0 at I
+        0xD0, 0x15,  // Draw sprite
+        0x12, 0x00   // Jump to start
+    };
+    Chip8 chip8(Chip8::Backend::Threaded);
+    ASSERT_TRUE(chip8.loadRom(testRom));
+    chip8.runCycles(1000);
+
+    // Alternate between two snapshots, so every load changes memory
+    const int numSnapshots = 100000;
+    Chip8::MachineState first;
+    Chip8::MachineState second;
+    chip8.saveState(first);
+    chip8.runCycles(10);
+    chip8.saveState(second);
+
+    auto duration = measureExecutionTime([&]() {
+        for (int i = 0; i < numSnapshots; ++i) {
+            chip8.loadState(i % 2 == 0 ? first : second);
+            chip8.runCycles(1);
+            chip8.saveState(i % 2 == 0 ? second : first);
+        }
+    });
+
+    double snapshotsPerSecond =
+        static_cast<double>(numSnapshots) / (static_cast<double>(duration.count()) / 1e9);
+    std::cout << "Save and load: " << snapshotsPerSecond << " round trips/second" << std::endl;
+
+    EXPECT_GT(snapshotsPerSecond, 10000.0);
+}
+
+TEST_F(PerformanceTest, RomLoadSpeed) {
+    // A full-size ROM, loaded from a file and from memory
+    std::vector<std::uint8_t> testRom(Chip8::MEMORY_SIZE - Chip8::ROM_START_ADDRESS);
+    for (std::size_t i = 0; i < testRom.size(); ++i) {
+        testRom[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    createRom("load_speed.ch8", testRom);
+    NullLogger logger;  // Loads log at Info
+    Chip8 chip8(Chip8::Backend::Threaded, logger);
+
+    const int numLoads = 20000;
+    auto fileDuration = measureExecutionTime([&]() {
+        for (int i = 0; i < numLoads; ++i) {
+            chip8.loadRom("load_speed.ch8");
+        }
+    });
+    ASSERT_TRUE(chip8.loadRom("load_speed.ch8"));
+    auto memoryDuration = measureExecutionTime([&]() {
+        for (int i = 0; i < numLoads; ++i) {
+            chip8.loadRom(testRom.data(), testRom.size());
+        }
+    });
+
+    double fileLoadsPerSecond =
+        static_cast<double>(numLoads) / (static_cast<double>(fileDuration.count()) / 1e9);
+    double memoryLoadsPerSecond =
+        static_cast<double>(numLoads) / (static_cast<double>(memoryDuration.count()) / 1e9);
+    std::cout << "ROM loads: " << fileLoadsPerSecond << "/second from a mapped file, "
+              << memoryLoadsPerSecond << "/second from memory, " << testRom.size()
+              << " bytes each" << std::endl;
+
+    EXPECT_GT(fileLoadsPerSecond, 1000.0);
+    EXPECT_GT(memoryLoadsPerSecond, 10000.0);
+}
+
+TEST_F(PerformanceTest, RewindCaptureAndStepBackSpeed) {
+    std::vector<std::uint8_t> testRom = {
+        0x70, 0x01,  // V0 += 1
+        0xA2, 0x20,  // I = 0x220
+        0xF0, 0x33,  // BCD of V0 at I
+        0xD0, 0x15,  // Draw sprite
+        0x12, 0x00   // Jump to start
+    };
+    Chip8 chip8(Chip8::Backend::Threaded);
+    ASSERT_TRUE(chip8.loadRom(testRom));
+    RewindBuffer rewind;
+
+    // An hour of frames would be 216000; this is enough to time both ways
+    const int numFrames = 20000;
+    auto captureDuration = measureExecutionTime([&]() {
+        for (int i = 0; i < numFrames; ++i) {
+            chip8.runCycles(10);
+            rewind.capture(chip8);
+        }
+    });
+    const std::size_t held = rewind.size();
+    const std::size_t bytesPerFrame = rewind.getStoredBytes() / held;
+    auto rewindDuration = measureExecutionTime([&]() {
+        while (rewind.rewind(chip8)) {
+        }
+    });
+
+    double capturesPerSecond =
+        static_cast<double>(numFrames) / (static_cast<double>(captureDuration.count()) / 1e9);
+    double rewindsPerSecond =
+        static_cast<double>(held - 1) / (static_cast<double>(rewindDuration.count()) / 1e9);
+    std::cout << "Rewind: " << capturesPerSecond << " frames/second captured with 10 cycles each, "
+              << rewindsPerSecond << " frames/second stepped back, "
+              << bytesPerFrame << " bytes/frame" << std::endl;
+
+    // Far above the 60 a second the frontend needs
+    EXPECT_GT(capturesPerSecond, 6000.0);
+    EXPECT_GT(rewindsPerSecond, 6000.0);
+}
+
+TEST_F(PerformanceTest, InputReplaySpeed) {
+    std::vector<std::uint8_t> testRom = {
+        0xE0, 0xA1,  // Skip if key V0 is not pressed
+        0x71, 0x01,  // V1 += 1
+        0xC2, 0x3F,  // V2 = random & 0x3F
+        0xA2, 0x20,  // I = 0x220
+        0xD2, 0x15,  // Draw sprite at (V2, V1)
+        0x12, 0x00   // Jump to start
+    };
+
+    // Ten minutes of play at the default clock, changing keys every half second
+    InputRecording recording;
+    recording.cycles = std::uint64_t{Chip8::DEFAULT_CPU_FREQUENCY} * 600;
+    for (std::uint64_t cycle = 0; cycle < recording.cycles; cycle += 300) {
+        recording.events.push_back({cycle, 0, cycle / 300 % 2 == 0});
+    }
+    Chip8 chip8(Chip8::Backend::Threaded);
+    ASSERT_TRUE(chip8.loadRom(testRom));
+    InputReplayer replayer(recording);
+    replayer.start(chip8);
+
+    auto duration = measureExecutionTime([&]() { replayer.runToEnd(chip8); });
+    ASSERT_TRUE(replayer.isFinished());
+
+    const double seconds = static_cast<double>(duration.count()) / 1e9;
+    const double speedUp = 600.0 / seconds;
+    std::cout << "Input replay: " << recording.events.size() << " key changes over "
+              << recording.cycles << " cycles in " << seconds * 1000.0 << " ms, " << speedUp
+              << "x real time" << std::endl;
+
+    EXPECT_GT(speedUp, 1000.0);
+}
+
+TEST(BatchScalingTest, ThroughputFromOneToAllCores) {
+    // Identical work at each thread count: the same jobs, the same results
+    const auto rom = std::make_shared<const std::vector<std::uint8_t>>(std::vector<std::uint8_t>{
+        0x60, 0x20,  // V0 = 32
+        0x61, 0x10,  // V1 = 16
+        0x80, 0x14,  // V0 += V1
+        0xA2, 0x30,  // I = 0x230
+        0xD0, 0x15,  // Draw sprite
+        0x12, 0x00   // Jump to start
+    });
+    const std::size_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<BatchJob> jobs(maxThreads * 16);
+    for (BatchJob& job : jobs) {
+        job.rom = rom;
+        job.cycles = 200000;
+    }
+
+    std::vector<BatchResult> reference;
+    double singleThreaded = 0.0;
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        BatchRunner runner(threads);
+        std::vector<BatchResult> results;
+        const auto start = std::chrono::steady_clock::now();
+        results = runner.run(jobs);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        const double jobsPerSecond = static_cast<double>(jobs.size()) / elapsed.count();
+        if (threads == 1) {
+            singleThreaded = jobsPerSecond;
+            reference = results;
+        }
+        std::cout << threads << " threads: " << jobsPerSecond << " jobs/second, "
+                  << jobsPerSecond / singleThreaded << "x" << std::endl;
+
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+            ASSERT_EQ(results[i].status, BatchStatus::Completed);
+            ASSERT_EQ(results[i].stateHash, reference[i].stateHash);
+        }
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+}
+
+TEST(InstanceBatchThroughput, LockstepAgainstSeparateEmulators) {
+    // A third of the lanes hold key 0 and take the other branch
+    std::vector<std::uint8_t> rom = {
+        0x60, 0x20,  // V0 = 32
+        0x61, 0x10,  // V1 = 16
+        0x80, 0x14,  // V0 += V1
+        0x82, 0x05,  // V2 -= V0
+        0x72, 0x03,  // V2 += 3
+        0xE3, 0xA1,  // Skip if key V3 is not pressed
+        0x74, 0x01,  // V4 += 1
+        0xA2, 0x40,  // I = 0x240
+        0xD0, 0x15,  // Draw sprite
+        0x12, 0x00   // Jump to start
+    };
+    rom.resize(0x45, 0xAA);
+    constexpr std::size_t LANES = 256;
+    constexpr std::uint32_t FRAMES = 500;
+    constexpr std::uint32_t CYCLES_PER_FRAME = 10;
+
+    InstanceBatch batch(LANES);
+    ASSERT_TRUE(batch.loadRom(rom));
+    NullLogger logger;
+    std::vector<std::unique_ptr<Chip8>> emulators;
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+        batch.setKeyState(lane, 0, lane % 3 == 0);
+        emulators.push_back(std::make_unique<Chip8>(Chip8::Backend::Threaded, logger));
+        ASSERT_TRUE(emulators.back()->loadRom(rom));
+        emulators.back()->setKeyState(0, lane % 3 == 0);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    batch.run(FRAMES * CYCLES_PER_FRAME);
+    const std::chrono::duration<double> batched = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (std::uint32_t frame = 0; frame < FRAMES; ++frame) {
+        for (const auto& emulator : emulators) {
+            emulator->runCycles(CYCLES_PER_FRAME);
+        }
+    }
+    const std::chrono::duration<double> separate = std::chrono::steady_clock::now() - start;
+
+    const double instructions = static_cast<double>(LANES) * FRAMES * CYCLES_PER_FRAME;
+    std::cout << "Instance batch: " << instructions / batched.count()
+              << " instructions/second, separate emulators: " << instructions / separate.count()
+              << ", " << separate.count() / batched.count() << "x" << std::endl;
+
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+        for (std::uint8_t reg = 0; reg < Chip8Base::REGISTER_COUNT; ++reg) {
+            ASSERT_EQ(batch.getRegisterAt(lane, reg), emulators[lane]->getRegisterAt(reg));
+        }
+    }
+}
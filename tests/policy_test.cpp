@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../src/chip8.h"
+#include "test_helpers.h"
+
+namespace {
+
+class PolicyTest : public ::testing::TestWithParam<const char*> {};
+
+TEST_P(PolicyTest, TrustedCoreMatchesCheckedCoreOnRoms) {
+    const std::string path = std::string(CHIP8_ROM_DIR) + "/" + GetParam() + ".ch8";
+
+    Chip8 checked;
+    TrustedChip8 trusted;
+    ASSERT_TRUE(checked.loadRom(path));
+    ASSERT_TRUE(trusted.loadRom(path));
+
+    for (std::uint32_t chunk = 0; chunk < 40; ++chunk) {
+        const bool pressed = chunk % 4 == 0;
+        checked.setKeyState(chunk % Chip8::KEYBOARD_SIZE, pressed);
+        trusted.setKeyState(chunk % Chip8::KEYBOARD_SIZE, pressed);
+
+        checked.setRandomSeed(chunk);
+        trusted.setRandomSeed(chunk);
+        const Chip8::RunResult expected = checked.runCycles(500);
+        const Chip8::RunResult actual = trusted.runCycles(500);
+
+        SCOPED_TRACE(chunk);
+        EXPECT_EQ(expected.reason, actual.reason);
+        EXPECT_EQ(expected.cycles, actual.cycles);
+        expectSameState(checked, trusted);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(BundledRoms, PolicyTest,
+                         ::testing::Values("airplane", "connect4", "maze"));
+
+TEST(TrustedCoreTest, WrapsComputedJump) {
+    const std::vector<std::uint8_t> program = {
+        0x60, 0x10,  // 0x200: V0 = 0x10
+        0xBF, 0xF8,  // 0x202: Jump to 0xFF8 + V0
+    };
+
+    Chip8 checked;
+    TrustedChip8 trusted;
+    loadProgram(checked, program);
+    loadProgram(trusted, program);
+
+    EXPECT_EQ(checked.runCycles(2).reason, Chip8::StopReason::Error);
+    EXPECT_EQ(checked.getLastError(), Chip8::ErrorCode::InvalidMemoryAccess);
+
+    EXPECT_EQ(trusted.runCycles(2).reason, Chip8::StopReason::CycleLimit);
+    EXPECT_EQ(trusted.getLastError(), Chip8::ErrorCode::None);
+    EXPECT_EQ(trusted.getProgramCounter(), 0x008);
+}
+
+TEST(TrustedCoreTest, WrapsMemoryAccessAtEndOfMemory) {
+    TrustedChip8 trusted;
+    loadProgram(trusted, {
+                             0x60, 0xAA,  // 0x200: V0 = 0xAA
+                             0x61, 0xBB,  // 0x202: V1 = 0xBB
+                             0x62, 0xCC,  // 0x204: V2 = 0xCC
+                             0xAF, 0xFE,  // 0x206: I = 0xFFE
+                             0xF2, 0x55,  // 0x208: Store V0-V2 at 0xFFE, 0xFFF, 0x000
+                             0xF2, 0x33,  // 0x20A: BCD of V2 at 0xFFE, 0xFFF, 0x000
+                             0xAF, 0xFF,  // 0x20C: I = 0xFFF
+                             0xF1, 0x65,  // 0x20E: Load V0-V1 from 0xFFF, 0x000
+                         });
+
+    EXPECT_EQ(trusted.runCycles(8).reason, Chip8::StopReason::CycleLimit);
+    EXPECT_EQ(trusted.getMemoryAt(0xFFE), 2);
+    EXPECT_EQ(trusted.getMemoryAt(0xFFF), 0);
+    EXPECT_EQ(trusted.getMemoryAt(0x000), 4);
+    EXPECT_EQ(trusted.getRegisterAt(0), 0);
+    EXPECT_EQ(trusted.getRegisterAt(1), 4);
+}
+
+TEST(TrustedCoreTest, WrappedWriteInvalidatesCodeAtStartOfMemory) {
+    TrustedChip8 trusted;
+    trusted.setMemory(0x000, 0x12);  // 0x000: Jump to 0x204
+    trusted.setMemory(0x001, 0x04);
+    loadProgram(trusted, {
+                             0x10, 0x00,  // 0x200: Jump to 0x000, caching its decode
+                             0x00, 0x00,  // 0x202: Unused
+                             0x62, 0x13,  // 0x204: V2 = 0x13
+                             0x63, 0x10,  // 0x206: V3 = 0x10
+                             0xAF, 0xFE,  // 0x208: I = 0xFFE
+                             0xF3, 0x55,  // 0x20A: V2-V3 land at 0x000 as "Jump to 0x310"
+                             0x10, 0x00,  // 0x20C: Jump to 0x000 again
+                         });
+    trusted.setMemory(0x310, 0x13);  // 0x310: Jump to self
+    trusted.setMemory(0x311, 0x10);
+
+    for (int i = 0; i < 8; ++i) {
+        trusted.emulateCycle();
+    }
+    EXPECT_EQ(trusted.getLastError(), Chip8::ErrorCode::None);
+    EXPECT_EQ(trusted.getProgramCounter(), 0x310);
+}
+
+}  // namespace
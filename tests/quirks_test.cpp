@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "../src/chip8.h"
+#include "../src/chip8_factory.h"
+#include "test_helpers.h"
+
+namespace {
+
+template <typename Quirks>
+using QuirkedChip8 = BasicChip8<CheckedPolicy, Quirks>;
+
+TEST(QuirksTest, ShiftSource) {
+    const std::vector<std::uint8_t> program = {
+        0x61, 0x05,  // V1 = 0x05
+        0x62, 0x0C,  // V2 = 0x0C
+        0x81, 0x26,  // V1 = V1 >> 1, or V2 >> 1 with the quirk
+    };
+
+    Chip8 modern;
+    QuirkedChip8<Chip8Quirks> original;
+    loadProgram(modern, program);
+    loadProgram(original, program);
+    modern.runCycles(3);
+    original.runCycles(3);
+
+    EXPECT_EQ(modern.getRegisterAt(1), 0x02);
+    EXPECT_EQ(modern.getRegisterAt(0xF), 1);
+    EXPECT_EQ(original.getRegisterAt(1), 0x06);
+    EXPECT_EQ(original.getRegisterAt(0xF), 0);
+}
+
+TEST(QuirksTest, LoadStoreAdvancesIndex) {
+    const std::vector<std::uint8_t> program = {
+        0xA3, 0x00,  // I = 0x300
+        0xF2, 0x55,  // Store V0-V2
+        0xF1, 0x65,  // Load V0-V1
+    };
+
+    QuirkedChip8<SuperChipQuirks> superChip;
+    QuirkedChip8<XoChipQuirks> xoChip;
+    loadProgram(superChip, program);
+    loadProgram(xoChip, program);
+    superChip.runCycles(3);
+    xoChip.runCycles(3);
+
+    EXPECT_EQ(superChip.getIndexRegister(), 0x300);
+    EXPECT_EQ(xoChip.getIndexRegister(), 0x305);
+}
+
+TEST(QuirksTest, JumpOffsetRegister) {
+    const std::vector<std::uint8_t> program = {
+        0x60, 0x04,  // V0 = 4
+        0x62, 0x10,  // V2 = 0x10
+        0xB2, 0x30,  // Jump to 0x230 + V0, or 0x230 + V2 with the quirk
+    };
+
+    Chip8 modern;
+    QuirkedChip8<SuperChipQuirks> superChip;
+    loadProgram(modern, program);
+    loadProgram(superChip, program);
+    modern.runCycles(3);
+    superChip.runCycles(3);
+
+    EXPECT_EQ(modern.getProgramCounter(), 0x234);
+    EXPECT_EQ(superChip.getProgramCounter(), 0x240);
+}
+
+TEST(QuirksTest, DrawClipsAtEdges) {
+    const std::vector<std::uint8_t> program = {
+        0x60, 0x7E,  // V0 = 126, which wraps to x = 62
+        0x61, 0x1E,  // V1 = 30
+        0xA0, 0x00,  // I = font digit 0 (F0 90 90 90 F0)
+        0xD0, 0x15,  // Draw 8x5 at (62, 30)
+    };
+
+    Chip8 wrapping;
+    QuirkedChip8<Chip8Quirks> clipping;
+    loadProgram(wrapping, program);
+    loadProgram(clipping, program);
+    wrapping.runCycles(4);
+    clipping.runCycles(4);
+
+    EXPECT_EQ(wrapping.getPixel(62, 30), 1);
+    EXPECT_EQ(wrapping.getPixel(1, 30), 1);  // Wrapped horizontally
+    EXPECT_EQ(wrapping.getPixel(62, 2), 1);  // Wrapped vertically
+    EXPECT_EQ(clipping.getPixel(62, 30), 1);
+    EXPECT_EQ(clipping.getPixel(63, 31), 0);
+    EXPECT_EQ(clipping.getPixel(62, 31), 1);
+    EXPECT_EQ(clipping.getPixel(1, 30), 0);
+    EXPECT_EQ(clipping.getPixel(62, 2), 0);
+    EXPECT_EQ(clipping.getPixel(62, 0), 0);
+}
+
+TEST(QuirksTest, LogicResetsFlag) {
+    const std::vector<std::uint8_t> program = {
+        0x6F, 0x01,  // VF = 1
+        0x80, 0x11,  // V0 |= V1
+    };
+
+    Chip8 modern;
+    QuirkedChip8<Chip8Quirks> original;
+    loadProgram(modern, program);
+    loadProgram(original, program);
+    modern.runCycles(2);
+    original.runCycles(2);
+
+    EXPECT_EQ(modern.getRegisterAt(0xF), 1);
+    EXPECT_EQ(original.getRegisterAt(0xF), 0);
+}
+
+// Every quirk-dependent instruction in a loop, so batch runs, superinstructions
+// and translated blocks all have to apply the profile the same way
+const std::vector<std::uint8_t> QUIRK_PROGRAM = {
+    0x60, 0x3D,  // 0x200: V0 = 61
+    0x61, 0x1C,  // 0x202: V1 = 28
+    0xA0, 0x0A,  // 0x204: I = font digit 2
+    0xD0, 0x15,  // 0x206: Draw at the bottom right corner
+    0x82, 0x06,  // 0x208: Shift right
+    0x83, 0x2E,  // 0x20A: Shift left
+    0x84, 0x31,  // 0x20C: V4 |= V3
+    0x85, 0x42,  // 0x20E: V5 &= V4
+    0x86, 0x53,  // 0x210: V6 ^= V5
+    0xA3, 0x00,  // 0x212: I = 0x300
+    0xF3, 0x55,  // 0x214: Store V0-V3
+    0xF2, 0x65,  // 0x216: Load V0-V2
+    0x72, 0x07,  // 0x218: V2 += 7
+    0x60, 0x00,  // 0x21A: V0 = 0
+    0xB2, 0x20,  // 0x21C: Jump to 0x220 + V0 (or V2)
+    0x00, 0x00,  // 0x21E: Padding
+    0x70, 0x03,  // 0x220: V0 += 3
+    0x12, 0x00,  // 0x222: Jump to 0x200
+};
+
+template <typename Quirks>
+class QuirkBackendTest : public ::testing::Test {};
+
+using Profiles = ::testing::Types<DefaultQuirks, Chip8Quirks, SuperChipQuirks, XoChipQuirks>;
+TYPED_TEST_SUITE(QuirkBackendTest, Profiles);
+
+TYPED_TEST(QuirkBackendTest, BackendsMatchSingleStepping) {
+    for (Chip8::Backend backend : {Chip8::Backend::Switch, Chip8::Backend::Threaded,
+                                   Chip8::Backend::TailCall, Chip8::Backend::BlockTranslator}) {
+        for (std::uint32_t cycles : {5u, 17u, 100u, 1000u}) {
+            QuirkedChip8<TypeParam> reference;
+            QuirkedChip8<TypeParam> emulator(backend);
+            loadProgram(reference, QUIRK_PROGRAM);
+            loadProgram(emulator, QUIRK_PROGRAM);
+
+            for (std::uint32_t i = 0; i < cycles; ++i) {
+                reference.emulateCycle();
+            }
+            emulator.runCycles(cycles);
+
+            SCOPED_TRACE(testing::Message() << "backend " << static_cast<int>(backend) << ", "
+                                            << cycles << " cycles");
+            expectSameState(reference, emulator);
+        }
+    }
+}
+
+TEST(QuirkFactoryTest, MakesRequestedProfile) {
+    const auto superChip = makeChip8(QuirkProfile::SuperChip);
+    EXPECT_TRUE(std::holds_alternative<QuirkedChip8<SuperChipQuirks>>(*superChip));
+
+    const auto trusted = makeChip8<TrustedPolicy>(QuirkProfile::XoChip,
+                                                  Chip8::Backend::BlockTranslator);
+    using TrustedXoChip = BasicChip8<TrustedPolicy, XoChipQuirks>;
+    ASSERT_TRUE(std::holds_alternative<TrustedXoChip>(*trusted));
+    EXPECT_EQ(std::get<TrustedXoChip>(*trusted).getBackend(), Chip8::Backend::BlockTranslator);
+
+    // Visiting runs the profile's own instantiation
+    const auto emulator = makeChip8(QuirkProfile::Chip8);
+    std::visit(
+        [](auto& chip8) {
+            loadProgram(chip8, {0xA3, 0x00, 0xF0, 0x55});
+            chip8.runCycles(2);
+        },
+        *emulator);
+    EXPECT_EQ(std::get<QuirkedChip8<Chip8Quirks>>(*emulator).getIndexRegister(), 0x301);
+}
+
+TEST(QuirkFactoryTest, DetectsProfileFromRom) {
+    EXPECT_EQ(detectQuirkProfile(std::vector<std::uint8_t>{0x60, 0x01, 0x12, 0x00}),
+              QuirkProfile::Default);
+    EXPECT_EQ(detectQuirkProfile(std::vector<std::uint8_t>{0x60, 0x01, 0x00, 0xFF}),
+              QuirkProfile::SuperChip);
+    EXPECT_EQ(detectQuirkProfile(std::vector<std::uint8_t>{0x00, 0xFF, 0xF0, 0x00, 0x12, 0x34}),
+              QuirkProfile::XoChip);
+    EXPECT_EQ(detectQuirkProfile(std::vector<std::uint8_t>(4000, 0x00)), QuirkProfile::XoChip);
+
+    for (const char* rom : {"airplane", "connect4", "maze"}) {
+        EXPECT_EQ(detectQuirkProfile(std::string(CHIP8_ROM_DIR) + "/" + rom + ".ch8"),
+                  QuirkProfile::Default)
+            << rom;
+    }
+    EXPECT_EQ(detectQuirkProfile(std::string("missing/GAME.SC8")), QuirkProfile::SuperChip);
+    EXPECT_EQ(detectQuirkProfile(std::string("missing.xo8")), QuirkProfile::XoChip);
+    EXPECT_EQ(detectQuirkProfile(std::string("missing.ch8")), QuirkProfile::Default);
+}
+
+TEST(QuirkFactoryTest, ParsesProfileNames) {
+    for (QuirkProfile profile : {QuirkProfile::Default, QuirkProfile::Chip8,
+                                 QuirkProfile::SuperChip, QuirkProfile::XoChip}) {
+        QuirkProfile parsed = QuirkProfile::Default;
+        EXPECT_TRUE(parseQuirkProfile(getQuirkProfileName(profile), parsed));
+        EXPECT_EQ(parsed, profile);
+    }
+    QuirkProfile unchanged = QuirkProfile::Chip8;
+    EXPECT_FALSE(parseQuirkProfile("vip", unchanged));
+    EXPECT_EQ(unchanged, QuirkProfile::Chip8);
+}
+
+}  // namespace
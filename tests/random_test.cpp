@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "../src/chip8.h"
+#include "../src/random.h"
+
+namespace {
+
+// Fills V0-V3 with random bytes, then spins
+const std::vector<std::uint8_t> RANDOM_ROM = {
+    0xC0, 0xFF,  // 0x200: V0 = random
+    0xC1, 0xFF,  // 0x202: V1 = random
+    0xC2, 0xFF,  // 0x204: V2 = random
+    0xC3, 0x0F,  // 0x206: V3 = random & 0x0F
+    0x12, 0x00,  // 0x208: Jump to 0x200
+};
+
+template <typename Emulator>
+std::vector<std::uint8_t> draw(Emulator& emulator, std::uint32_t passes) {
+    std::vector<std::uint8_t> values;
+    for (std::uint32_t pass = 0; pass < passes; ++pass) {
+        emulator.runCycles(5);
+        for (std::uint8_t reg = 0; reg < 4; ++reg) {
+            values.push_back(emulator.getRegisterAt(reg));
+        }
+    }
+    return values;
+}
+
+TEST(RandomGeneratorTest, MatchesReferenceOutputs) {
+    // The xoshiro128++ reference implementation from the state {1, 2, 3, 4}
+    Xoshiro128PlusPlus xoshiro{{1, 2, 3, 4}};
+    EXPECT_EQ(xoshiro(), 0x00000281u);
+    EXPECT_EQ(xoshiro(), 0x00180387u);
+    EXPECT_EQ(xoshiro(), 0xC0183387u);
+    EXPECT_EQ(xoshiro(), 0xD1AE3B02u);
+
+    // pcg32-demo's first numbers, after pcg32_srandom(42, 54)
+    Pcg32 pcg{{0x185706B82C2E03F8, (54 << 1) | 1}};
+    EXPECT_EQ(pcg(), 0xA15C02B7u);
+    EXPECT_EQ(pcg(), 0x7B47F409u);
+    EXPECT_EQ(pcg(), 0xBA1D3330u);
+    EXPECT_EQ(pcg(), 0x83D2F293u);
+
+    // Seeding sets the whole state, and nearby seeds give unrelated states
+    Xoshiro128PlusPlus first{};
+    Xoshiro128PlusPlus second{};
+    first.seed(1);
+    second.seed(2);
+    EXPECT_NE(first.state, second.state);
+    EXPECT_NE(first.state, (std::array<std::uint32_t, 4>{}));
+    Pcg32 seeded{};
+    seeded.seed(0);
+    EXPECT_EQ(seeded.state[1] & 1, 1u);
+}
+
+TEST(RandomGeneratorTest, EachEmulatorOwnsItsGenerator) {
+    NullLogger logger;
+    Chip8 first(Chip8::Backend::Switch, logger);
+    Chip8 second(Chip8::Backend::Threaded, logger);
+    Chip8 other(Chip8::Backend::Switch, logger);
+    for (Chip8* emulator : {&first, &second, &other}) {
+        ASSERT_TRUE(emulator->loadRom(RANDOM_ROM));
+    }
+    first.setRandomSeed(7);
+    second.setRandomSeed(7);
+    other.setRandomSeed(8);
+
+    // Interleaved runs don't disturb each other's sequences
+    std::vector<std::uint8_t> firstValues;
+    std::vector<std::uint8_t> secondValues;
+    for (int round = 0; round < 20; ++round) {
+        const std::vector<std::uint8_t> a = draw(first, 3);
+        draw(other, 1);
+        const std::vector<std::uint8_t> b = draw(second, 3);
+        firstValues.insert(firstValues.end(), a.begin(), a.end());
+        secondValues.insert(secondValues.end(), b.begin(), b.end());
+    }
+    EXPECT_EQ(firstValues, secondValues);
+    for (std::size_t i = 3; i < firstValues.size(); i += 4) {
+        EXPECT_LE(firstValues[i], 0x0F);  // CXNN masks with NN
+    }
+
+    other.setRandomSeed(7);
+    ASSERT_TRUE(other.loadRom(RANDOM_ROM));  // Keeps the generator
+    EXPECT_EQ(draw(other, 60), firstValues);
+
+    // Unseeded emulators start from different seeds
+    Chip8 unseeded(Chip8::Backend::Switch, logger);
+    Chip8 alsoUnseeded(Chip8::Backend::Switch, logger);
+    ASSERT_TRUE(unseeded.loadRom(RANDOM_ROM));
+    ASSERT_TRUE(alsoUnseeded.loadRom(RANDOM_ROM));
+    EXPECT_NE(draw(unseeded, 8), draw(alsoUnseeded, 8));
+}
+
+TEST(RandomGeneratorTest, SnapshotsReplayTheSameNumbers) {
+    NullLogger logger;
+    Chip8 emulator(Chip8::Backend::BlockTranslator, logger);
+    ASSERT_TRUE(emulator.loadRom(RANDOM_ROM));
+    draw(emulator, 10);
+
+    Chip8::MachineState snapshot;
+    emulator.saveState(snapshot);
+    const std::vector<std::uint8_t> data = emulator.serializeState();
+    const std::vector<std::uint8_t> expected = draw(emulator, 10);
+
+    emulator.loadState(snapshot);
+    EXPECT_EQ(draw(emulator, 10), expected);
+
+    Chip8 restored(Chip8::Backend::Switch, logger);
+    ASSERT_TRUE(restored.deserializeState(data));
+    EXPECT_EQ(draw(restored, 10), expected);
+}
+
+TEST(RandomGeneratorTest, GeneratorIsATemplateParameter) {
+    NullLogger logger;
+    BasicChip8<CheckedPolicy, DefaultQuirks, Pcg32> first(Chip8::Backend::Threaded, logger);
+    BasicChip8<CheckedPolicy, DefaultQuirks, Pcg32> second(Chip8::Backend::Switch, logger);
+    ASSERT_TRUE(first.loadRom(RANDOM_ROM));
+    ASSERT_TRUE(second.loadRom(RANDOM_ROM));
+    first.setRandomSeed(3);
+    second.setRandomSeed(3);
+    EXPECT_EQ(draw(first, 20), draw(second, 20));
+}
+
+}  // namespace
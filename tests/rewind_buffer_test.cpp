@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../src/chip8.h"
+#include "../src/rewind_buffer.h"
+
+namespace {
+
+// Counts in V0, keeps a BCD of it at 0x300 and draws it
+const std::vector<std::uint8_t> COUNTER_ROM = {
+    0x70, 0x01,  // 0x200: V0 += 1
+    0xA3, 0x00,  // 0x202: I = 0x300
+    0xF0, 0x33,  // 0x204: BCD of V0 at I
+    0xD1, 0x23,  // 0x206: Draw 3 rows at (V1, V2)
+    0x71, 0x05,  // 0x208: V1 += 5
+    0x12, 0x00,  // 0x20A: Jump to 0x200
+};
+
+// A state of a few bytes with one of them changed per push, and every byte
+// changed every 37th push, so deltas vary in size
+std::vector<std::uint8_t> nextState(const std::vector<std::uint8_t>& state, std::size_t step) {
+    std::vector<std::uint8_t> next = state;
+    if (step % 37 == 0) {
+        for (std::uint8_t& byte : next) {
+            byte = static_cast<std::uint8_t>(byte * 7 + 1);
+        }
+    } else {
+        next[step * 13 % next.size()] ^= static_cast<std::uint8_t>(step);
+    }
+    return next;
+}
+
+TEST(RewindBufferTest, StepsBackThroughEveryCapturedFrame) {
+    NullLogger logger;
+    Chip8 emulator(Chip8::Backend::Threaded, logger);
+    ASSERT_TRUE(emulator.loadRom(COUNTER_ROM));
+    RewindBuffer rewind(SnapshotRing::DEFAULT_BUDGET, 8);
+
+    std::vector<std::vector<std::uint8_t>> frames;
+    for (int frame = 0; frame < 50; ++frame) {
+        emulator.runCycles(11);
+        ASSERT_TRUE(rewind.capture(emulator));
+        frames.push_back(emulator.serializeState());
+    }
+    EXPECT_EQ(rewind.size(), frames.size());
+
+    for (std::size_t frame = frames.size() - 1; frame-- > 0;) {
+        ASSERT_TRUE(rewind.rewind(emulator));
+        ASSERT_EQ(emulator.serializeState(), frames[frame]) << frame;
+    }
+    EXPECT_FALSE(rewind.rewind(emulator));
+    EXPECT_EQ(emulator.serializeState(), frames[0]);
+
+    // Recording resumes from the restored frame
+    emulator.runCycles(11);
+    ASSERT_TRUE(rewind.capture(emulator));
+    ASSERT_TRUE(rewind.rewind(emulator));
+    EXPECT_EQ(emulator.serializeState(), frames[0]);
+}
+
+TEST(RewindBufferTest, DeltasCostOnlyWhatChanged) {
+    NullLogger logger;
+    Chip8 emulator(Chip8::Backend::Switch, logger);
+    ASSERT_TRUE(emulator.loadRom(COUNTER_ROM));
+    RewindBuffer rewind;
+    constexpr std::size_t FRAMES = 600;
+    for (std::size_t frame = 0; frame < FRAMES; ++frame) {
+        emulator.runCycles(11);
+        ASSERT_TRUE(rewind.capture(emulator));
+    }
+
+    // A keyframe per 60 frames, and deltas of registers, the BCD and a sprite
+    const std::size_t stateSize = sizeof(Chip8::MachineState);
+    EXPECT_EQ(rewind.size(), FRAMES);
+    EXPECT_LT(rewind.getStoredBytes(), FRAMES / 60 * stateSize + FRAMES * 256);
+    EXPECT_LT(rewind.getStoredBytes(), FRAMES * stateSize / 10);
+}
+
+TEST(RewindBufferTest, BudgetDropsTheOldestFrames) {
+    NullLogger logger;
+    Chip8 emulator(Chip8::Backend::Switch, logger);
+    ASSERT_TRUE(emulator.loadRom(COUNTER_ROM));
+    const std::size_t budget = 8 * sizeof(Chip8::MachineState);
+    RewindBuffer rewind(budget, 10);
+
+    std::vector<std::vector<std::uint8_t>> frames;
+    for (int frame = 0; frame < 500; ++frame) {
+        emulator.runCycles(11);
+        ASSERT_TRUE(rewind.capture(emulator));
+        frames.push_back(emulator.serializeState());
+        ASSERT_LE(rewind.getStoredBytes(), budget);
+    }
+    ASSERT_GT(rewind.size(), 10u);
+    ASSERT_LT(rewind.size(), frames.size());
+
+    // Everything still held is the most recent frames, in order
+    const std::size_t held = rewind.size();
+    for (std::size_t back = 1; back < held; ++back) {
+        ASSERT_TRUE(rewind.rewind(emulator));
+        ASSERT_EQ(emulator.serializeState(), frames[frames.size() - 1 - back]) << back;
+    }
+    EXPECT_FALSE(rewind.rewind(emulator));
+
+    // Too small for a single keyframe
+    RewindBuffer tiny(sizeof(Chip8::MachineState) / 2);
+    EXPECT_FALSE(tiny.capture(emulator));
+    EXPECT_FALSE(tiny.rewind(emulator));
+    EXPECT_EQ(tiny.size(), 0u);
+}
+
+TEST(SnapshotRingTest, WrapsAroundStorageWithMixedSizes) {
+    constexpr std::size_t STATE_SIZE = 200;
+    for (std::uint32_t interval : {1u, 5u, 60u}) {
+        SnapshotRing ring(STATE_SIZE, 4096, interval);
+        std::vector<std::vector<std::uint8_t>> history;
+        std::vector<std::uint8_t> state(STATE_SIZE, 0x5A);
+        std::vector<std::uint8_t> restored(STATE_SIZE);
+
+        for (std::size_t step = 1; step <= 3000; ++step) {
+            state = nextState(state, step);
+            ASSERT_TRUE(ring.push(state.data()));
+            history.push_back(state);
+
+            // Now and then step back a few snapshots and branch from there
+            if (step % 101 == 0) {
+                for (int back = 0; back < 3 && ring.size() > 1; ++back) {
+                    ASSERT_TRUE(ring.stepBack(restored.data()));
+                    history.pop_back();
+                    ASSERT_EQ(restored, history.back()) << interval << " " << step;
+                }
+                state = restored;
+            }
+        }
+
+        ASSERT_LE(ring.getStoredBytes(), ring.getBudget());
+        while (ring.size() > 1) {
+            ASSERT_TRUE(ring.stepBack(restored.data()));
+            history.pop_back();
+            ASSERT_EQ(restored, history.back()) << interval << " " << ring.size();
+        }
+        ring.clear();
+        EXPECT_EQ(ring.size(), 0u);
+        EXPECT_EQ(ring.getStoredBytes(), 0u);
+    }
+}
+
+}  // namespace
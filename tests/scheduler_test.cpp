@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "../src/scheduler.h"
+
+namespace {
+
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+
+// Counts the batches a refresh runs
+class CountingChip8 : public Chip8 {
+public:
+    RunResult runCyclesThroughKeyWaits(std::uint32_t count) {
+        ++calls;
+        return Chip8::runCyclesThroughKeyWaits(count);
+    }
+
+    int calls = 0;
+};
+
+// Loops on FX0A with no key pressed
+void loadKeyWait(CountingChip8& emulator) {
+    ASSERT_TRUE(emulator.loadRom(std::vector<std::uint8_t>{0xF0, 0x0A}));
+}
+
+TEST(CycleSchedulerTest, CarriesCycleFractions) {
+    // 500 Hz is 8.33 cycles per refresh
+    CycleScheduler scheduler(500);
+    std::uint64_t total = 0;
+    for (int frame = 0; frame < 60; ++frame) {
+        const std::uint32_t cycles = scheduler.cycles(CycleScheduler::REFRESH_PERIOD);
+        EXPECT_GE(cycles, 8u);
+        EXPECT_LE(cycles, 9u);
+        total += cycles;
+    }
+    EXPECT_EQ(total, 499u);  // 60 periods are 999999960 ns
+    EXPECT_EQ(scheduler.cycles(nanoseconds(40)), 1u);
+}
+
+TEST(CycleSchedulerTest, CatchesUpAfterLateFrame) {
+    CycleScheduler scheduler(600);
+    EXPECT_EQ(scheduler.cycles(milliseconds(50)), 30u);
+}
+
+TEST(CycleSchedulerTest, LimitsCatchUpAfterStall) {
+    CycleScheduler scheduler(600);
+    const std::uint32_t limit = scheduler.cycles(CycleScheduler::REFRESH_PERIOD *
+                                                 CycleScheduler::MAX_CATCH_UP_FRAMES);
+    CycleScheduler stalled(600);
+    EXPECT_EQ(stalled.cycles(std::chrono::seconds(5)), limit);
+    EXPECT_EQ(stalled.cycles(nanoseconds(-1)), 0u);
+}
+
+TEST(CycleSchedulerTest, UnthrottledOwesNoCycles) {
+    CycleScheduler scheduler(0);
+    EXPECT_EQ(scheduler.cycles(milliseconds(16)), 0u);
+}
+
+TEST(EmulateRefreshTest, KeyWaitEndsUnthrottledRefresh) {
+    CountingChip8 emulator;
+    loadKeyWait(emulator);
+    emulator.setCpuFrequency(0);
+    emulator.setDelayTimer(10);
+    CycleScheduler scheduler(0);
+    std::chrono::steady_clock::time_point previous = std::chrono::steady_clock::now();
+
+    for (int refresh = 1; refresh <= 3; ++refresh) {
+        const RefreshResult result = emulateRefresh(emulator, scheduler, previous);
+        EXPECT_EQ(result.reason, Chip8::StopReason::KeyWait);
+        EXPECT_EQ(emulator.calls, refresh);
+    }
+    EXPECT_EQ(emulator.getProgramCounter(), 0x200);
+    EXPECT_EQ(emulator.getDelayTimer(), 7);  // Ticked once per refresh
+}
+
+TEST(EmulateRefreshTest, KeyWaitUsesThrottledRefreshInOneCall) {
+    CountingChip8 emulator;
+    loadKeyWait(emulator);
+    emulator.setCpuFrequency(600);
+    CycleScheduler scheduler(600);
+    std::chrono::steady_clock::time_point previous =
+        std::chrono::steady_clock::now() - CycleScheduler::REFRESH_PERIOD;
+
+    const RefreshResult result = emulateRefresh(emulator, scheduler, previous);
+    EXPECT_EQ(result.reason, Chip8::StopReason::KeyWait);
+    EXPECT_GE(result.cycles, 10u);
+    EXPECT_EQ(emulator.calls, 1);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x200);
+}
+
+}  // namespace
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../src/chip8.h"
+
+namespace {
+
+// Counts in V0, keeps a BCD of it at 0x300 and draws it, so a run changes
+// memory, registers, timers and the display
+const std::vector<std::uint8_t> COUNTER_ROM = {
+    0x70, 0x01,  // 0x200: V0 += 1
+    0xA3, 0x00,  // 0x202: I = 0x300
+    0xF0, 0x33,  // 0x204: BCD of V0 at I
+    0xF0, 0x15,  // 0x206: Delay timer = V0
+    0xD1, 0x23,  // 0x208: Draw 3 rows at (V1, V2)
+    0x71, 0x05,  // 0x20A: V1 += 5
+    0x12, 0x00,  // 0x20C: Jump to 0x200
+};
+
+TEST(MachineStateTest, LoadStateReplaysTheSameRun) {
+    NullLogger logger;
+    for (Chip8::Backend backend :
+         {Chip8::Backend::Switch, Chip8::Backend::Threaded, Chip8::Backend::TailCall,
+          Chip8::Backend::BlockTranslator}) {
+        Chip8 emulator(backend, logger);
+        ASSERT_TRUE(emulator.loadRom(COUNTER_ROM));
+        emulator.runCycles(1000);
+
+        Chip8::MachineState snapshot;
+        emulator.saveState(snapshot);
+        emulator.runCycles(777);
+        const std::vector<std::uint8_t> expected = emulator.serializeState();
+
+        emulator.loadState(snapshot);
+        EXPECT_EQ(emulator.getDirtyRows(), 0xFFFFFFFFu);  // Every low-resolution row
+        emulator.runCycles(777);
+        EXPECT_EQ(emulator.serializeState(), expected);
+    }
+}
+
+TEST(MachineStateTest, LoadStateRunsTheSnapshotsCode) {
+    NullLogger logger;
+    for (Chip8::Backend backend : {Chip8::Backend::Threaded, Chip8::Backend::BlockTranslator}) {
+        Chip8 emulator(backend, logger);
+        ASSERT_TRUE(emulator.loadRom(COUNTER_ROM));
+        Chip8::MachineState original;
+        emulator.saveState(original);
+        emulator.runCycles(70);  // Decode and translate the loop
+
+        // Rewrite V0 += 1 as V0 += 2, then go back to the original code
+        emulator.setMemory(0x201, 0x02);
+        emulator.runCycles(70);
+        EXPECT_EQ(emulator.getRegisterAt(0), 30);
+        emulator.loadState(original);
+        emulator.runCycles(70);
+        EXPECT_EQ(emulator.getRegisterAt(0), 10);
+
+        // And forward again to a snapshot of the rewritten code
+        emulator.setMemory(0x201, 0x03);
+        Chip8::MachineState rewritten;
+        emulator.saveState(rewritten);
+        emulator.loadState(original);
+        emulator.runCycles(7);
+        emulator.loadState(rewritten);
+        emulator.runCycles(70);
+        EXPECT_EQ(emulator.getRegisterAt(0), 40);
+    }
+}
+
+TEST(MachineStateTest, SerializedStateRoundTrips) {
+    NullLogger logger;
+    Chip8 emulator(Chip8::Backend::Switch, logger);
+    ASSERT_TRUE(emulator.loadRom(COUNTER_ROM));
+    emulator.setKeyState(0xA, true);
+    emulator.runCycles(500);
+    const std::vector<std::uint8_t> data = emulator.serializeState();
+
+    // Tag, version and memory size, little-endian
+    ASSERT_GT(data.size(), 10u);
+    EXPECT_EQ(std::vector<std::uint8_t>(data.begin(), data.begin() + 10),
+              (std::vector<std::uint8_t>{'C', '8', 'S', 'T', Chip8::STATE_VERSION, 0, 0x00, 0x10,
+                                         0, 0}));
+
+    Chip8 restored(Chip8::Backend::Threaded, logger);
+    ASSERT_TRUE(restored.deserializeState(data));
+    EXPECT_EQ(restored.serializeState(), data);
+    EXPECT_TRUE(restored.isKeyPressed(0xA));
+    EXPECT_EQ(restored.getProgramCounter(), emulator.getProgramCounter());
+    EXPECT_EQ(restored.getPixel(0, 0), emulator.getPixel(0, 0));
+    emulator.runCycles(100);
+    restored.runCycles(100);
+    EXPECT_EQ(restored.serializeState(), emulator.serializeState());
+}
+
+TEST(MachineStateTest, RejectsMalformedStates) {
+    NullLogger logger;
+    Chip8 emulator(Chip8::Backend::Switch, logger);
+    ASSERT_TRUE(emulator.loadRom(COUNTER_ROM));
+    const std::vector<std::uint8_t> good = emulator.serializeState();
+    emulator.runCycles(10);
+    const std::vector<std::uint8_t> before = emulator.serializeState();
+
+    std::vector<std::uint8_t> truncated(good.begin(), good.end() - 1);
+    std::vector<std::uint8_t> extended = good;
+    extended.push_back(0);
+    std::vector<std::uint8_t> futureVersion = good;
+    futureVersion[4] = Chip8::STATE_VERSION + 1;
+    std::vector<std::uint8_t> badTag = good;
+    badTag[0] = 'X';
+    std::vector<std::uint8_t> badFlag = good;
+    // The high-resolution flag, ahead of the planes, pitch, timer phase and
+    // generator
+    badFlag[good.size() - 7 - sizeof(Chip8::MachineState::random)] = 2;
+    BasicChip8<CheckedPolicy, XoChipQuirks> xoChip(Chip8::Backend::Switch, logger);
+
+    for (const std::vector<std::uint8_t>& data :
+         {truncated, extended, futureVersion, badTag, badFlag, xoChip.serializeState(),
+          std::vector<std::uint8_t>{}}) {
+        EXPECT_FALSE(emulator.deserializeState(data));
+        EXPECT_EQ(emulator.serializeState(), before);
+    }
+    EXPECT_FALSE(xoChip.deserializeState(good));
+}
+
+TEST(MachineStateTest, ReadsVersionOneStates) {
+    NullLogger logger;
+    Chip8 emulator(Chip8::Backend::Switch, logger);
+    ASSERT_TRUE(emulator.loadRom(COUNTER_ROM));
+    emulator.runCycles(300);
+    const std::vector<std::uint8_t> current = emulator.serializeState();
+
+    // Version 1 ended before the generator
+    std::vector<std::uint8_t> versionOne(current.begin(),
+                                         current.end() - sizeof(Chip8::MachineState::random));
+    versionOne[4] = 1;
+
+    Chip8 restored(Chip8::Backend::Switch, logger);
+    restored.setRandomSeed(5);
+    Chip8::MachineState before;
+    restored.saveState(before);
+    ASSERT_TRUE(restored.deserializeState(versionOne));
+    EXPECT_EQ(restored.getProgramCounter(), emulator.getProgramCounter());
+    EXPECT_EQ(restored.getRegisterAt(0), emulator.getRegisterAt(0));
+
+    // The generator carries on from where it was
+    Chip8::MachineState after;
+    restored.saveState(after);
+    EXPECT_EQ(after.random.state, before.random.state);
+
+    // Version 2 data without the generator is truncated
+    versionOne[4] = 2;
+    EXPECT_FALSE(restored.deserializeState(versionOne));
+}
+
+}  // namespace
@@ -0,0 +1,345 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../src/chip8.h"
+#include "test_helpers.h"
+
+namespace {
+
+using SuperChip = BasicChip8<CheckedPolicy, SuperChipQuirks>;
+// SUPER-CHIP clips sprites at the screen edges; XO-CHIP keeps its
+// instructions and wraps them
+using XoChip = BasicChip8<CheckedPolicy, XoChipQuirks>;
+
+template <typename Emulator>
+class SuperChipFixture : public ::testing::Test {
+  protected:
+    Emulator emulator;
+    NullLogger logger;
+
+    void SetUp() override { emulator.setLogger(logger); }
+
+    void run(const std::vector<std::uint8_t>& program) {
+        loadProgram(emulator, program);
+        for (std::size_t i = 0; i < program.size() / 2; ++i) {
+            emulator.emulateCycle();
+            ASSERT_EQ(emulator.getLastError(), Chip8::ErrorCode::None)
+                << emulator.getLastErrorMessage();
+        }
+    }
+
+    std::size_t litPixels() const {
+        const auto& frameBuffer = emulator.getFrameBuffer();
+        return static_cast<std::size_t>(std::count(frameBuffer.begin(), frameBuffer.end(), 1));
+    }
+};
+
+using SuperChipTest = SuperChipFixture<SuperChip>;
+using SuperChipWrapTest = SuperChipFixture<XoChip>;
+
+TEST_F(SuperChipTest, ResolutionSwitchResizesAndClears) {
+    EXPECT_FALSE(emulator.isHighResolution());
+    EXPECT_EQ(emulator.getDisplayWidth(), Chip8::DISPLAY_WIDTH);
+    EXPECT_EQ(emulator.getDisplayHeight(), Chip8::DISPLAY_HEIGHT);
+
+    emulator.setPixel(3, 3, 1);
+    run({0x00, 0xFF});  // High resolution
+    EXPECT_TRUE(emulator.isHighResolution());
+    EXPECT_EQ(emulator.getDisplayWidth(), Chip8::HIRES_DISPLAY_WIDTH);
+    EXPECT_EQ(emulator.getDisplayHeight(), Chip8::HIRES_DISPLAY_HEIGHT);
+    EXPECT_EQ(litPixels(), 0u);
+    EXPECT_TRUE(emulator.getDrawFlag());
+
+    emulator.setPixel(127, 63, 1);
+    EXPECT_EQ(emulator.getFrameBuffer()[Chip8::FRAME_BUFFER_SIZE - 1], 1);
+    emulator.setProgramCounter(Chip8::ROM_START_ADDRESS);
+    run({0x00, 0xFE});  // Low resolution
+    EXPECT_FALSE(emulator.isHighResolution());
+    EXPECT_EQ(litPixels(), 0u);
+
+    emulator.setPixel(64, 0, 1);
+    EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::InvalidMemoryAccess);
+}
+
+TEST_F(SuperChipWrapTest, DrawsSixteenBySixteenSprites) {
+    // A full 16x16 block at (120, 60) wraps into every corner of the screen
+    for (std::uint16_t i = 0; i < 32; ++i) {
+        emulator.setMemory(0x300 + i, 0xFF);
+    }
+    run({
+        0x00, 0xFF,  // High resolution
+        0x60, 0x78,  // V0 = 120
+        0x61, 0x3C,  // V1 = 60
+        0xA3, 0x00,  // I = 0x300
+        0xD0, 0x10,  // Draw 16x16
+    });
+
+    EXPECT_EQ(litPixels(), 256u);
+    EXPECT_EQ(emulator.getRegisterAt(0xF), 0);
+    for (auto [x, y] : {std::pair{120, 60}, {127, 63}, {0, 0}, {7, 11}, {120, 11}, {7, 60}}) {
+        EXPECT_EQ(emulator.getPixel(x, y), 1) << x << ", " << y;
+    }
+    EXPECT_EQ(emulator.getPixel(8, 12), 0);
+    EXPECT_EQ(emulator.getPixel(119, 59), 0);
+
+    // Drawing it again erases it and reports the collision
+    emulator.setProgramCounter(0x208);
+    emulator.emulateCycle();
+    EXPECT_EQ(litPixels(), 0u);
+    EXPECT_EQ(emulator.getRegisterAt(0xF), 1);
+}
+
+TEST_F(SuperChipTest, DisplayPlanesPackRowsIntoWords) {
+    // Low resolution rows fill word 0 of each pair, most significant bit first
+    emulator.setPixel(0, 0, 1);
+    emulator.setPixel(63, 1, 1);
+    const Chip8::DisplayPlane& plane = emulator.getDisplayPlane(0);
+    EXPECT_EQ(plane[0], std::uint64_t{1} << 63);
+    EXPECT_EQ(plane[1 * Chip8::DISPLAY_ROW_WORDS], 1u);
+    EXPECT_EQ(plane[1], 0u);
+
+    run({0x00, 0xFF});
+    emulator.setPixel(64, 2, 1);
+    emulator.setPixel(127, 2, 1);
+    EXPECT_EQ(plane[2 * Chip8::DISPLAY_ROW_WORDS + 1], std::uint64_t{1} << 63 | 1);
+    EXPECT_EQ(emulator.getDisplayPlane(1)[2 * Chip8::DISPLAY_ROW_WORDS + 1], 0u);
+    EXPECT_EQ(emulator.getFrameBuffer()[2 * Chip8::HIRES_DISPLAY_WIDTH + 64], 1);
+}
+
+TEST_F(SuperChipWrapTest, SpritesStraddleWordsAndWrap) {
+    emulator.setMemory(0x300, 0xFF);
+    run({
+        0x00, 0xFF,  // High resolution
+        0x60, 0x3C,  // V0 = 60
+        0x61, 0x7C,  // V1 = 124
+        0x62, 0x3C,  // V2 = 60
+        0xA3, 0x00,  // I = 0x300
+        0xD0, 0x21,  // Draw 8x1 at (60, 60): columns 60-67
+        0xD1, 0x21,  // Draw 8x1 at (124, 60): columns 124-127 and 0-3
+        0xD0, 0x21,  // Draw 8x1 at (60, 60) again: collides in both words
+    });
+
+    EXPECT_EQ(emulator.getRegisterAt(0xF), 1);
+    EXPECT_EQ(litPixels(), 8u);
+    for (std::uint16_t x : {0, 3, 124, 127}) {
+        EXPECT_EQ(emulator.getPixel(x, 60), 1) << x;
+    }
+    EXPECT_EQ(emulator.getPixel(60, 60), 0);
+    EXPECT_EQ(emulator.getPixel(67, 60), 0);
+}
+
+TEST_F(SuperChipWrapTest, DirtyRowsWrapInHighResolution) {
+    run({0x00, 0xFF});
+    EXPECT_EQ(emulator.getDirtyRows(), ~Chip8::RowMask{0});
+    emulator.acknowledgeDirtyRows();
+
+    loadProgram(emulator, {0x60, 0x3C, 0xD0, 0x00});  // 16x16 at (60, 60)
+    emulator.setProgramCounter(Chip8::ROM_START_ADDRESS);
+    emulator.emulateCycle();
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getDirtyRows(), 0xF000000000000FFFu);
+}
+
+TEST_F(SuperChipTest, SixteenBySixteenSpritePastMemoryFails) {
+    run({
+        0xAF, 0xF0,  // I = 0xFF0: the last row would read past memory
+    });
+    loadProgram(emulator, {0x00, 0xE0, 0xD0, 0x00});
+    emulator.setProgramCounter(0x202);
+    emulator.emulateCycle();
+
+    EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::InvalidMemoryAccess);
+    EXPECT_EQ(emulator.getLastErrorRecord().site, Chip8::ErrorSite::SpriteData);
+    EXPECT_EQ(emulator.getLastErrorRecord().operands[0], Chip8::MEMORY_SIZE);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x202);
+}
+
+TEST_F(SuperChipTest, ScrollsMoveWholeRows) {
+    run({0x00, 0xFF});
+    emulator.setPixel(0, 0, 1);
+    emulator.setPixel(127, 5, 1);
+    emulator.setPixel(64, 60, 1);
+
+    loadProgram(emulator, {0x00, 0xC3});  // Scroll down 3
+    emulator.setProgramCounter(Chip8::ROM_START_ADDRESS);
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getPixel(0, 3), 1);
+    EXPECT_EQ(emulator.getPixel(127, 8), 1);
+    EXPECT_EQ(emulator.getPixel(64, 63), 1);
+    EXPECT_EQ(litPixels(), 3u);
+
+    // The pixel at the right edge falls off instead of wrapping to the next row
+    loadProgram(emulator, {0x00, 0xFB});  // Scroll right 4
+    emulator.setProgramCounter(Chip8::ROM_START_ADDRESS);
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getPixel(4, 3), 1);
+    EXPECT_EQ(emulator.getPixel(68, 63), 1);
+    EXPECT_EQ(emulator.getPixel(3, 9), 0);
+    EXPECT_EQ(litPixels(), 2u);
+
+    loadProgram(emulator, {0x00, 0xFC, 0x00, 0xFC});  // Scroll left 8
+    emulator.setProgramCounter(Chip8::ROM_START_ADDRESS);
+    emulator.emulateCycle();
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getPixel(60, 63), 1);
+    EXPECT_EQ(emulator.getPixel(124, 2), 0);
+    EXPECT_EQ(litPixels(), 1u);
+    EXPECT_TRUE(emulator.getDrawFlag());
+}
+
+TEST_F(SuperChipTest, ScrollsUseLowResolutionRows) {
+    emulator.setPixel(63, 31, 1);
+    emulator.setPixel(10, 0, 1);
+    run({
+        0x00, 0xC1,  // Scroll down 1: the bottom row falls off
+        0x00, 0xFC,  // Scroll left 4
+    });
+
+    EXPECT_EQ(emulator.getPixel(6, 1), 1);
+    EXPECT_EQ(litPixels(), 1u);
+    EXPECT_EQ(emulator.getFrameBuffer()[1 * Chip8::DISPLAY_WIDTH + 6], 1);
+}
+
+TEST_F(SuperChipTest, BigFontDigits) {
+    run({
+        0x63, 0x07,  // V3 = 7
+        0xF3, 0x30,  // I = big 7
+    });
+
+    const std::uint16_t sprite = Chip8::BIG_FONT_ADDRESS + 7 * 10;
+    EXPECT_EQ(emulator.getIndexRegister(), sprite);
+    EXPECT_EQ(emulator.getMemoryAt(sprite), 0xFF);
+    EXPECT_EQ(emulator.getMemoryAt(sprite + 9), 0x60);
+
+    loadProgram(emulator, {0x63, 0x10, 0xF3, 0x30});
+    emulator.setProgramCounter(Chip8::ROM_START_ADDRESS);
+    emulator.emulateCycle();
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getLastErrorRecord().site, Chip8::ErrorSite::SpriteDigit);
+}
+
+TEST_F(SuperChipTest, FlagRegistersSurviveReset) {
+    run({
+        0x60, 0x11,  // V0 = 0x11
+        0x61, 0x22,  // V1 = 0x22
+        0x62, 0x33,  // V2 = 0x33
+        0xF2, 0x75,  // Save V0-V2
+    });
+
+    emulator.init();
+    run({0xF1, 0x85});  // Load V0-V1
+    EXPECT_EQ(emulator.getRegisterAt(0), 0x11);
+    EXPECT_EQ(emulator.getRegisterAt(1), 0x22);
+    EXPECT_EQ(emulator.getRegisterAt(2), 0x00);
+}
+
+TEST_F(SuperChipTest, ExitHaltsInPlace) {
+    loadProgram(emulator, {0x00, 0xFD});
+    emulator.setDelayTimer(5);
+
+    const Chip8::RunResult result = emulator.runCycles(1000);
+    EXPECT_EQ(result.reason, Chip8::StopReason::CycleLimit);
+    EXPECT_EQ(result.cycles, 1000u);
+    EXPECT_EQ(emulator.getProgramCounter(), Chip8::ROM_START_ADDRESS);
+    EXPECT_EQ(emulator.getDelayTimer(), 0);
+}
+
+template <typename Emulator>
+void expectSuperChipOpcodesRejected() {
+    NullLogger logger;
+    for (std::uint16_t opcode : {0x00FF, 0x00FB, 0x00FC, 0x00FD, 0xF130, 0xF275, 0xF285}) {
+        Emulator emulator(Chip8::Backend::Switch, logger);
+        loadProgram(emulator, {static_cast<std::uint8_t>(opcode >> 8),
+                               static_cast<std::uint8_t>(opcode & 0xFF)});
+        emulator.emulateCycle();
+
+        SCOPED_TRACE(testing::Message() << std::hex << opcode);
+        EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::UnknownOpcode);
+        EXPECT_FALSE(emulator.isHighResolution());
+    }
+
+    // DXY0 draws no rows, as on the original interpreter
+    Emulator emulator(Chip8::Backend::Switch, logger);
+    loadProgram(emulator, {0xA0, 0x00, 0xD0, 0x00});  // I = font, draw DXY0 at (0, 0)
+    emulator.setRegisterAt(0xF, 1);
+    emulator.emulateCycle();
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::None);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x204);
+    EXPECT_EQ(emulator.getRegisterAt(0xF), 0);
+    const auto& frameBuffer = emulator.getFrameBuffer();
+    EXPECT_EQ(std::count(frameBuffer.begin(), frameBuffer.end(), 1), 0);
+}
+
+TEST(SuperChipProfileTest, ClassicProfilesRejectSuperChipOpcodes) {
+    expectSuperChipOpcodesRejected<Chip8>();
+    expectSuperChipOpcodesRejected<BasicChip8<CheckedPolicy, Chip8Quirks>>();
+}
+
+// Scrolls and 16x16 draws in both resolutions, inside a loop with an exit
+const std::vector<std::uint8_t> SUPER_CHIP_PROGRAM = {
+    0x00, 0xFF,  // 0x200: High resolution
+    0x60, 0x00,  // 0x202: V0 = 0
+    0x61, 0x3A,  // 0x204: V1 = 58
+    0x62, 0x00,  // 0x206: V2 = 0
+    0xA2, 0x40,  // 0x208: I = sprite
+    0xD0, 0x10,  // 0x20A: Draw 16x16 at (V0, V1)
+    0x00, 0xC2,  // 0x20C: Scroll down 2
+    0x00, 0xFB,  // 0x20E: Scroll right 4
+    0x70, 0x1D,  // 0x210: V0 += 29
+    0xF2, 0x30,  // 0x212: I = big digit V2
+    0xD0, 0x1A,  // 0x214: Draw 8x10
+    0x00, 0xFC,  // 0x216: Scroll left 4
+    0x72, 0x01,  // 0x218: V2 += 1
+    0x32, 0x0A,  // 0x21A: Skip if V2 == 10
+    0x12, 0x08,  // 0x21C: Jump to 0x208
+    0xF2, 0x75,  // 0x21E: Save V0-V2 to the flags
+    0x00, 0xFE,  // 0x220: Low resolution
+    0xA2, 0x40,  // 0x222: I = sprite
+    0xD0, 0x10,  // 0x224: Draw 16x16 at (V0, V1)
+    0x00, 0xC1,  // 0x226: Scroll down 1
+    0xF2, 0x85,  // 0x228: Load V0-V2 from the flags
+    0x00, 0xFD,  // 0x22A: Exit
+    0x00, 0x00,  // 0x22C: Padding
+    0x00, 0x00,  // 0x22E
+    0x00, 0x00,  // 0x230
+    0x00, 0x00,  // 0x232
+    0x00, 0x00,  // 0x234
+    0x00, 0x00,  // 0x236
+    0x00, 0x00,  // 0x238
+    0x00, 0x00,  // 0x23A
+    0x00, 0x00,  // 0x23C
+    0x00, 0x00,  // 0x23E
+    0x81, 0x81, 0x42, 0x42, 0x24, 0x24, 0x18, 0x18,  // 0x240: Sprite
+    0x18, 0x18, 0x24, 0x24, 0x42, 0x42, 0x81, 0x81,
+    0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F,
+    0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0,
+};
+
+TEST(SuperChipBackendTest, BackendsMatchSingleStepping) {
+    NullLogger logger;
+    for (Chip8::Backend backend : {Chip8::Backend::Switch, Chip8::Backend::Threaded,
+                                   Chip8::Backend::TailCall, Chip8::Backend::BlockTranslator}) {
+        for (std::uint32_t cycles : {7u, 40u, 123u, 500u}) {
+            SuperChip reference(Chip8::Backend::Switch, logger);
+            SuperChip emulator(backend, logger);
+            loadProgram(reference, SUPER_CHIP_PROGRAM);
+            loadProgram(emulator, SUPER_CHIP_PROGRAM);
+
+            for (std::uint32_t i = 0; i < cycles; ++i) {
+                reference.emulateCycle();
+            }
+            const Chip8::RunResult result = emulator.runCycles(cycles);
+
+            SCOPED_TRACE(testing::Message() << "backend " << static_cast<int>(backend) << ", "
+                                            << cycles << " cycles");
+            EXPECT_EQ(result.cycles, cycles);
+            expectSameState(reference, emulator);
+        }
+    }
+}
+
+}  // namespace
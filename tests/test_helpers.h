@@ -0,0 +1,46 @@
+#ifndef CHIP8_TEST_HELPERS_H
+#define CHIP8_TEST_HELPERS_H
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../src/chip8.h"
+
+// Writes a program into memory, at the ROM start unless told otherwise
+template <typename Emulator>
+void loadProgram(Emulator& emulator, const std::vector<std::uint8_t>& program,
+                 std::uint16_t address = Chip8Base::ROM_START_ADDRESS) {
+    for (std::size_t i = 0; i < program.size(); ++i) {
+        emulator.setMemory(static_cast<std::uint16_t>(address + i), program[i]);
+    }
+}
+
+// Compares the machine state two emulators expose. They may differ in
+// policy, but not in memory size.
+template <typename Expected, typename Actual>
+void expectSameState(const Expected& expected, const Actual& actual) {
+    static_assert(Expected::MEMORY_SIZE == Actual::MEMORY_SIZE, "memory sizes differ");
+    EXPECT_EQ(expected.getProgramCounter(), actual.getProgramCounter());
+    EXPECT_EQ(expected.getIndexRegister(), actual.getIndexRegister());
+    EXPECT_EQ(expected.getStackPointer(), actual.getStackPointer());
+    EXPECT_EQ(expected.getDelayTimer(), actual.getDelayTimer());
+    EXPECT_EQ(expected.getSoundTimer(), actual.getSoundTimer());
+    EXPECT_EQ(expected.getDrawFlag(), actual.getDrawFlag());
+    EXPECT_EQ(expected.getLastError(), actual.getLastError());
+    EXPECT_EQ(expected.isHighResolution(), actual.isHighResolution());
+    for (std::uint8_t i = 0; i < Chip8Base::REGISTER_COUNT; ++i) {
+        EXPECT_EQ(expected.getRegisterAt(i), actual.getRegisterAt(i)) << "V" << int(i);
+    }
+    for (std::uint8_t i = 0; i < Chip8Base::STACK_SIZE; ++i) {
+        EXPECT_EQ(expected.getStackAt(i), actual.getStackAt(i)) << "stack " << int(i);
+    }
+    for (std::uint32_t i = 0; i < Expected::MEMORY_SIZE; ++i) {
+        const auto address = static_cast<std::uint16_t>(i);
+        ASSERT_EQ(expected.getMemoryAt(address), actual.getMemoryAt(address)) << "memory " << i;
+    }
+    EXPECT_EQ(expected.getFrameBuffer(), actual.getFrameBuffer());
+}
+
+#endif
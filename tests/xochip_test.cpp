@@ -0,0 +1,264 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "../src/chip8.h"
+#include "test_helpers.h"
+
+namespace {
+
+using XoChip = BasicChip8<CheckedPolicy, XoChipQuirks>;
+using TrustedXoChip = BasicChip8<TrustedPolicy, XoChipQuirks>;
+
+class XoChipTest : public ::testing::Test {
+  protected:
+    XoChip emulator;
+    NullLogger logger;
+
+    void SetUp() override { emulator.setLogger(logger); }
+
+    void step(std::uint32_t cycles) {
+        for (std::uint32_t i = 0; i < cycles; ++i) {
+            emulator.emulateCycle();
+            ASSERT_EQ(emulator.getLastError(), Chip8::ErrorCode::None)
+                << emulator.getLastErrorMessage();
+        }
+    }
+};
+
+TEST_F(XoChipTest, AddressesSixtyFourKilobytes) {
+    EXPECT_EQ(Chip8::MEMORY_SIZE, 4096u);
+    EXPECT_EQ(XoChip::MEMORY_SIZE, 0x10000u);
+
+    emulator.setMemory(0xFFFF, 0xAB);
+    EXPECT_EQ(emulator.getLastError(), Chip8::ErrorCode::None);
+    EXPECT_EQ(emulator.getMemoryAt(0xFFFF), 0xAB);
+
+    // Code runs above the classic address space
+    loadProgram(emulator, {0x60, 0x42}, 0x1234);
+    emulator.setProgramCounter(0x1234);
+    step(1);
+    EXPECT_EQ(emulator.getRegisterAt(0), 0x42);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x1236);
+}
+
+TEST_F(XoChipTest, LoadsRomsLargerThanClassicMemory) {
+    const std::vector<std::uint8_t> rom(8192, 0x12);
+    {
+        std::ofstream file("xochip_large.xo8", std::ios::binary);
+        file.write(reinterpret_cast<const char*>(rom.data()), rom.size());
+    }
+
+    EXPECT_TRUE(emulator.loadRom("xochip_large.xo8"));
+    EXPECT_EQ(emulator.getMemoryAt(Chip8::ROM_START_ADDRESS + 8191), 0x12);
+
+    Chip8 classic(Chip8::Backend::Switch, logger);
+    EXPECT_FALSE(classic.loadRom("xochip_large.xo8"));
+    std::remove("xochip_large.xo8");
+}
+
+TEST_F(XoChipTest, LongIndexLoad) {
+    loadProgram(emulator, {0xF0, 0x00, 0xBE, 0xEF, 0x60, 0x01});
+    step(2);
+    EXPECT_EQ(emulator.getIndexRegister(), 0xBEEF);
+    EXPECT_EQ(emulator.getRegisterAt(0), 0x01);
+
+    // Rewriting the address word takes effect on the next run
+    emulator.setMemory(0x203, 0x00);
+    emulator.setProgramCounter(Chip8::ROM_START_ADDRESS);
+    step(1);
+    EXPECT_EQ(emulator.getIndexRegister(), 0xBE00);
+}
+
+TEST_F(XoChipTest, SkipsStepOverLongIndexLoad) {
+    loadProgram(emulator, {
+                              0x60, 0x05,              // V0 = 5
+                              0x30, 0x05,              // Skip if V0 == 5
+                              0xF0, 0x00, 0x12, 0x34,  // I = 0x1234
+                              0x61, 0x01,              // V1 = 1
+                          });
+    step(3);
+    EXPECT_EQ(emulator.getIndexRegister(), 0);
+    EXPECT_EQ(emulator.getRegisterAt(1), 1);
+    EXPECT_EQ(emulator.getProgramCounter(), 0x20A);
+}
+
+TEST_F(XoChipTest, SavesAndLoadsRegisterRanges) {
+    loadProgram(emulator, {
+                              0x61, 0x11,  // V1 = 0x11
+                              0x62, 0x22,  // V2 = 0x22
+                              0x63, 0x33,  // V3 = 0x33
+                              0xA3, 0x00,  // I = 0x300
+                              0x51, 0x32,  // Save V1-V3
+                              0xA3, 0x10,  // I = 0x310
+                              0x53, 0x12,  // Save V3-V1
+                              0x57, 0x53,  // Load V7-V5 from 0x310
+                          });
+    step(8);
+    EXPECT_EQ(emulator.getMemoryAt(0x300), 0x11);
+    EXPECT_EQ(emulator.getMemoryAt(0x301), 0x22);
+    EXPECT_EQ(emulator.getMemoryAt(0x302), 0x33);
+    EXPECT_EQ(emulator.getMemoryAt(0x310), 0x33);
+    EXPECT_EQ(emulator.getMemoryAt(0x312), 0x11);
+    EXPECT_EQ(emulator.getRegisterAt(7), 0x33);
+    EXPECT_EQ(emulator.getRegisterAt(6), 0x22);
+    EXPECT_EQ(emulator.getRegisterAt(5), 0x11);
+    EXPECT_EQ(emulator.getIndexRegister(), 0x310);
+}
+
+TEST_F(XoChipTest, ClassicProfilesKeepClassicOpcodes) {
+    Chip8 classic(Chip8::Backend::Switch, logger);
+    loadProgram(classic, {0x51, 0x32, 0x00, 0x00, 0xF0, 0x00});
+    classic.setRegisterAt(1, 7);
+    classic.setRegisterAt(3, 7);
+    classic.emulateCycle();  // 5XY2 is 5XY0 outside XO-CHIP
+    EXPECT_EQ(classic.getProgramCounter(), 0x204);
+    classic.emulateCycle();
+    EXPECT_EQ(classic.getLastError(), Chip8::ErrorCode::UnknownOpcode);
+}
+
+TEST_F(XoChipTest, DrawsBothPlanesInOnePass) {
+    loadProgram(emulator, {0xF0, 0x3C}, 0x300);  // Plane 1 row, then plane 2 row
+    loadProgram(emulator, {
+                              0xF3, 0x01,  // Select both planes
+                              0xA3, 0x00,  // I = 0x300
+                              0xD0, 0x01,  // Draw one row at (0, 0)
+                          });
+    step(3);
+    EXPECT_EQ(emulator.getSelectedPlanes(), Chip8::ALL_PLANES);
+    const std::uint8_t expected[] = {1, 1, 3, 3, 2, 2, 0, 0};
+    for (std::uint16_t x = 0; x < 8; ++x) {
+        EXPECT_EQ(emulator.getPixel(x, 0), expected[x]) << x;
+    }
+    EXPECT_EQ(emulator.getRegisterAt(0xF), 0);
+
+    // Plane 2 alone takes the first image
+    loadProgram(emulator, {0xF2, 0x01, 0xD0, 0x01});
+    emulator.setProgramCounter(Chip8::ROM_START_ADDRESS);
+    step(2);
+    const std::uint8_t secondPlane[] = {3, 3, 1, 1, 2, 2, 0, 0};
+    for (std::uint16_t x = 0; x < 8; ++x) {
+        EXPECT_EQ(emulator.getPixel(x, 0), secondPlane[x]) << x;
+    }
+    EXPECT_EQ(emulator.getRegisterAt(0xF), 1);
+}
+
+TEST_F(XoChipTest, ClearAndScrollOnlyTouchSelectedPlanes) {
+    emulator.setPixel(0, 1, 3);
+    emulator.setPixel(5, 5, 1);
+    loadProgram(emulator, {
+                              0xF2, 0x01,  // Select plane 2
+                              0x00, 0xD1,  // Scroll up 1
+                              0xF1, 0x01,  // Select plane 1
+                              0x00, 0xE0,  // Clear
+                          });
+    step(2);
+    EXPECT_EQ(emulator.getPixel(0, 0), 2);
+    EXPECT_EQ(emulator.getPixel(0, 1), 1);
+    EXPECT_EQ(emulator.getPixel(5, 5), 1);
+    step(2);
+    EXPECT_EQ(emulator.getPixel(0, 0), 2);
+    EXPECT_EQ(emulator.getPixel(0, 1), 0);
+    EXPECT_EQ(emulator.getPixel(5, 5), 0);
+}
+
+TEST_F(XoChipTest, ScrollsUp) {
+    emulator.setPixel(3, 0, 1);
+    emulator.setPixel(3, 31, 1);
+    loadProgram(emulator, {0xF3, 0x01, 0x00, 0xD4});
+    step(2);
+    EXPECT_EQ(emulator.getPixel(3, 27), 1);
+    EXPECT_EQ(emulator.getPixel(3, 31), 0);
+    EXPECT_EQ(emulator.getPixel(3, 0), 0);
+}
+
+TEST_F(XoChipTest, AudioPatternAndPitch) {
+    EXPECT_EQ(emulator.getAudioPitch(), Chip8::DEFAULT_AUDIO_PITCH);
+    EXPECT_DOUBLE_EQ(emulator.getAudioSampleRate(), 4000.0);
+
+    std::vector<std::uint8_t> pattern(Chip8::AUDIO_PATTERN_SIZE);
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        pattern[i] = static_cast<std::uint8_t>(0xA0 + i);
+    }
+    loadProgram(emulator, pattern, 0x400);
+    loadProgram(emulator, {
+                              0xA4, 0x00,  // I = 0x400
+                              0xF0, 0x02,  // Load the pattern
+                              0x65, 0x70,  // V5 = 112
+                              0xF5, 0x3A,  // Pitch = V5
+                          });
+    step(4);
+    EXPECT_TRUE(std::equal(pattern.begin(), pattern.end(), emulator.getAudioPattern().begin()));
+    EXPECT_EQ(emulator.getAudioPitch(), 112);
+    EXPECT_DOUBLE_EQ(emulator.getAudioSampleRate(), 8000.0);
+
+    emulator.setIndexRegister(0xFFF8);
+    emulator.setProgramCounter(0x202);
+    emulator.emulateCycle();
+    EXPECT_EQ(emulator.getLastErrorRecord().site, Chip8::ErrorSite::AudioPattern);
+}
+
+// Draws both planes, scrolls single planes, rewrites its own long loads and
+// skips over them, then idles
+const std::vector<std::uint8_t> XO_CHIP_PROGRAM = {
+    0xF3, 0x01,              // 0x200: Select both planes
+    0x60, 0x00,              // 0x202: V0 = 0
+    0x61, 0x00,              // 0x204: V1 = 0
+    0xF0, 0x00, 0x12, 0x60,  // 0x206: I = 0x1260
+    0xD0, 0x14,              // 0x20A: Draw 4 rows at (V0, V1)
+    0xF2, 0x01,              // 0x20C: Select plane 2
+    0x00, 0xD1,              // 0x20E: Scroll up 1
+    0xF3, 0x01,              // 0x210: Select both planes
+    0x70, 0x09,              // 0x212: V0 += 9
+    0x71, 0x03,              // 0x214: V1 += 3
+    0xA2, 0x08,              // 0x216: I = 0x208
+    0x50, 0x12,              // 0x218: Save V0-V1 over the long load's address
+    0x30, 0x36,              // 0x21A: Skip if V0 == 54
+    0xF0, 0x00, 0x02, 0x06,  // 0x21C: I = 0x206 (skipped on the last pass)
+    0x30, 0x36,              // 0x220: Skip if V0 == 54
+    0x12, 0x06,              // 0x222: Jump to 0x206
+    0x52, 0x53,              // 0x224: Load V2-V5 from I
+    0x12, 0x26,              // 0x226: Jump to self
+};
+
+template <typename Emulator>
+void expectBackendsMatch() {
+    NullLogger logger;
+    for (Chip8::Backend backend : {Chip8::Backend::Switch, Chip8::Backend::Threaded,
+                                   Chip8::Backend::TailCall, Chip8::Backend::BlockTranslator}) {
+        for (std::uint32_t cycles : {5u, 33u, 87u, 400u}) {
+            Emulator reference(Chip8::Backend::Switch, logger);
+            Emulator emulator(backend, logger);
+            for (Emulator* e : {&reference, &emulator}) {
+                loadProgram(*e, XO_CHIP_PROGRAM);
+                // Sprite data wherever the rewritten long loads point
+                for (std::uint32_t address = 0x300; address < XoChip::MEMORY_SIZE; ++address) {
+                    e->setMemory(static_cast<std::uint16_t>(address),
+                                 static_cast<std::uint8_t>(address * 37 >> 3));
+                }
+            }
+
+            for (std::uint32_t i = 0; i < cycles; ++i) {
+                reference.emulateCycle();
+            }
+            const Chip8::RunResult result = emulator.runCycles(cycles);
+
+            SCOPED_TRACE(testing::Message() << "backend " << static_cast<int>(backend) << ", "
+                                            << cycles << " cycles");
+            EXPECT_EQ(result.cycles, cycles);
+            expectSameState(reference, emulator);
+        }
+    }
+}
+
+TEST(XoChipBackendTest, BackendsMatchSingleStepping) { expectBackendsMatch<XoChip>(); }
+
+TEST(XoChipBackendTest, TrustedBackendsMatchSingleStepping) {
+    expectBackendsMatch<TrustedXoChip>();
+}
+
+}  // namespace